@@ -0,0 +1,57 @@
+//
+// CastKeepingBits microbenchmarks. The cast should compile down to nothing, so these should
+// run at memory bandwidth; anything slower is a regression.
+//
+
+#include <cstdint>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "CastKeepingBits.hpp"
+
+namespace
+{
+	constexpr size_t SAMPLES = 65536;
+
+	template<typename ToType, typename FromType>
+	void BM_CastKeepingBits(benchmark::State& state)
+	{
+		std::vector<FromType> in(SAMPLES);
+		for (size_t i = 0; i < SAMPLES; ++i)
+			in[i] = static_cast<FromType>(i * 2654435761u);
+
+		std::vector<ToType> out(SAMPLES);
+		for (auto _ : state)
+		{
+			for (size_t i = 0; i < SAMPLES; ++i)
+				out[i] = CastKeepingBits<ToType>(in[i]);
+			benchmark::DoNotOptimize(out.data());
+			benchmark::ClobberMemory();
+		}
+		state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * SAMPLES);
+		state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * SAMPLES * sizeof(FromType));
+	}
+	BENCHMARK_TEMPLATE(BM_CastKeepingBits, uint32_t, int32_t);
+	BENCHMARK_TEMPLATE(BM_CastKeepingBits, int32_t, uint32_t);
+	BENCHMARK_TEMPLATE(BM_CastKeepingBits, uint64_t, int64_t);
+	BENCHMARK_TEMPLATE(BM_CastKeepingBits, uint32_t, float);
+
+	template<typename ToType, typename FromType>
+	void BM_CastKeepingBitsBulk(benchmark::State& state)
+	{
+		std::vector<FromType> in(SAMPLES);
+		for (size_t i = 0; i < SAMPLES; ++i)
+			in[i] = static_cast<FromType>(i * 2654435761u);
+
+		std::vector<ToType> out(SAMPLES);
+		for (auto _ : state)
+		{
+			CastKeepingBitsBulk(in.data(), out.data(), SAMPLES);
+			benchmark::DoNotOptimize(out.data());
+			benchmark::ClobberMemory();
+		}
+		state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * SAMPLES);
+		state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * SAMPLES * sizeof(FromType));
+	}
+	BENCHMARK_TEMPLATE(BM_CastKeepingBitsBulk, uint32_t, int32_t);
+	BENCHMARK_TEMPLATE(BM_CastKeepingBitsBulk, uint32_t, float);
+}
@@ -0,0 +1,588 @@
+//
+// rapidjson_utils microbenchmarks: member extraction at different object sizes, whole-file
+// parsing, and numeric-or-string extraction. Every benchmark reports items/s and MB/s.
+//
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "rapidjson_utils.hpp"
+
+namespace
+{
+	// {"member_0": <value>, "member_1": <value>, ...}
+	template<typename DataType>
+	void BuildObject(rapidjson::Document& document, size_t member_count, std::vector<std::string>& out_names)
+	{
+		document.SetObject();
+		auto& allocator = document.GetAllocator();
+		out_names.clear();
+		for (size_t i = 0; i < member_count; ++i)
+		{
+			out_names.push_back("member_" + std::to_string(i));
+			rapidjson::Value name(out_names.back().c_str(), allocator);
+			rapidjson::Value value;
+			if constexpr (std::is_same<DataType, std::string>::value || std::is_same<DataType, std::string_view>::value)
+				value.SetString(out_names.back().c_str(), allocator);
+			else if constexpr (std::is_floating_point<DataType>::value)
+				value.SetDouble(static_cast<double>(i) + 0.5);
+			else
+				value.SetInt64(static_cast<int64_t>(i));
+			document.AddMember(name, value, allocator);
+		}
+	}
+
+	//-----------------------------------------------------------------------------------------
+	// Extract<T>: look up every member of an N-member object once per iteration
+	//-----------------------------------------------------------------------------------------
+	template<typename DataType>
+	void BM_Extract(benchmark::State& state)
+	{
+		const size_t member_count = static_cast<size_t>(state.range(0));
+		rapidjson::Document document;
+		std::vector<std::string> names;
+		BuildObject<DataType>(document, member_count, names);
+
+		size_t name_bytes = 0;
+		for (const auto& name : names)
+			name_bytes += name.size();
+
+		for (auto _ : state)
+		{
+			for (const auto& name : names)
+				benchmark::DoNotOptimize(rjutils::Extract<DataType>(document, name.c_str(), DataType()));
+		}
+		state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(member_count));
+		state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(name_bytes));
+	}
+	BENCHMARK_TEMPLATE(BM_Extract, int32_t)->Arg(8)->Arg(64)->Arg(512);
+	BENCHMARK_TEMPLATE(BM_Extract, int64_t)->Arg(8)->Arg(64)->Arg(512);
+	BENCHMARK_TEMPLATE(BM_Extract, double)->Arg(8)->Arg(64)->Arg(512);
+	BENCHMARK_TEMPLATE(BM_Extract, std::string)->Arg(8)->Arg(64)->Arg(512);
+	BENCHMARK_TEMPLATE(BM_Extract, std::string_view)->Arg(8)->Arg(64)->Arg(512);
+
+	// Same lookups with prebuilt GenericStringRef keys (no strlen per call)
+	template<typename DataType>
+	void BM_ExtractStringRefKey(benchmark::State& state)
+	{
+		const size_t member_count = static_cast<size_t>(state.range(0));
+		rapidjson::Document document;
+		std::vector<std::string> names;
+		BuildObject<DataType>(document, member_count, names);
+
+		size_t name_bytes = 0;
+		std::vector<rapidjson::GenericStringRef<char>> keys;
+		for (const auto& name : names)
+		{
+			keys.push_back(rapidjson::StringRef(name.c_str(), name.size()));
+			name_bytes += name.size();
+		}
+
+		for (auto _ : state)
+		{
+			for (const auto& key : keys)
+				benchmark::DoNotOptimize(rjutils::Extract<DataType>(document, key, DataType()));
+		}
+		state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(member_count));
+		state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(name_bytes));
+	}
+	BENCHMARK_TEMPLATE(BM_ExtractStringRefKey, int64_t)->Arg(8)->Arg(64)->Arg(512);
+
+	// Same lookups through a hashed IndexedObject (index built once, outside the timed loop)
+	template<typename DataType>
+	void BM_ExtractIndexed(benchmark::State& state)
+	{
+		const size_t member_count = static_cast<size_t>(state.range(0));
+		rapidjson::Document document;
+		std::vector<std::string> names;
+		BuildObject<DataType>(document, member_count, names);
+		const rjutils::IndexedObject index(document);
+
+		size_t name_bytes = 0;
+		for (const auto& name : names)
+			name_bytes += name.size();
+
+		for (auto _ : state)
+		{
+			for (const auto& name : names)
+				benchmark::DoNotOptimize(rjutils::Extract<DataType>(index, name.c_str(), DataType()));
+		}
+		state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(member_count));
+		state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(name_bytes));
+	}
+	BENCHMARK_TEMPLATE(BM_ExtractIndexed, int64_t)->Arg(8)->Arg(64)->Arg(512);
+
+	// Cost of building the index
+	void BM_IndexedObjectBuild(benchmark::State& state)
+	{
+		const size_t member_count = static_cast<size_t>(state.range(0));
+		rapidjson::Document document;
+		std::vector<std::string> names;
+		BuildObject<int64_t>(document, member_count, names);
+
+		for (auto _ : state)
+		{
+			const rjutils::IndexedObject index(document);
+			benchmark::DoNotOptimize(&index);
+		}
+		state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(member_count));
+	}
+	BENCHMARK(BM_IndexedObjectBuild)->Arg(64)->Arg(512);
+
+	//-----------------------------------------------------------------------------------------
+	// ExtractStruct: 16 bound fields spread over a 64-member object, vs. 16 Extract calls
+	//-----------------------------------------------------------------------------------------
+	struct SixteenFields
+	{
+		int64_t member_0 = 0;
+		int64_t member_4 = 0;
+		int64_t member_8 = 0;
+		int64_t member_12 = 0;
+		int64_t member_16 = 0;
+		int64_t member_20 = 0;
+		int64_t member_24 = 0;
+		int64_t member_28 = 0;
+		int64_t member_32 = 0;
+		int64_t member_36 = 0;
+		int64_t member_40 = 0;
+		int64_t member_44 = 0;
+		int64_t member_48 = 0;
+		int64_t member_52 = 0;
+		int64_t member_56 = 0;
+		int64_t member_60 = 0;
+	};
+
+	RJUTILS_BIND(SixteenFields,
+		RJUTILS_FIELD(member_0, "member_0"),
+		RJUTILS_FIELD(member_4, "member_4"),
+		RJUTILS_FIELD(member_8, "member_8"),
+		RJUTILS_FIELD(member_12, "member_12"),
+		RJUTILS_FIELD(member_16, "member_16"),
+		RJUTILS_FIELD(member_20, "member_20"),
+		RJUTILS_FIELD(member_24, "member_24"),
+		RJUTILS_FIELD(member_28, "member_28"),
+		RJUTILS_FIELD(member_32, "member_32"),
+		RJUTILS_FIELD(member_36, "member_36"),
+		RJUTILS_FIELD(member_40, "member_40"),
+		RJUTILS_FIELD(member_44, "member_44"),
+		RJUTILS_FIELD(member_48, "member_48"),
+		RJUTILS_FIELD(member_52, "member_52"),
+		RJUTILS_FIELD(member_56, "member_56"),
+		RJUTILS_FIELD(member_60, "member_60"))
+
+	void BM_ExtractStruct(benchmark::State& state)
+	{
+		rapidjson::Document document;
+		std::vector<std::string> names;
+		BuildObject<int64_t>(document, 64, names);
+
+		for (auto _ : state)
+		{
+			SixteenFields fields;
+			rjutils::ExtractStruct(document, fields);
+			benchmark::DoNotOptimize(fields);
+		}
+		state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * 16);
+	}
+	BENCHMARK(BM_ExtractStruct);
+
+	void BM_ExtractStructPerField(benchmark::State& state)
+	{
+		rapidjson::Document document;
+		std::vector<std::string> names;
+		BuildObject<int64_t>(document, 64, names);
+
+		for (auto _ : state)
+		{
+			SixteenFields fields;
+			fields.member_0 = rjutils::Extract<int64_t>(document, "member_0", 0);
+			fields.member_4 = rjutils::Extract<int64_t>(document, "member_4", 0);
+			fields.member_8 = rjutils::Extract<int64_t>(document, "member_8", 0);
+			fields.member_12 = rjutils::Extract<int64_t>(document, "member_12", 0);
+			fields.member_16 = rjutils::Extract<int64_t>(document, "member_16", 0);
+			fields.member_20 = rjutils::Extract<int64_t>(document, "member_20", 0);
+			fields.member_24 = rjutils::Extract<int64_t>(document, "member_24", 0);
+			fields.member_28 = rjutils::Extract<int64_t>(document, "member_28", 0);
+			fields.member_32 = rjutils::Extract<int64_t>(document, "member_32", 0);
+			fields.member_36 = rjutils::Extract<int64_t>(document, "member_36", 0);
+			fields.member_40 = rjutils::Extract<int64_t>(document, "member_40", 0);
+			fields.member_44 = rjutils::Extract<int64_t>(document, "member_44", 0);
+			fields.member_48 = rjutils::Extract<int64_t>(document, "member_48", 0);
+			fields.member_52 = rjutils::Extract<int64_t>(document, "member_52", 0);
+			fields.member_56 = rjutils::Extract<int64_t>(document, "member_56", 0);
+			fields.member_60 = rjutils::Extract<int64_t>(document, "member_60", 0);
+			benchmark::DoNotOptimize(fields);
+		}
+		state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * 16);
+	}
+	BENCHMARK(BM_ExtractStructPerField);
+
+	//-----------------------------------------------------------------------------------------
+	// ParseFile: a generated file of roughly N bytes of records
+	//-----------------------------------------------------------------------------------------
+	std::filesystem::path WriteTestFile(size_t target_bytes, size_t& out_record_count)
+	{
+		const std::filesystem::path path = std::filesystem::temp_directory_path() / ("rjutils_bench_" + std::to_string(target_bytes) + ".json");
+		FILE* fp = fopen(path.string().c_str(), "wb");
+		if (!fp)
+			return {};
+
+		std::string record;
+		size_t written = fprintf(fp, "{\"records\":[");
+		out_record_count = 0;
+		while (written < target_bytes)
+		{
+			record = (out_record_count ? "," : "");
+			record += "{\"id\":" + std::to_string(out_record_count)
+				+ ",\"name\":\"record_" + std::to_string(out_record_count)
+				+ "\",\"value\":" + std::to_string(static_cast<double>(out_record_count) * 0.125)
+				+ ",\"active\":" + ((out_record_count & 1) ? "true" : "false")
+				+ ",\"tags\":[\"alpha\",\"beta\",\"gamma\"]}";
+			written += fwrite(record.data(), 1, record.size(), fp);
+			++out_record_count;
+		}
+		written += fprintf(fp, "]}");
+		fclose(fp);
+		return path;
+	}
+
+	enum class ParseMode { Stream, Insitu, Mapped, Cached };
+
+	template<ParseMode MODE>
+	void BM_ParseFile(benchmark::State& state)
+	{
+		size_t record_count = 0;
+		const std::filesystem::path path = WriteTestFile(static_cast<size_t>(state.range(0)), record_count);
+		if (path.empty())
+		{
+			state.SkipWithError("Could not write the benchmark input file");
+			return;
+		}
+		const int64_t file_bytes = static_cast<int64_t>(std::filesystem::file_size(path));
+
+		for (auto _ : state)
+		{
+			bool parsed = false;
+			if constexpr (MODE == ParseMode::Stream)
+			{
+				rapidjson::Document document;
+				parsed = rjutils::ParseFile(path.string().c_str(), document);
+				benchmark::DoNotOptimize(document.IsObject());
+			}
+			else
+			{
+				rjutils::InsituDocument document;
+				if constexpr (MODE == ParseMode::Cached)
+					parsed = rjutils::ParseFileCached(path.string().c_str(), document);
+				else if constexpr (MODE == ParseMode::Mapped)
+					parsed = rjutils::ParseFileMapped(path.string().c_str(), document);
+				else
+					parsed = rjutils::ParseFileInsitu(path.string().c_str(), document);
+				benchmark::DoNotOptimize(document->IsObject());
+			}
+
+			if (!parsed)
+			{
+				state.SkipWithError("Parsing failed");
+				break;
+			}
+		}
+		state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(record_count));
+		state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * file_bytes);
+
+		std::error_code ignored;
+		std::filesystem::remove(path, ignored);
+		if constexpr (MODE == ParseMode::Cached)
+			std::filesystem::remove(path.string() + ".rjsnap", ignored);
+	}
+	BENCHMARK_TEMPLATE(BM_ParseFile, ParseMode::Stream)->Arg(1 << 20)->Arg(100 << 20)->Unit(benchmark::kMillisecond)->UseRealTime();
+	BENCHMARK_TEMPLATE(BM_ParseFile, ParseMode::Insitu)->Arg(1 << 20)->Arg(100 << 20)->Unit(benchmark::kMillisecond)->UseRealTime();
+	BENCHMARK_TEMPLATE(BM_ParseFile, ParseMode::Mapped)->Arg(1 << 20)->Arg(100 << 20)->Unit(benchmark::kMillisecond)->UseRealTime();
+	BENCHMARK_TEMPLATE(BM_ParseFile, ParseMode::Cached)->Arg(1 << 20)->Arg(100 << 20)->Unit(benchmark::kMillisecond)->UseRealTime();
+#ifdef UTILS_BENCHMARK_HUGE_INPUTS
+	BENCHMARK_TEMPLATE(BM_ParseFile, ParseMode::Stream)->Arg(1 << 30)->Unit(benchmark::kMillisecond)->UseRealTime()->Iterations(3);
+	BENCHMARK_TEMPLATE(BM_ParseFile, ParseMode::Insitu)->Arg(1 << 30)->Unit(benchmark::kMillisecond)->UseRealTime()->Iterations(3);
+	BENCHMARK_TEMPLATE(BM_ParseFile, ParseMode::Mapped)->Arg(1 << 30)->Unit(benchmark::kMillisecond)->UseRealTime()->Iterations(3);
+	BENCHMARK_TEMPLATE(BM_ParseFile, ParseMode::Cached)->Arg(1 << 30)->Unit(benchmark::kMillisecond)->UseRealTime()->Iterations(3);
+#endif
+
+	// Streaming the same files element by element, extracting one field per record
+	void BM_ParseFileArray(benchmark::State& state)
+	{
+		size_t record_count = 0;
+		const std::filesystem::path path = WriteTestFile(static_cast<size_t>(state.range(0)), record_count);
+		if (path.empty())
+		{
+			state.SkipWithError("Could not write the benchmark input file");
+			return;
+		}
+		const int64_t file_bytes = static_cast<int64_t>(std::filesystem::file_size(path));
+
+		for (auto _ : state)
+		{
+			double total = 0.0;
+			if (!rjutils::ParseFileArray(path.string().c_str(), "records", [&](const rapidjson::Value& record) { total += rjutils::Extract<double>(record, "value", 0.0); }))
+			{
+				state.SkipWithError("ParseFileArray failed");
+				break;
+			}
+			benchmark::DoNotOptimize(total);
+		}
+		state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(record_count));
+		state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * file_bytes);
+
+		std::error_code ignored;
+		std::filesystem::remove(path, ignored);
+	}
+	BENCHMARK(BM_ParseFileArray)->Arg(1 << 20)->Arg(100 << 20)->Unit(benchmark::kMillisecond)->UseRealTime();
+#ifdef UTILS_BENCHMARK_HUGE_INPUTS
+	BENCHMARK(BM_ParseFileArray)->Arg(1 << 30)->Unit(benchmark::kMillisecond)->UseRealTime()->Iterations(3);
+#endif
+
+	// Selective parsing of the same files: one record near the start (stops early), or a missing
+	// member (scans the whole file without building anything)
+	template<bool EARLY_EXIT>
+	void BM_ParseFileSelective(benchmark::State& state)
+	{
+		size_t record_count = 0;
+		const std::filesystem::path path = WriteTestFile(static_cast<size_t>(state.range(0)), record_count);
+		if (path.empty())
+		{
+			state.SkipWithError("Could not write the benchmark input file");
+			return;
+		}
+		const int64_t file_bytes = static_cast<int64_t>(std::filesystem::file_size(path));
+
+		for (auto _ : state)
+		{
+			rapidjson::Document document;
+			if (!rjutils::ParseFileSelective(path.string().c_str(), { EARLY_EXIT ? "/records/100" : "/missing" }, document))
+			{
+				state.SkipWithError("ParseFileSelective failed");
+				break;
+			}
+			benchmark::DoNotOptimize(document.IsObject());
+		}
+		state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * file_bytes);
+
+		std::error_code ignored;
+		std::filesystem::remove(path, ignored);
+	}
+	BENCHMARK_TEMPLATE(BM_ParseFileSelective, true)->Arg(1 << 20)->Arg(100 << 20)->Unit(benchmark::kMillisecond)->UseRealTime();
+	BENCHMARK_TEMPLATE(BM_ParseFileSelective, false)->Arg(1 << 20)->Arg(100 << 20)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+	// A batch of 1024 asset-sized (16 KB) files, loaded with ParseFiles on 1 thread vs. all cores
+	void BM_ParseFiles(benchmark::State& state)
+	{
+		constexpr size_t FILE_COUNT = 1024;
+		size_t record_count = 0;
+		const std::filesystem::path path = WriteTestFile(16 << 10, record_count);
+		if (path.empty())
+		{
+			state.SkipWithError("Could not write the benchmark input file");
+			return;
+		}
+		const int64_t file_bytes = static_cast<int64_t>(std::filesystem::file_size(path));
+		const std::string file_name = path.string();
+		const std::vector<const char*> file_names(FILE_COUNT, file_name.c_str());
+
+		for (auto _ : state)
+		{
+			std::vector<rapidjson::Document> documents(FILE_COUNT);
+			if (!rjutils::ParseFiles(file_names.data(), file_names.size(), documents.data(), nullptr, static_cast<unsigned int>(state.range(0))))
+			{
+				state.SkipWithError("ParseFiles failed");
+				break;
+			}
+			benchmark::DoNotOptimize(documents.back().IsObject());
+		}
+		state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(FILE_COUNT));
+		state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(FILE_COUNT) * file_bytes);
+
+		std::error_code ignored;
+		std::filesystem::remove(path, ignored);
+	}
+	BENCHMARK(BM_ParseFiles)->Arg(1)->Arg(0)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+	//-----------------------------------------------------------------------------------------
+	// Nested access two levels down into N-member objects: CompiledPath (with member hints) vs.
+	// chained lookups by hand
+	//-----------------------------------------------------------------------------------------
+	void BuildNestedObject(rapidjson::Document& document, size_t member_count, std::vector<std::string>& out_names)
+	{
+		rapidjson::Document inner(&document.GetAllocator());
+		BuildObject<int64_t>(inner, member_count, out_names);
+		rapidjson::Value outer(rapidjson::kObjectType);
+		outer.AddMember("inner", static_cast<rapidjson::Value&>(inner), document.GetAllocator());
+
+		BuildObject<int64_t>(document, member_count, out_names);
+		document.AddMember("outer", outer, document.GetAllocator());
+	}
+
+	void BM_ExtractPath(benchmark::State& state)
+	{
+		const size_t member_count = static_cast<size_t>(state.range(0));
+		rapidjson::Document document;
+		std::vector<std::string> names;
+		BuildNestedObject(document, member_count, names);
+		const rjutils::CompiledPath path(("/outer/inner/" + names.back()).c_str());
+
+		for (auto _ : state)
+			benchmark::DoNotOptimize(rjutils::ExtractPath<int64_t>(document, path, 0));
+		state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+	}
+	BENCHMARK(BM_ExtractPath)->Arg(8)->Arg(64)->Arg(512);
+
+	void BM_ExtractPathByHand(benchmark::State& state)
+	{
+		const size_t member_count = static_cast<size_t>(state.range(0));
+		rapidjson::Document document;
+		std::vector<std::string> names;
+		BuildNestedObject(document, member_count, names);
+		const char* last = names.back().c_str();
+
+		for (auto _ : state)
+		{
+			int64_t value = 0;
+			if (rjutils::IsValidObject(document, "outer") && rjutils::IsValidObject(document["outer"], "inner"))
+				value = rjutils::Extract<int64_t>(document["outer"]["inner"], last, 0);
+			benchmark::DoNotOptimize(value);
+		}
+		state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+	}
+	BENCHMARK(BM_ExtractPathByHand)->Arg(8)->Arg(64)->Arg(512);
+
+	//-----------------------------------------------------------------------------------------
+	// ExtractArray vs. a hand-written IsValid + getter loop over an array of N doubles
+	//-----------------------------------------------------------------------------------------
+	void BuildDoubleArray(rapidjson::Document& document, size_t count)
+	{
+		document.SetObject();
+		auto& allocator = document.GetAllocator();
+		rapidjson::Value values(rapidjson::kArrayType);
+		values.Reserve(static_cast<rapidjson::SizeType>(count), allocator);
+		for (size_t i = 0; i < count; ++i)
+			values.PushBack(static_cast<double>(i) * 0.25, allocator);
+		document.AddMember("values", values, allocator);
+	}
+
+	void BM_ExtractArray(benchmark::State& state)
+	{
+		const size_t count = static_cast<size_t>(state.range(0));
+		rapidjson::Document document;
+		BuildDoubleArray(document, count);
+
+		std::vector<double> values;
+		for (auto _ : state)
+		{
+			rjutils::ExtractArray(document, "values", values);
+			benchmark::DoNotOptimize(values.data());
+		}
+		state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(count));
+		state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(count * sizeof(double)));
+	}
+	BENCHMARK(BM_ExtractArray)->Arg(1 << 10)->Arg(1 << 20);
+
+	void BM_ExtractArrayHandLoop(benchmark::State& state)
+	{
+		const size_t count = static_cast<size_t>(state.range(0));
+		rapidjson::Document document;
+		BuildDoubleArray(document, count);
+
+		std::vector<double> values;
+		for (auto _ : state)
+		{
+			values.clear();
+			if (rjutils::IsValidArray(document, "values"))
+			{
+				for (const auto& value : document["values"].GetArray())
+					values.push_back(rjutils::ExtractValue<double>(value, 0.0));
+			}
+			benchmark::DoNotOptimize(values.data());
+		}
+		state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(count));
+		state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(count * sizeof(double)));
+	}
+	BENCHMARK(BM_ExtractArrayHandLoop)->Arg(1 << 10)->Arg(1 << 20);
+
+	//-----------------------------------------------------------------------------------------
+	// Many small messages: a fresh Document per message vs. a reused rjutils::Parser
+	//-----------------------------------------------------------------------------------------
+	const std::string SMALL_MESSAGE = "{\"id\":123456,\"type\":\"order\",\"price\":19.95,\"quantity\":3,\"tags\":[\"a\",\"b\"],\"customer\":{\"name\":\"someone\",\"vip\":false}}";
+
+	void BM_ParseMessage_Document(benchmark::State& state)
+	{
+		for (auto _ : state)
+		{
+			rapidjson::Document document;
+			document.Parse(SMALL_MESSAGE.c_str(), SMALL_MESSAGE.size());
+			benchmark::DoNotOptimize(rjutils::Extract<int64_t>(document, "id", 0));
+		}
+		state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+		state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(SMALL_MESSAGE.size()));
+	}
+	BENCHMARK(BM_ParseMessage_Document);
+
+	void BM_ParseMessage_Parser(benchmark::State& state)
+	{
+		rjutils::Parser parser;
+		for (auto _ : state)
+		{
+			parser.Parse(SMALL_MESSAGE.c_str(), SMALL_MESSAGE.size());
+			benchmark::DoNotOptimize(rjutils::Extract<int64_t>(parser.GetDocument(), "id", 0));
+		}
+		state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+		state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(SMALL_MESSAGE.size()));
+	}
+	BENCHMARK(BM_ParseMessage_Parser);
+
+	//-----------------------------------------------------------------------------------------
+	// ExtractFromNumericOrString: the same value stored as a number and as a string
+	//-----------------------------------------------------------------------------------------
+	constexpr size_t NUMERIC_OR_STRING_MEMBERS = 64;
+
+	template<typename DataType, bool AS_STRING>
+	void BM_ExtractFromNumericOrString(benchmark::State& state)
+	{
+		rapidjson::Document document;
+		document.SetObject();
+		auto& allocator = document.GetAllocator();
+		std::vector<std::string> names;
+		size_t name_bytes = 0;
+		for (size_t i = 0; i < NUMERIC_OR_STRING_MEMBERS; ++i)
+		{
+			names.push_back("member_" + std::to_string(i));
+			name_bytes += names.back().size();
+			rapidjson::Value name(names.back().c_str(), allocator);
+			rapidjson::Value value;
+			if constexpr (AS_STRING)
+			{
+				const std::string text = std::is_floating_point<DataType>::value ? std::to_string(static_cast<double>(i) + 0.5) : std::to_string(i * 1000003u);
+				value.SetString(text.c_str(), static_cast<rapidjson::SizeType>(text.size()), allocator);
+			}
+			else if constexpr (std::is_floating_point<DataType>::value)
+				value.SetDouble(static_cast<double>(i) + 0.5);
+			else
+				value.SetInt(static_cast<int>(i * 1000003u));
+			document.AddMember(name, value, allocator);
+		}
+
+		for (auto _ : state)
+		{
+			for (const auto& name : names)
+				benchmark::DoNotOptimize(rjutils::ExtractFromNumericOrString<DataType>(document, name.c_str(), DataType()));
+		}
+		state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(NUMERIC_OR_STRING_MEMBERS));
+		state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(name_bytes));
+	}
+	BENCHMARK_TEMPLATE(BM_ExtractFromNumericOrString, int32_t, false);
+	BENCHMARK_TEMPLATE(BM_ExtractFromNumericOrString, int32_t, true);
+	BENCHMARK_TEMPLATE(BM_ExtractFromNumericOrString, int64_t, false);
+	BENCHMARK_TEMPLATE(BM_ExtractFromNumericOrString, int64_t, true);
+	BENCHMARK_TEMPLATE(BM_ExtractFromNumericOrString, double, false);
+	BENCHMARK_TEMPLATE(BM_ExtractFromNumericOrString, double, true);
+}
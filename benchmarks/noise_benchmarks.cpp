@@ -0,0 +1,453 @@
+//
+// SquirrelNoise5 microbenchmarks: scalar functions vs. the batch / grid kernels, and the cost
+// of each output mapping. Every benchmark reports samples/s (items_per_second) and output
+// MB/s (bytes_per_second).
+//
+
+#include <cstdint>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "SquirrelDistributions.hpp"
+#include "SquirrelNoise5.hpp"
+#include "SquirrelNoise5Batch.hpp"
+#include "SquirrelNoise5Parallel.hpp"
+#include "SquirrelNoise5Smooth.hpp"
+#include "SquirrelNoise5TileCache.hpp"
+#include "SquirrelPermutation.hpp"
+
+namespace
+{
+	constexpr unsigned int SEED = 0x12345678u;
+
+	// 64K samples per iteration in every dimension, laid out as 65536, 256x256, 64x64x16 and
+	// 32x32x8x8 so the numbers are directly comparable.
+	constexpr size_t SAMPLES = 65536;
+
+	template<typename T>
+	void SetThroughput(benchmark::State& state, size_t samples_per_iteration)
+	{
+		state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(samples_per_iteration));
+		state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(samples_per_iteration * sizeof(T)));
+	}
+
+	//-----------------------------------------------------------------------------------------
+	// 1D
+	//-----------------------------------------------------------------------------------------
+	void BM_Noise1dUint_Scalar(benchmark::State& state)
+	{
+		std::vector<unsigned int> out(SAMPLES);
+		for (auto _ : state)
+		{
+			for (size_t i = 0; i < SAMPLES; ++i)
+				out[i] = Get1dNoiseUint(static_cast<int>(i), SEED);
+			benchmark::DoNotOptimize(out.data());
+			benchmark::ClobberMemory();
+		}
+		SetThroughput<unsigned int>(state, SAMPLES);
+	}
+	BENCHMARK(BM_Noise1dUint_Scalar);
+
+	void BM_Noise1dUint_Range(benchmark::State& state)
+	{
+		std::vector<unsigned int> out(SAMPLES);
+		for (auto _ : state)
+		{
+			Get1dNoiseUintRange(0, SAMPLES, SEED, out.data());
+			benchmark::DoNotOptimize(out.data());
+			benchmark::ClobberMemory();
+		}
+		SetThroughput<unsigned int>(state, SAMPLES);
+	}
+	BENCHMARK(BM_Noise1dUint_Range);
+
+	void BM_Noise1dUint_Batch(benchmark::State& state)
+	{
+		// Scattered indices, so this measures the gather-style entry point rather than a range
+		std::vector<int> indices(SAMPLES);
+		for (size_t i = 0; i < SAMPLES; ++i)
+			indices[i] = static_cast<int>(Get1dNoiseUint(static_cast<int>(i)));
+
+		std::vector<unsigned int> out(SAMPLES);
+		for (auto _ : state)
+		{
+			Get1dNoiseUintBatch(indices.data(), out.data(), SAMPLES, SEED);
+			benchmark::DoNotOptimize(out.data());
+			benchmark::ClobberMemory();
+		}
+		SetThroughput<unsigned int>(state, SAMPLES);
+	}
+	BENCHMARK(BM_Noise1dUint_Batch);
+
+	//-----------------------------------------------------------------------------------------
+	// 2D
+	//-----------------------------------------------------------------------------------------
+	constexpr size_t W2 = 256, H2 = 256;
+
+	void BM_Noise2dUint_Scalar(benchmark::State& state)
+	{
+		std::vector<unsigned int> out(W2 * H2);
+		for (auto _ : state)
+		{
+			for (size_t y = 0; y < H2; ++y)
+				for (size_t x = 0; x < W2; ++x)
+					out[y * W2 + x] = Get2dNoiseUint(static_cast<int>(x), static_cast<int>(y), SEED);
+			benchmark::DoNotOptimize(out.data());
+			benchmark::ClobberMemory();
+		}
+		SetThroughput<unsigned int>(state, W2 * H2);
+	}
+	BENCHMARK(BM_Noise2dUint_Scalar);
+
+	void BM_Noise2dUint_Fill(benchmark::State& state)
+	{
+		std::vector<unsigned int> out(W2 * H2);
+		for (auto _ : state)
+		{
+			Fill2dNoiseUint(0, 0, W2, H2, W2, SEED, out.data());
+			benchmark::DoNotOptimize(out.data());
+			benchmark::ClobberMemory();
+		}
+		SetThroughput<unsigned int>(state, W2 * H2);
+	}
+	BENCHMARK(BM_Noise2dUint_Fill);
+
+	//-----------------------------------------------------------------------------------------
+	// 3D
+	//-----------------------------------------------------------------------------------------
+	constexpr size_t W3 = 64, H3 = 64, D3 = 16;
+
+	void BM_Noise3dUint_Scalar(benchmark::State& state)
+	{
+		std::vector<unsigned int> out(W3 * H3 * D3);
+		for (auto _ : state)
+		{
+			for (size_t z = 0; z < D3; ++z)
+				for (size_t y = 0; y < H3; ++y)
+					for (size_t x = 0; x < W3; ++x)
+						out[(z * H3 + y) * W3 + x] = Get3dNoiseUint(static_cast<int>(x), static_cast<int>(y), static_cast<int>(z), SEED);
+			benchmark::DoNotOptimize(out.data());
+			benchmark::ClobberMemory();
+		}
+		SetThroughput<unsigned int>(state, W3 * H3 * D3);
+	}
+	BENCHMARK(BM_Noise3dUint_Scalar);
+
+	void BM_Noise3dUint_Fill(benchmark::State& state)
+	{
+		std::vector<unsigned int> out(W3 * H3 * D3);
+		for (auto _ : state)
+		{
+			Fill3dNoiseUint(0, 0, 0, W3, H3, D3, W3, W3 * H3, SEED, out.data());
+			benchmark::DoNotOptimize(out.data());
+			benchmark::ClobberMemory();
+		}
+		SetThroughput<unsigned int>(state, W3 * H3 * D3);
+	}
+	BENCHMARK(BM_Noise3dUint_Fill);
+
+	//-----------------------------------------------------------------------------------------
+	// 4D (there is no serial 4D grid fill; a single-threaded ParallelFill is the batch path)
+	//-----------------------------------------------------------------------------------------
+	constexpr size_t W4 = 32, H4 = 32, D4 = 8, T4 = 8;
+
+	void BM_Noise4dUint_Scalar(benchmark::State& state)
+	{
+		std::vector<unsigned int> out(W4 * H4 * D4 * T4);
+		for (auto _ : state)
+		{
+			for (size_t t = 0; t < T4; ++t)
+				for (size_t z = 0; z < D4; ++z)
+					for (size_t y = 0; y < H4; ++y)
+						for (size_t x = 0; x < W4; ++x)
+							out[((t * D4 + z) * H4 + y) * W4 + x] = Get4dNoiseUint(static_cast<int>(x), static_cast<int>(y), static_cast<int>(z), static_cast<int>(t), SEED);
+			benchmark::DoNotOptimize(out.data());
+			benchmark::ClobberMemory();
+		}
+		SetThroughput<unsigned int>(state, W4 * H4 * D4 * T4);
+	}
+	BENCHMARK(BM_Noise4dUint_Scalar);
+
+	void BM_Noise4dUint_Fill(benchmark::State& state)
+	{
+		// Arg = worker thread count, 0 = hardware concurrency
+		noise::ParallelFill filler(static_cast<unsigned int>(state.range(0)));
+		std::vector<unsigned int> out(W4 * H4 * D4 * T4);
+		for (auto _ : state)
+		{
+			filler.Fill4dNoiseUint(0, 0, 0, 0, W4, H4, D4, T4, W4, W4 * H4, W4 * H4 * D4, SEED, out.data());
+			benchmark::DoNotOptimize(out.data());
+			benchmark::ClobberMemory();
+		}
+		SetThroughput<unsigned int>(state, W4 * H4 * D4 * T4);
+	}
+	BENCHMARK(BM_Noise4dUint_Fill)->Arg(1)->Arg(0)->UseRealTime();
+
+	//-----------------------------------------------------------------------------------------
+	// Output mappings (1D, so the index hash cost is the same for all of them)
+	//-----------------------------------------------------------------------------------------
+	template<float (*MAPPING)(int, unsigned int)>
+	void BM_Noise1dMapping_Scalar(benchmark::State& state)
+	{
+		std::vector<float> out(SAMPLES);
+		for (auto _ : state)
+		{
+			for (size_t i = 0; i < SAMPLES; ++i)
+				out[i] = MAPPING(static_cast<int>(i), SEED);
+			benchmark::DoNotOptimize(out.data());
+			benchmark::ClobberMemory();
+		}
+		SetThroughput<float>(state, SAMPLES);
+	}
+	BENCHMARK_TEMPLATE(BM_Noise1dMapping_Scalar, Get1dNoiseZeroToOne);
+	BENCHMARK_TEMPLATE(BM_Noise1dMapping_Scalar, Get1dNoiseNegOneToOne);
+	BENCHMARK_TEMPLATE(BM_Noise1dMapping_Scalar, Get1dNoiseZeroToOneFast);
+	BENCHMARK_TEMPLATE(BM_Noise1dMapping_Scalar, Get1dNoiseNegOneToOneFast);
+
+	template<void (*MAPPING)(int, size_t, unsigned int, float*)>
+	void BM_Noise1dMapping_Range(benchmark::State& state)
+	{
+		std::vector<float> out(SAMPLES);
+		for (auto _ : state)
+		{
+			MAPPING(0, SAMPLES, SEED, out.data());
+			benchmark::DoNotOptimize(out.data());
+			benchmark::ClobberMemory();
+		}
+		SetThroughput<float>(state, SAMPLES);
+	}
+	BENCHMARK_TEMPLATE(BM_Noise1dMapping_Range, Get1dNoiseZeroToOneRange);
+	BENCHMARK_TEMPLATE(BM_Noise1dMapping_Range, Get1dNoiseNegOneToOneRange);
+	BENCHMARK_TEMPLATE(BM_Noise1dMapping_Range, Get1dNoiseZeroToOneFastRange);
+	BENCHMARK_TEMPLATE(BM_Noise1dMapping_Range, Get1dNoiseNegOneToOneFastRange);
+
+	template<void (*MAPPING)(int, int, size_t, size_t, size_t, unsigned int, float*)>
+	void BM_Noise2dMapping_Fill(benchmark::State& state)
+	{
+		std::vector<float> out(W2 * H2);
+		for (auto _ : state)
+		{
+			MAPPING(0, 0, W2, H2, W2, SEED, out.data());
+			benchmark::DoNotOptimize(out.data());
+			benchmark::ClobberMemory();
+		}
+		SetThroughput<float>(state, W2 * H2);
+	}
+	BENCHMARK_TEMPLATE(BM_Noise2dMapping_Fill, Fill2dNoiseZeroToOne);
+	BENCHMARK_TEMPLATE(BM_Noise2dMapping_Fill, Fill2dNoiseNegOneToOne);
+	BENCHMARK_TEMPLATE(BM_Noise2dMapping_Fill, Fill2dNoiseZeroToOneFast);
+	BENCHMARK_TEMPLATE(BM_Noise2dMapping_Fill, Fill2dNoiseNegOneToOneFast);
+
+	//-----------------------------------------------------------------------------------------
+	// Heightmap normals from 6-octave Perlin noise: central differences (5 evaluations per point)
+	// vs. the analytic derivatives (1 evaluation).
+
+	void BM_PerlinNormals_FiniteDifferences(benchmark::State& state)
+	{
+		constexpr float H = 0.01f;
+		std::vector<float> slopes(2 * W2 * H2);
+		for (auto _ : state)
+		{
+			for (size_t i = 0; i < W2 * H2; ++i)
+			{
+				const float x = static_cast<float>(i % W2);
+				const float y = static_cast<float>(i / W2);
+				benchmark::DoNotOptimize(Compute2dPerlinNoise<6>(x, y, 250.f));
+				slopes[2 * i] = (Compute2dPerlinNoise<6>(x + H, y, 250.f) - Compute2dPerlinNoise<6>(x - H, y, 250.f)) / (2.f * H);
+				slopes[2 * i + 1] = (Compute2dPerlinNoise<6>(x, y + H, 250.f) - Compute2dPerlinNoise<6>(x, y - H, 250.f)) / (2.f * H);
+			}
+			benchmark::DoNotOptimize(slopes.data());
+			benchmark::ClobberMemory();
+		}
+		SetThroughput<float>(state, W2 * H2);
+	}
+	BENCHMARK(BM_PerlinNormals_FiniteDifferences);
+
+	void BM_PerlinNormals_Analytic(benchmark::State& state)
+	{
+		std::vector<float> slopes(2 * W2 * H2);
+		for (auto _ : state)
+		{
+			for (size_t i = 0; i < W2 * H2; ++i)
+			{
+				const float x = static_cast<float>(i % W2);
+				const float y = static_cast<float>(i / W2);
+				benchmark::DoNotOptimize(Compute2dPerlinNoiseAndDerivatives<6>(x, y, slopes[2 * i], slopes[2 * i + 1], 250.f));
+			}
+			benchmark::DoNotOptimize(slopes.data());
+			benchmark::ClobberMemory();
+		}
+		SetThroughput<float>(state, W2 * H2);
+	}
+	BENCHMARK(BM_PerlinNormals_Analytic);
+
+	void BM_PerlinNormals_AnalyticFill(benchmark::State& state)
+	{
+		std::vector<float> heights(W2 * H2);
+		std::vector<float> slopesX(W2 * H2);
+		std::vector<float> slopesY(W2 * H2);
+		for (auto _ : state)
+		{
+			Fill2dPerlinNoiseAndDerivatives<6>(0.f, 0.f, 1.f, W2, H2, W2, heights.data(), slopesX.data(), slopesY.data(), 250.f);
+			benchmark::DoNotOptimize(heights.data());
+			benchmark::DoNotOptimize(slopesX.data());
+			benchmark::DoNotOptimize(slopesY.data());
+			benchmark::ClobberMemory();
+		}
+		SetThroughput<float>(state, W2 * H2);
+	}
+	BENCHMARK(BM_PerlinNormals_AnalyticFill);
+
+	//-----------------------------------------------------------------------------------------
+	// Random-access permutation of a domain that isn't a power of two (so it cycle-walks)
+
+	constexpr unsigned int PERMUTATION_DOMAIN = 100000000;
+
+	void BM_Permute_Scalar(benchmark::State& state)
+	{
+		std::vector<unsigned int> out(SAMPLES);
+		unsigned int start = 0;
+		for (auto _ : state)
+		{
+			for (size_t i = 0; i < SAMPLES; ++i)
+				out[i] = Permute(start + static_cast<unsigned int>(i), PERMUTATION_DOMAIN, SEED);
+			start = (start + SAMPLES) % (PERMUTATION_DOMAIN - SAMPLES);
+			benchmark::DoNotOptimize(out.data());
+			benchmark::ClobberMemory();
+		}
+		SetThroughput<unsigned int>(state, SAMPLES);
+	}
+	BENCHMARK(BM_Permute_Scalar);
+
+	void BM_Permute_Range(benchmark::State& state)
+	{
+		std::vector<unsigned int> out(SAMPLES);
+		unsigned int start = 0;
+		for (auto _ : state)
+		{
+			PermuteRange(start, SAMPLES, PERMUTATION_DOMAIN, SEED, out.data());
+			start = (start + SAMPLES) % (PERMUTATION_DOMAIN - SAMPLES);
+			benchmark::DoNotOptimize(out.data());
+			benchmark::ClobberMemory();
+		}
+		SetThroughput<unsigned int>(state, SAMPLES);
+	}
+	BENCHMARK(BM_Permute_Range);
+
+	//-----------------------------------------------------------------------------------------
+	// Distribution sampling
+
+	void BM_Normal_Scalar(benchmark::State& state)
+	{
+		std::vector<float> out(SAMPLES);
+		for (auto _ : state)
+		{
+			for (size_t i = 0; i < SAMPLES; ++i)
+				out[i] = GetNormal(static_cast<int>(i), SEED);
+			benchmark::DoNotOptimize(out.data());
+			benchmark::ClobberMemory();
+		}
+		SetThroughput<float>(state, SAMPLES);
+	}
+	BENCHMARK(BM_Normal_Scalar);
+
+	void BM_Normal_Range(benchmark::State& state)
+	{
+		std::vector<float> out(SAMPLES);
+		for (auto _ : state)
+		{
+			GetNormalRange(0, SAMPLES, SEED, out.data());
+			benchmark::DoNotOptimize(out.data());
+			benchmark::ClobberMemory();
+		}
+		SetThroughput<float>(state, SAMPLES);
+	}
+	BENCHMARK(BM_Normal_Range);
+
+	void BM_Exponential_Range(benchmark::State& state)
+	{
+		std::vector<float> out(SAMPLES);
+		for (auto _ : state)
+		{
+			GetExponentialRange(0, SAMPLES, SEED, out.data());
+			benchmark::DoNotOptimize(out.data());
+			benchmark::ClobberMemory();
+		}
+		SetThroughput<float>(state, SAMPLES);
+	}
+	BENCHMARK(BM_Exponential_Range);
+
+	void BM_AliasTable_Range(benchmark::State& state)
+	{
+		std::vector<float> weights(1024);
+		for (size_t i = 0; i < weights.size(); ++i)
+			weights[i] = 1.f + static_cast<float>(i % 37);
+		const AliasTable table(weights.data(), weights.size());
+
+		std::vector<unsigned int> out(SAMPLES);
+		for (auto _ : state)
+		{
+			table.DrawRange(0, SAMPLES, SEED, out.data());
+			benchmark::DoNotOptimize(out.data());
+			benchmark::ClobberMemory();
+		}
+		SetThroughput<unsigned int>(state, SAMPLES);
+	}
+	BENCHMARK(BM_AliasTable_Range);
+
+	//-----------------------------------------------------------------------------------------
+	// Tile cache: a 6-octave Perlin heightmap seen through a 4x4 tile window that moves by one
+	// tile per frame, regenerated every frame vs. served from a TileCache.
+
+	constexpr size_t TILE_SIZE = 64;
+	constexpr int WINDOW_TILES = 4;
+
+	void GeneratePerlinTile(const noise::TileKey& key, float* out, size_t)
+	{
+		Fill2dPerlinNoise<6>(static_cast<float>(key.tileX * static_cast<int>(TILE_SIZE)), static_cast<float>(key.tileY * static_cast<int>(TILE_SIZE)), 1.f,
+			TILE_SIZE, TILE_SIZE, TILE_SIZE, out, 250.f, 0.5f, 2.f, true, key.seed);
+	}
+
+	void BM_TileWindow_Regenerate(benchmark::State& state)
+	{
+		std::vector<float> tile(TILE_SIZE * TILE_SIZE);
+		int frame = 0;
+		for (auto _ : state)
+		{
+			for (int y = 0; y < WINDOW_TILES; ++y)
+				for (int x = 0; x < WINDOW_TILES; ++x)
+				{
+					noise::TileKey key;
+					key.seed = SEED;
+					key.tileX = frame + x;
+					key.tileY = y;
+					GeneratePerlinTile(key, tile.data(), tile.size());
+					benchmark::DoNotOptimize(tile.data());
+				}
+			++frame;
+		}
+		SetThroughput<float>(state, WINDOW_TILES * WINDOW_TILES * TILE_SIZE * TILE_SIZE);
+	}
+	BENCHMARK(BM_TileWindow_Regenerate);
+
+	void BM_TileWindow_Cached(benchmark::State& state)
+	{
+		noise::TileCache cache(TILE_SIZE * TILE_SIZE, 64 << 20, GeneratePerlinTile, 0, 0);
+		int frame = 0;
+		for (auto _ : state)
+		{
+			for (int y = 0; y < WINDOW_TILES; ++y)
+				for (int x = 0; x < WINDOW_TILES; ++x)
+				{
+					noise::TileKey key;
+					key.seed = SEED;
+					key.tileX = frame + x;
+					key.tileY = y;
+					noise::TileHandle tile = cache.Acquire(key);
+					benchmark::DoNotOptimize(tile.GetData());
+				}
+			++frame;
+		}
+		SetThroughput<float>(state, WINDOW_TILES * WINDOW_TILES * TILE_SIZE * TILE_SIZE);
+	}
+	BENCHMARK(BM_TileWindow_Cached);
+}
@@ -15,11 +15,114 @@
 // This way, it's possible to use the full range of bits instead of a truncated
 // value.
 //
+// The cast uses std::bit_cast (C++20) or the compiler builtin behind it, so it
+// can be used in constant expressions. Really old toolchains fall back to
+// memcpy, which the compiler still turns into a plain register move, but isn't
+// constexpr; CASTKEEPINGBITS_CONSTEXPR tells which one you got.
+//
+// For whole buffers:
+//
+//	CastKeepingBitsSpan<uint32_t>(signedValues)
+//		Zero-copy view of the same memory, for types that may alias each other
+//		(the signed and unsigned versions of the same integer).
+//
+//	CastKeepingBitsBulk(fromValues, toValues, count)
+//	CastKeepingBitsSpan(fromValues, toValues)
+//		Copies into another buffer, for any pair of types of the same size
+//		(e.g. float <-> uint32_t). This is a single memcpy, so it runs at memory
+//		bandwidth.
+//
+
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+#if defined(__has_include)
+	#if __has_include(<bit>)
+		#include <bit>
+	#endif
+	#if __has_include(<span>)
+		#include <span>
+	#endif
+#endif
+
+#if defined(__cpp_lib_bit_cast)
+	#define CASTKEEPINGBITS_BIT_CAST(ToType, FromValue) std::bit_cast<ToType>(FromValue)
+#elif defined(__has_builtin)
+	#if __has_builtin(__builtin_bit_cast)
+		#define CASTKEEPINGBITS_BIT_CAST(ToType, FromValue) __builtin_bit_cast(ToType, FromValue)
+	#endif
+#elif defined(_MSC_VER) && _MSC_VER >= 1927
+	#define CASTKEEPINGBITS_BIT_CAST(ToType, FromValue) __builtin_bit_cast(ToType, FromValue)
+#endif
+
+#if defined(CASTKEEPINGBITS_BIT_CAST)
+	#define CASTKEEPINGBITS_CONSTEXPR constexpr
+#else
+	#define CASTKEEPINGBITS_CONSTEXPR inline
+#endif
 
 template <typename ToType, typename FromType>
-constexpr ToType CastKeepingBits(const FromType& FromValue)
+CASTKEEPINGBITS_CONSTEXPR ToType CastKeepingBits(const FromType& FromValue)
 {
 	static_assert(sizeof(FromType) == sizeof(ToType), "Sizes of the template parameters do not match.");
-	constexpr union SignedToUnsigned { FromType from; ToType to; };
-	return SignedToUnsigned({ FromValue }).to;
+	static_assert(std::is_trivially_copyable<FromType>::value && std::is_trivially_copyable<ToType>::value, "Both types must be trivially copyable.");
+#if defined(CASTKEEPINGBITS_BIT_CAST)
+	return CASTKEEPINGBITS_BIT_CAST(ToType, FromValue);
+#else
+	ToType ToValue;
+	std::memcpy(&ToValue, &FromValue, sizeof(ToType));
+	return ToValue;
+#endif
+}
+
+// True when a FromType object can be read in place through a ToType, without
+// breaking strict aliasing: same type, or signed/unsigned versions of the same
+// integer type.
+template <typename ToType, typename FromType>
+struct CanCastKeepingBitsInPlace
+{
+	typedef typename std::remove_cv<ToType>::type To;
+	typedef typename std::remove_cv<FromType>::type From;
+
+	template <typename T, bool IsInteger = std::is_integral<T>::value && !std::is_same<T, bool>::value>
+	struct Unsigned { typedef T type; };
+	template <typename T>
+	struct Unsigned<T, true> { typedef typename std::make_unsigned<T>::type type; };
+
+	static constexpr bool value = std::is_same<typename Unsigned<To>::type, typename Unsigned<From>::type>::value;
+};
+
+// Copies Count values into ToValues, keeping their bits. The buffers must not
+// overlap (use CastKeepingBitsSpan to reinterpret in place).
+template <typename ToType, typename FromType>
+inline void CastKeepingBitsBulk(const FromType* FromValues, ToType* ToValues, size_t Count)
+{
+	static_assert(sizeof(FromType) == sizeof(ToType), "Sizes of the template parameters do not match.");
+	static_assert(std::is_trivially_copyable<FromType>::value && std::is_trivially_copyable<ToType>::value, "Both types must be trivially copyable.");
+	if (Count > 0)
+		std::memcpy(ToValues, FromValues, Count * sizeof(ToType));
+}
+
+#if defined(__cpp_lib_span)
+// Zero-copy view of FromValues as ToType. Keeps the constness of FromType.
+template <typename ToType, typename FromType, size_t Extent>
+inline auto CastKeepingBitsSpan(std::span<FromType, Extent> FromValues)
+{
+	static_assert(sizeof(FromType) == sizeof(ToType), "Sizes of the template parameters do not match.");
+	static_assert(CanCastKeepingBitsInPlace<ToType, FromType>::value, "These types can't alias each other; use the CastKeepingBitsSpan(from, to) overload to copy them instead.");
+
+	typedef typename std::conditional<std::is_const<FromType>::value, const ToType, ToType>::type ViewType;
+	return std::span<ViewType, Extent>(reinterpret_cast<ViewType*>(FromValues.data()), FromValues.size());
+}
+
+// Copies FromValues into the start of ToValues, keeping their bits, and returns
+// the part of ToValues that was written.
+template <typename ToType, typename FromType, size_t FromExtent, size_t ToExtent>
+inline std::span<ToType> CastKeepingBitsSpan(std::span<FromType, FromExtent> FromValues, std::span<ToType, ToExtent> ToValues)
+{
+	assert(ToValues.size() >= FromValues.size());
+	CastKeepingBitsBulk(FromValues.data(), ToValues.data(), FromValues.size());
+	return std::span<ToType>(ToValues.data(), FromValues.size());
 }
+#endif
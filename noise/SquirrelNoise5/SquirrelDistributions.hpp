@@ -0,0 +1,454 @@
+//-----------------------------------------------------------------------------------------------
+// SquirrelDistributions.hpp
+//
+#pragma once
+
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+#include "SquirrelNoise5Batch.hpp"
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+// SquirrelDistributions - Normal, exponential and weighted discrete samples from SquirrelNoise5
+//
+// Same random-access model as the raw noise functions: sample `index` of a given seed is always
+//	the same value, and can be computed on its own, by any thread, in any order.  The Range
+//	versions fill whole buffers, generating the raw noise with the SIMD batch kernel.
+//
+// Results are bit-identical on every compiler and platform.  All the math (logarithm, square
+//	root, sine/cosine) is done in 64-bit fixed point with portable integer code, and the only
+//	floating point operations are the final int -> float conversion and a multiply by a power of
+//	two, which are exact or correctly rounded everywhere.  So neither the compiler's contraction
+//	of multiply-adds (-ffp-contract, /fp:contract) nor the C library's std::log/std::cos come into
+//	play.
+//
+//	GetNormal			Standard normal (mean 0, variance 1) with the Box-Muller transform.
+//						Samples 2k and 2k+1 are the two halves of one transform, so a Range
+//						call computes one transform per two samples.  |result| <= 6.67.
+//	GetExponential		Exponential with rate 1 (mean 1), as -ln( u ).  Results are in [0, 22.2].
+//	AliasTable			Weighted choice of an index in [0, count), in O(1) per draw with Walker's
+//						alias method.  Weights are converted to integers exactly, so the table
+//						(and every draw) is the same everywhere too.
+//
+// Each distribution mixes its own constant into the seed, so they aren't correlated with the
+//	raw Get1dNoiseUint( index, seed ) of the same seed, nor with one another.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//-----------------------------------------------------------------------------------------------
+// Random-access samples, and the same samples for start, start+1, ... start+count-1.
+//
+inline float GetNormal( int index, unsigned int seed=0 );
+inline float GetExponential( int index, unsigned int seed=0 );
+inline void GetNormalRange( int start, size_t count, unsigned int seed, float* out );
+inline void GetExponentialRange( int start, size_t count, unsigned int seed, float* out );
+
+//-----------------------------------------------------------------------------------------------
+// Table for weighted choices: Draw() returns i with probability weights[i] / sum( weights ).
+//	Weights may be floating point or integers of up to 32 bits; they must be >= 0 and not all
+//	zero, and there can be up to 2^31 - 1 of them.  With floating point weights, those smaller
+//	than 2^-32 times the largest one are never drawn.
+//
+class AliasTable
+{
+public:
+	AliasTable() = default;
+	template<typename Weight> AliasTable( const Weight* weights, size_t count ) { Build( weights, count ); }
+
+	template<typename Weight> void Build( const Weight* weights, size_t count );
+	size_t GetSize() const { return m_thresholds.size(); }
+
+	unsigned int Draw( int index, unsigned int seed=0 ) const;
+	void DrawRange( int start, size_t count, unsigned int seed, unsigned int* out ) const;
+
+private:
+	unsigned int Pick( unsigned int columnNoise, unsigned int acceptNoise ) const;
+
+	std::vector<uint32_t> m_thresholds;		// Column i keeps i when the accept noise is below this,
+	std::vector<uint32_t> m_aliases;		//	and goes to its alias otherwise
+};
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+// Inline function definitions below
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace SquirrelDistributions
+{
+	// Xored into the seed of each distribution; arbitrary bits, just different from each other
+	constexpr unsigned int NORMAL_SEED_NOISE = 0x2F8A5C93;
+	constexpr unsigned int EXPONENTIAL_SEED_NOISE = 0x71B3E6D5;
+	constexpr unsigned int ALIAS_SEED_NOISE = 0xC64D1A27;
+
+	// Fixed point constants; QN means N fractional bits
+	constexpr uint64_t LN2_Q32 = 2977044472ull;				// ln( 2 )
+	constexpr uint64_t INV_LN2_Q31 = 3098164009ull;			// 1 / ln( 2 )
+	constexpr uint64_t INV_LN2_Q32 = 6196328019ull;
+	constexpr int64_t HALF_PI_Q30 = 1686629713ll;			// pi / 2
+	constexpr uint64_t HALF_PI_Q32 = 6746518852ull;
+
+	//-------------------------------------------------------------------------------------------
+	// Lookup tables, built at compile time with integer math only:
+	//	reciprocals[ i ]	2^40 / ( 256 + i ), i.e. 1 / ( 1 + i/256 ) in Q32
+	//	log2s[ i ]			log2( 1 + i/256 ) in Q32
+	//	sines[ i ]			sin( i/256 * pi/2 ) in Q32, for i in [0, 256]
+	//
+	struct Tables
+	{
+		uint64_t reciprocals[ 256 ] = {};
+		uint64_t log2s[ 256 ] = {};
+		int64_t sines[ 257 ] = {};
+	};
+
+	constexpr Tables MakeTables()
+	{
+		Tables tables;
+		for( uint64_t i = 0; i < 256; ++i )
+		{
+			tables.reciprocals[ i ] = ( 1ull << 40 ) / ( 256 + i );
+
+			// ln( 1 + i/256 ) = 2 atanh( z ) = 2 ( z + z^3/3 + z^5/5 ... ), with z = i / ( 512 + i ) <= 1/3
+			const uint64_t z = ( i << 32 ) / ( 512 + i );
+			const uint64_t zSquared = ( z * z ) >> 32;
+			uint64_t ln = 0;
+			uint64_t power = z;
+			for( uint64_t k = 1; power != 0; k += 2 )
+			{
+				ln += power / k;
+				power = ( power * zSquared ) >> 32;
+			}
+			tables.log2s[ i ] = ( ( 2 * ln ) * INV_LN2_Q31 ) >> 31;
+		}
+
+		for( int64_t i = 0; i <= 256; ++i )
+		{
+			// Taylor series in Q30 (x <= pi/2 keeps every product within 64 bits)
+			const int64_t x = ( HALF_PI_Q30 * i ) / 256;
+			const int64_t xSquared = ( x * x ) >> 30;
+			int64_t sine = x;
+			int64_t term = x;
+			for( int64_t k = 1; term != 0; ++k )
+			{
+				term = -( ( ( term * xSquared ) >> 30 ) / ( ( 2 * k ) * ( 2 * k + 1 ) ) );
+				sine += term;
+			}
+			tables.sines[ i ] = ( sine < 0 ) ? 0 : ( sine > ( 1ll << 30 ) ) ? ( 1ll << 32 ) : sine * 4;
+		}
+		return tables;
+	}
+
+	inline constexpr Tables TABLES = MakeTables();
+
+	//-------------------------------------------------------------------------------------------
+	constexpr int HighestBit( uint64_t value )
+	{
+		int bit = 0;
+		for( int shift = 32; shift > 0; shift >>= 1 )
+		{
+			if( value >> shift )
+			{
+				value >>= shift;
+				bit += shift;
+			}
+		}
+		return bit;
+	}
+
+	//-------------------------------------------------------------------------------------------
+	// log2( value ) in Q32, for value in [1, 2^33).  Table lookup on the top 8 mantissa bits, then
+	//	a cubic ln( 1 + t ) for the rest (t < 1/256, so the error is below 2^-34).
+	//
+	constexpr int64_t Log2Q32( uint64_t value )
+	{
+		const int exponent = HighestBit( value );
+		const uint64_t mantissa = ( exponent >= 32 ) ? value >> ( exponent - 32 ) : value << ( 32 - exponent );	// Q32, [1, 2)
+		const unsigned int segment = (unsigned int)( mantissa >> 24 ) & 0xFF;
+		const uint64_t remainder = mantissa - ( (uint64_t)( 256 + segment ) << 24 );
+
+		const uint64_t t = ( remainder * TABLES.reciprocals[ segment ] ) >> 32;
+		const uint64_t tSquared = ( t * t ) >> 32;
+		const uint64_t tCubed = ( tSquared * t ) >> 32;
+		const uint64_t ln = t - tSquared / 2 + tCubed / 3;
+		return ( (int64_t) exponent << 32 ) + (int64_t)( TABLES.log2s[ segment ] + ( ( ln * INV_LN2_Q32 ) >> 32 ) );
+	}
+
+	//-------------------------------------------------------------------------------------------
+	// -ln( u ) in Q32 for u = ( noise + 1 ) / 2^32 in (0, 1], i.e. ln2 * ( 32 - log2( noise + 1 ) ).
+	//
+	constexpr uint64_t ExponentialQ32( unsigned int noise )
+	{
+		const int64_t log2Distance = ( 32ll << 32 ) - Log2Q32( (uint64_t) noise + 1 );
+		if( log2Distance <= 0 )
+			return 0;
+
+		const uint64_t distance = (uint64_t) log2Distance;
+		return ( distance >> 32 ) * LN2_Q32 + ( ( ( distance & 0xFFFFFFFFu ) * LN2_Q32 ) >> 32 );
+	}
+
+	//-------------------------------------------------------------------------------------------
+	// floor( sqrt( value ) ).  The double square root is only a first guess, and the result is
+	//	corrected to the exact integer below, so it doesn't matter how the platform rounds it.
+	//
+	inline uint64_t SquareRoot( uint64_t value )
+	{
+		assert( value < ( 1ull << 62 ) );
+		uint64_t root = (uint64_t) std::sqrt( (double) value );
+		while( root * root > value )
+			--root;
+		while( ( root + 1 ) * ( root + 1 ) <= value )
+			++root;
+		return root;
+	}
+
+	//-------------------------------------------------------------------------------------------
+	// Box-Muller: radius sqrt( -2 ln( u1 ) ) and angle 2 pi u2, returns both coordinates in Q60.
+	//
+	inline void NormalPairQ60( unsigned int radiusNoise, unsigned int angleNoise, int64_t& out_cosine, int64_t& out_sine )
+	{
+		const int64_t radius = (int64_t) SquareRoot( ( 2 * ExponentialQ32( radiusNoise ) ) << 24 );	// Q28, < 6.67
+
+		// The angle is in turns: the top 2 bits pick the quadrant, the next 8 a table entry, and
+		//	sin/cos( entry + offset ) are expanded around the entry (offset < pi/512)
+		const unsigned int quadrant = angleNoise >> 30;
+		const unsigned int segment = ( angleNoise >> 22 ) & 0xFF;
+		const uint64_t offset = ( (uint64_t)( angleNoise & 0x3FFFFF ) * HALF_PI_Q32 ) >> 30;		// Radians, Q32
+		const uint64_t offsetSquared = ( offset * offset ) >> 32;
+		const uint64_t offsetCubed = ( offsetSquared * offset ) >> 32;
+		const int64_t sineOfOffset = (int64_t)( offset - offsetCubed / 6 );
+		const int64_t oneMinusCosineOfOffset = (int64_t)( offsetSquared / 2 );
+
+		const int64_t sineOfSegment = TABLES.sines[ segment ];
+		const int64_t cosineOfSegment = TABLES.sines[ 256 - segment ];
+		const int64_t sine = sineOfSegment - ( ( sineOfSegment * oneMinusCosineOfOffset ) >> 32 ) + ( ( cosineOfSegment * sineOfOffset ) >> 32 );
+		const int64_t cosine = cosineOfSegment - ( ( cosineOfSegment * oneMinusCosineOfOffset ) >> 32 ) - ( ( sineOfSegment * sineOfOffset ) >> 32 );
+
+		switch( quadrant )
+		{
+			case 0:		out_cosine = radius * cosine;	out_sine = radius * sine;		break;
+			case 1:		out_cosine = -radius * sine;	out_sine = radius * cosine;		break;
+			case 2:		out_cosine = -radius * cosine;	out_sine = -radius * sine;		break;
+			default:	out_cosine = radius * sine;		out_sine = -radius * cosine;	break;
+		}
+	}
+
+	//-------------------------------------------------------------------------------------------
+	inline float Q60ToFloat( int64_t value )
+	{
+		return (float) value * ( 1.0f / 1152921504606846976.0f );
+	}
+
+	inline float Q32ToFloat( uint64_t value )
+	{
+		return (float)(int64_t) value * ( 1.0f / 4294967296.0f );
+	}
+
+	//-------------------------------------------------------------------------------------------
+	// floor( numerator * 2^32 / denominator ) for numerator < denominator < 2^63, by long division.
+	//
+	inline uint32_t ScaleToQ32( uint64_t numerator, uint64_t denominator )
+	{
+		uint64_t remainder = numerator;
+		uint32_t quotient = 0;
+		for( int bit = 0; bit < 32; ++bit )
+		{
+			remainder <<= 1;
+			quotient <<= 1;
+			if( remainder >= denominator )
+			{
+				remainder -= denominator;
+				quotient |= 1;
+			}
+		}
+		return quotient;
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+inline float GetNormal( int index, unsigned int seed )
+{
+	const unsigned int pairSeed = seed ^ SquirrelDistributions::NORMAL_SEED_NOISE;
+	const unsigned int first = (unsigned int) index & ~1u;
+
+	int64_t cosine = 0;
+	int64_t sine = 0;
+	SquirrelDistributions::NormalPairQ60( SquirrelNoise5( (int) first, pairSeed ), SquirrelNoise5( (int)( first + 1 ), pairSeed ), cosine, sine );
+	return SquirrelDistributions::Q60ToFloat( ( index & 1 ) ? sine : cosine );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+inline float GetExponential( int index, unsigned int seed )
+{
+	const unsigned int noise = SquirrelNoise5( index, seed ^ SquirrelDistributions::EXPONENTIAL_SEED_NOISE );
+	return SquirrelDistributions::Q32ToFloat( SquirrelDistributions::ExponentialQ32( noise ) );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+inline void GetNormalRange( int start, size_t count, unsigned int seed, float* out )
+{
+	constexpr size_t CHUNK_SIZE = SquirrelNoise5Simd::MAPPING_CHUNK_SIZE;
+	static_assert( CHUNK_SIZE % 2 == 0, "Chunks must hold whole pairs" );
+
+	// Raw noise is generated for whole pairs, starting with the pair that holds start
+	const unsigned int pairSeed = seed ^ SquirrelDistributions::NORMAL_SEED_NOISE;
+	const unsigned int first = (unsigned int) start & ~1u;
+	const size_t skipped = (unsigned int) start & 1u;
+	const size_t rawCount = ( count + skipped + 1 ) & ~(size_t) 1;
+
+	unsigned int raw[ CHUNK_SIZE ];
+	for( size_t rawDone = 0; rawDone < rawCount; rawDone += CHUNK_SIZE )
+	{
+		const size_t chunkCount = ( rawCount - rawDone < CHUNK_SIZE ) ? rawCount - rawDone : CHUNK_SIZE;
+		Get1dNoiseUintRange( (int)( first + (unsigned int) rawDone ), chunkCount, pairSeed, raw );
+
+		for( size_t i = 0; i < chunkCount; i += 2 )
+		{
+			int64_t cosine = 0;
+			int64_t sine = 0;
+			SquirrelDistributions::NormalPairQ60( raw[ i ], raw[ i + 1 ], cosine, sine );
+
+			const size_t position = rawDone + i;	// Of the cosine, counting from first
+			if( position >= skipped )
+				out[ position - skipped ] = SquirrelDistributions::Q60ToFloat( cosine );
+			if( position + 1 - skipped < count )
+				out[ position + 1 - skipped ] = SquirrelDistributions::Q60ToFloat( sine );
+		}
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+inline void GetExponentialRange( int start, size_t count, unsigned int seed, float* out )
+{
+	constexpr size_t CHUNK_SIZE = SquirrelNoise5Simd::MAPPING_CHUNK_SIZE;
+	const unsigned int exponentialSeed = seed ^ SquirrelDistributions::EXPONENTIAL_SEED_NOISE;
+
+	unsigned int raw[ CHUNK_SIZE ];
+	for( size_t done = 0; done < count; done += CHUNK_SIZE )
+	{
+		const size_t chunkCount = ( count - done < CHUNK_SIZE ) ? count - done : CHUNK_SIZE;
+		Get1dNoiseUintRange( (int)( (unsigned int) start + (unsigned int) done ), chunkCount, exponentialSeed, raw );
+		for( size_t i = 0; i < chunkCount; ++i )
+			out[ done + i ] = SquirrelDistributions::Q32ToFloat( SquirrelDistributions::ExponentialQ32( raw[ i ] ) );
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Vose's construction, in exact integer arithmetic: every weight becomes an integer mass, scaled
+//	so that each of the count columns holds exactly the total of the weights.
+//
+template<typename Weight>
+inline void AliasTable::Build( const Weight* weights, size_t count )
+{
+	assert( count > 0 && count < 0x80000000u );
+	std::vector<uint64_t> masses( count );
+
+	if constexpr( std::is_floating_point<Weight>::value )
+	{
+		// Scaling by a power of two and truncating is exact, unlike dividing by the total
+		Weight largest = 0;
+		for( size_t i = 0; i < count; ++i )
+		{
+			assert( weights[ i ] >= 0 ); // Also catches NaNs
+			largest = ( weights[ i ] > largest ) ? weights[ i ] : largest;
+		}
+		assert( largest > 0 );
+
+		int exponent = 0;
+		std::frexp( largest, &exponent ); // largest < 2^exponent
+		for( size_t i = 0; i < count; ++i )
+			masses[ i ] = (uint64_t) std::ldexp( weights[ i ], 32 - exponent );
+	}
+	else
+	{
+		static_assert( std::is_integral<Weight>::value && sizeof( Weight ) <= 4, "Weights must be floating point, or integers of up to 32 bits" );
+		for( size_t i = 0; i < count; ++i )
+		{
+			assert( weights[ i ] >= 0 );
+			masses[ i ] = (uint64_t) weights[ i ];
+		}
+	}
+
+	uint64_t total = 0;
+	for( size_t i = 0; i < count; ++i )
+		total += masses[ i ];
+	assert( total > 0 );
+	for( size_t i = 0; i < count; ++i )
+		masses[ i ] *= count;
+
+	m_thresholds.assign( count, 0 );
+	m_aliases.assign( count, 0 );
+
+	std::vector<uint32_t> underfull;
+	std::vector<uint32_t> overfull;
+	for( size_t i = 0; i < count; ++i )
+		( masses[ i ] < total ? underfull : overfull ).push_back( (uint32_t) i );
+
+	// Top up every underfull column with mass from an overfull one
+	while( !underfull.empty() && !overfull.empty() )
+	{
+		const uint32_t lighter = underfull.back();
+		underfull.pop_back();
+		const uint32_t heavier = overfull.back();
+
+		m_thresholds[ lighter ] = SquirrelDistributions::ScaleToQ32( masses[ lighter ], total );
+		m_aliases[ lighter ] = heavier;
+		masses[ heavier ] -= total - masses[ lighter ];
+		if( masses[ heavier ] < total )
+		{
+			overfull.pop_back();
+			underfull.push_back( heavier );
+		}
+	}
+
+	// The arithmetic is exact, so whatever is left holds exactly one column's worth
+	assert( underfull.empty() );
+	for( const uint32_t full : overfull )
+		m_aliases[ full ] = full;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+inline unsigned int AliasTable::Pick( unsigned int columnNoise, unsigned int acceptNoise ) const
+{
+	const uint32_t column = (uint32_t)( ( (uint64_t) columnNoise * m_thresholds.size() ) >> 32 );
+	return ( acceptNoise < m_thresholds[ column ] ) ? column : m_aliases[ column ];
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Draw i uses the raw noise at positions 2i and 2i+1.
+//
+inline unsigned int AliasTable::Draw( int index, unsigned int seed ) const
+{
+	assert( !m_thresholds.empty() );
+	const unsigned int aliasSeed = seed ^ SquirrelDistributions::ALIAS_SEED_NOISE;
+	const unsigned int position = 2u * (unsigned int) index;
+	return Pick( SquirrelNoise5( (int) position, aliasSeed ), SquirrelNoise5( (int)( position + 1 ), aliasSeed ) );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+inline void AliasTable::DrawRange( int start, size_t count, unsigned int seed, unsigned int* out ) const
+{
+	assert( !m_thresholds.empty() );
+	constexpr size_t CHUNK_SIZE = SquirrelNoise5Simd::MAPPING_CHUNK_SIZE / 2;
+	const unsigned int aliasSeed = seed ^ SquirrelDistributions::ALIAS_SEED_NOISE;
+
+	unsigned int raw[ 2 * CHUNK_SIZE ];
+	for( size_t done = 0; done < count; done += CHUNK_SIZE )
+	{
+		const size_t chunkCount = ( count - done < CHUNK_SIZE ) ? count - done : CHUNK_SIZE;
+		Get1dNoiseUintRange( (int)( 2u * ( (unsigned int) start + (unsigned int) done ) ), 2 * chunkCount, aliasSeed, raw );
+		for( size_t i = 0; i < chunkCount; ++i )
+			out[ done + i ] = Pick( raw[ 2 * i ], raw[ 2 * i + 1 ] );
+	}
+}
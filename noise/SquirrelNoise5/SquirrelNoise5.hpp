@@ -60,6 +60,24 @@ constexpr float Get2dNoiseNegOneToOne( int indexX, int indexY, unsigned int seed
 constexpr float Get3dNoiseNegOneToOne( int indexX, int indexY, int indexZ, unsigned int seed=0 );
 constexpr float Get4dNoiseNegOneToOne( int indexX, int indexY, int indexZ, int indexT, unsigned int seed=0 );
 
+//-----------------------------------------------------------------------------------------------
+// Same functions, mapped to floats using only float math (no double round-trip).
+//	These keep the top 24 (or 23 + sign) bits of noise, which is all a float can hold anyway,
+//	and are cheap enough to run at full SIMD width.  They differ from the functions above only
+//	at the ends of the range:
+//		Get*dNoiseZeroToOneFast		returns [0,1) in steps of 2^-24 -- never exactly 1.0
+//		Get*dNoiseNegOneToOneFast	returns [-1,1) in steps of 2^-23 -- -1.0 is possible, 1.0 is not
+//	Everywhere else they are within one step of the regular results.
+//
+constexpr float Get1dNoiseZeroToOneFast( int index, unsigned int seed=0 );
+constexpr float Get2dNoiseZeroToOneFast( int indexX, int indexY, unsigned int seed=0 );
+constexpr float Get3dNoiseZeroToOneFast( int indexX, int indexY, int indexZ, unsigned int seed=0 );
+constexpr float Get4dNoiseZeroToOneFast( int indexX, int indexY, int indexZ, int indexT, unsigned int seed=0 );
+constexpr float Get1dNoiseNegOneToOneFast( int index, unsigned int seed=0 );
+constexpr float Get2dNoiseNegOneToOneFast( int indexX, int indexY, unsigned int seed=0 );
+constexpr float Get3dNoiseNegOneToOneFast( int indexX, int indexY, int indexZ, unsigned int seed=0 );
+constexpr float Get4dNoiseNegOneToOneFast( int indexX, int indexY, int indexZ, int indexT, unsigned int seed=0 );
+
 
 /////////////////////////////////////////////////////////////////////////////////////////////////
 // Inline function definitions below
@@ -117,25 +135,25 @@ constexpr unsigned int Get1dNoiseUint( int positionX, unsigned int seed )
 //-----------------------------------------------------------------------------------------------
 constexpr unsigned int Get2dNoiseUint( int indexX, int indexY, unsigned int seed )
 {
-	constexpr int PRIME_NUMBER = 198491317; // Large prime number with non-boring bits
-	return SquirrelNoise5( indexX + (PRIME_NUMBER * indexY), seed );
+	constexpr unsigned int PRIME_NUMBER = 198491317; // Large prime number with non-boring bits
+	return SquirrelNoise5( (int)( (unsigned int) indexX + (PRIME_NUMBER * (unsigned int) indexY) ), seed );
 }
 
 //-----------------------------------------------------------------------------------------------
 constexpr unsigned int Get3dNoiseUint( int indexX, int indexY, int indexZ, unsigned int seed )
 {
-	constexpr int PRIME1 = 198491317; // Large prime number with non-boring bits
-	constexpr int PRIME2 = 6542989; // Large prime number with distinct and non-boring bits
-	return SquirrelNoise5( indexX + (PRIME1 * indexY) + (PRIME2 * indexZ), seed );
+	constexpr unsigned int PRIME1 = 198491317; // Large prime number with non-boring bits
+	constexpr unsigned int PRIME2 = 6542989; // Large prime number with distinct and non-boring bits
+	return SquirrelNoise5( (int)( (unsigned int) indexX + (PRIME1 * (unsigned int) indexY) + (PRIME2 * (unsigned int) indexZ) ), seed );
 }
 
 //-----------------------------------------------------------------------------------------------
 constexpr unsigned int Get4dNoiseUint( int indexX, int indexY, int indexZ, int indexT, unsigned int seed )
 {
-	constexpr int PRIME1 = 198491317; // Large prime number with non-boring bits
-	constexpr int PRIME2 = 6542989; // Large prime number with distinct and non-boring bits
-	constexpr int PRIME3 = 357239; // Large prime number with distinct and non-boring bits
-	return SquirrelNoise5( indexX + (PRIME1 * indexY) + (PRIME2 * indexZ) + (PRIME3 * indexT), seed );
+	constexpr unsigned int PRIME1 = 198491317; // Large prime number with non-boring bits
+	constexpr unsigned int PRIME2 = 6542989; // Large prime number with distinct and non-boring bits
+	constexpr unsigned int PRIME3 = 357239; // Large prime number with distinct and non-boring bits
+	return SquirrelNoise5( (int)( (unsigned int) indexX + (PRIME1 * (unsigned int) indexY) + (PRIME2 * (unsigned int) indexZ) + (PRIME3 * (unsigned int) indexT) ), seed );
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -198,4 +216,58 @@ constexpr float Get4dNoiseNegOneToOne( int indexX, int indexY, int indexZ, int i
 	return (float)( ONE_OVER_MAX_INT * (double) (int) Get4dNoiseUint( indexX, indexY, indexZ, indexT, seed ) );
 }
 
+//-----------------------------------------------------------------------------------------------
+constexpr float Get1dNoiseZeroToOneFast( int index, unsigned int seed )
+{
+	constexpr float ONE_OVER_2_TO_24 = (1.0f / 16777216.0f);
+	return ONE_OVER_2_TO_24 * (float) (int)( SquirrelNoise5( index, seed ) >> 8 );
+}
 
+//-----------------------------------------------------------------------------------------------
+constexpr float Get2dNoiseZeroToOneFast( int indexX, int indexY, unsigned int seed )
+{
+	constexpr float ONE_OVER_2_TO_24 = (1.0f / 16777216.0f);
+	return ONE_OVER_2_TO_24 * (float) (int)( Get2dNoiseUint( indexX, indexY, seed ) >> 8 );
+}
+
+//-----------------------------------------------------------------------------------------------
+constexpr float Get3dNoiseZeroToOneFast( int indexX, int indexY, int indexZ, unsigned int seed )
+{
+	constexpr float ONE_OVER_2_TO_24 = (1.0f / 16777216.0f);
+	return ONE_OVER_2_TO_24 * (float) (int)( Get3dNoiseUint( indexX, indexY, indexZ, seed ) >> 8 );
+}
+
+//-----------------------------------------------------------------------------------------------
+constexpr float Get4dNoiseZeroToOneFast( int indexX, int indexY, int indexZ, int indexT, unsigned int seed )
+{
+	constexpr float ONE_OVER_2_TO_24 = (1.0f / 16777216.0f);
+	return ONE_OVER_2_TO_24 * (float) (int)( Get4dNoiseUint( indexX, indexY, indexZ, indexT, seed ) >> 8 );
+}
+
+//-----------------------------------------------------------------------------------------------
+constexpr float Get1dNoiseNegOneToOneFast( int index, unsigned int seed )
+{
+	constexpr float ONE_OVER_2_TO_23 = (1.0f / 8388608.0f);
+	return ONE_OVER_2_TO_23 * (float)( (int) SquirrelNoise5( index, seed ) >> 8 );
+}
+
+//-----------------------------------------------------------------------------------------------
+constexpr float Get2dNoiseNegOneToOneFast( int indexX, int indexY, unsigned int seed )
+{
+	constexpr float ONE_OVER_2_TO_23 = (1.0f / 8388608.0f);
+	return ONE_OVER_2_TO_23 * (float)( (int) Get2dNoiseUint( indexX, indexY, seed ) >> 8 );
+}
+
+//-----------------------------------------------------------------------------------------------
+constexpr float Get3dNoiseNegOneToOneFast( int indexX, int indexY, int indexZ, unsigned int seed )
+{
+	constexpr float ONE_OVER_2_TO_23 = (1.0f / 8388608.0f);
+	return ONE_OVER_2_TO_23 * (float)( (int) Get3dNoiseUint( indexX, indexY, indexZ, seed ) >> 8 );
+}
+
+//-----------------------------------------------------------------------------------------------
+constexpr float Get4dNoiseNegOneToOneFast( int indexX, int indexY, int indexZ, int indexT, unsigned int seed )
+{
+	constexpr float ONE_OVER_2_TO_23 = (1.0f / 8388608.0f);
+	return ONE_OVER_2_TO_23 * (float)( (int) Get4dNoiseUint( indexX, indexY, indexZ, indexT, seed ) >> 8 );
+}
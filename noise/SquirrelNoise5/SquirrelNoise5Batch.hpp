@@ -0,0 +1,513 @@
+//-----------------------------------------------------------------------------------------------
+// SquirrelNoise5Batch.hpp
+//
+#pragma once
+
+#include <cstddef>
+#include "SquirrelNoise5.hpp"
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+// SquirrelNoise5Batch - Array / range entry points for SquirrelNoise5
+//
+// Same raw noise as Get1dNoiseUint(), but computed for many indices per call using explicit
+//	SIMD kernels for the multiply/xor-shift chain, instead of relying on the compiler to
+//	auto-vectorize a loop of scalar calls.  Output is bit-exact with the scalar functions.
+//
+// The kernel is picked at compile time from the target instruction set:
+//	AVX-512F (16 lanes), AVX2 (8 lanes), SSE4.1 or NEON (4 lanes), or plain scalar code.
+//	Every kernel processes two registers per iteration to hide the multiply latency, so the
+//	SSE4.1/NEON paths effectively run 8 lanes at a time.
+//
+// Define SQUIRRELNOISE5_NO_SIMD before including this header to force the scalar kernel.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#if !defined( SQUIRRELNOISE5_NO_SIMD )
+	#if defined( __AVX512F__ )
+		#define SQUIRRELNOISE5_SIMD_AVX512 1
+		#include <immintrin.h>
+	#elif defined( __AVX2__ )
+		#define SQUIRRELNOISE5_SIMD_AVX2 1
+		#include <immintrin.h>
+	#elif defined( __SSE4_1__ )
+		#define SQUIRRELNOISE5_SIMD_SSE41 1
+		#include <smmintrin.h>
+	#elif defined( __ARM_NEON ) || defined( _M_ARM64 )
+		#define SQUIRRELNOISE5_SIMD_NEON 1
+		#include <arm_neon.h>
+	#endif
+#endif
+
+
+//-----------------------------------------------------------------------------------------------
+// Raw noise for an arbitrary list of indices: out[i] = Get1dNoiseUint( indices[i], seed ).
+//
+inline void Get1dNoiseUintBatch( const int* indices, unsigned int* out, size_t count, unsigned int seed=0 );
+
+//-----------------------------------------------------------------------------------------------
+// Raw noise for a contiguous range of indices: out[i] = Get1dNoiseUint( start + i, seed ).
+//	Indices wrap around like regular (two's complement) int arithmetic.
+//
+inline void Get1dNoiseUintRange( int start, size_t count, unsigned int seed, unsigned int* out );
+
+//-----------------------------------------------------------------------------------------------
+// Same range function, mapped to floats in [0,1] and [-1,1] (same mapping as the scalar versions).
+//
+inline void Get1dNoiseZeroToOneRange( int start, size_t count, unsigned int seed, float* out );
+inline void Get1dNoiseNegOneToOneRange( int start, size_t count, unsigned int seed, float* out );
+
+//-----------------------------------------------------------------------------------------------
+// Same range function, using the float-only mappings of Get1dNoiseZeroToOneFast() and
+//	Get1dNoiseNegOneToOneFast() (see SquirrelNoise5.hpp for how they differ at the range ends).
+//	These never leave SIMD registers, so they run at the full width of the batch kernel.
+//
+inline void Get1dNoiseZeroToOneFastRange( int start, size_t count, unsigned int seed, float* out );
+inline void Get1dNoiseNegOneToOneFastRange( int start, size_t count, unsigned int seed, float* out );
+
+//-----------------------------------------------------------------------------------------------
+// Grid fills: out[ y*stride + x ] = Get2dNoiseUint( x0 + x, y0 + y, seed ), and likewise
+//	out[ z*sliceStride + y*rowStride + x ] = Get3dNoiseUint( x0 + x, y0 + y, z0 + z, seed ).
+//	Strides are given in elements, so the output may be a window into a larger buffer.
+//
+// The row (PRIME1 * y) and plane (PRIME2 * z) terms are computed once per row/plane, and every
+//	row is then generated with the batch kernel above.
+//
+inline void Fill2dNoiseUint( int x0, int y0, size_t width, size_t height, size_t stride, unsigned int seed, unsigned int* out );
+inline void Fill3dNoiseUint( int x0, int y0, int z0, size_t width, size_t height, size_t depth, size_t rowStride, size_t sliceStride, unsigned int seed, unsigned int* out );
+
+//-----------------------------------------------------------------------------------------------
+// Same grid fills, mapped to floats in [0,1] for convenience.
+//
+inline void Fill2dNoiseZeroToOne( int x0, int y0, size_t width, size_t height, size_t stride, unsigned int seed, float* out );
+inline void Fill3dNoiseZeroToOne( int x0, int y0, int z0, size_t width, size_t height, size_t depth, size_t rowStride, size_t sliceStride, unsigned int seed, float* out );
+
+//-----------------------------------------------------------------------------------------------
+// Same grid fills, mapped to floats in [-1,1] for convenience.
+//
+inline void Fill2dNoiseNegOneToOne( int x0, int y0, size_t width, size_t height, size_t stride, unsigned int seed, float* out );
+inline void Fill3dNoiseNegOneToOne( int x0, int y0, int z0, size_t width, size_t height, size_t depth, size_t rowStride, size_t sliceStride, unsigned int seed, float* out );
+
+//-----------------------------------------------------------------------------------------------
+// Same grid fills, using the float-only [0,1) and [-1,1) mappings.
+//
+inline void Fill2dNoiseZeroToOneFast( int x0, int y0, size_t width, size_t height, size_t stride, unsigned int seed, float* out );
+inline void Fill3dNoiseZeroToOneFast( int x0, int y0, int z0, size_t width, size_t height, size_t depth, size_t rowStride, size_t sliceStride, unsigned int seed, float* out );
+inline void Fill2dNoiseNegOneToOneFast( int x0, int y0, size_t width, size_t height, size_t stride, unsigned int seed, float* out );
+inline void Fill3dNoiseNegOneToOneFast( int x0, int y0, int z0, size_t width, size_t height, size_t depth, size_t rowStride, size_t sliceStride, unsigned int seed, float* out );
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+// Inline function definitions below
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace SquirrelNoise5Simd
+{
+	//-------------------------------------------------------------------------------------------
+	// Thin wrappers around the operations used by the kernels, one per instruction set.
+	//	All of them expose the same interface, so the kernel itself is only written once.
+	//
+#if defined( SQUIRRELNOISE5_SIMD_AVX512 )
+	struct Backend
+	{
+		static constexpr size_t LANES = 16;
+		using U32 = __m512i;
+
+		static U32 Set1( unsigned int value )					{ return _mm512_set1_epi32( (int) value ); }
+		static U32 Iota()										{ return _mm512_setr_epi32( 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 ); }
+		static U32 Load( const unsigned int* source )			{ return _mm512_loadu_si512( source ); }
+		static void Store( unsigned int* destination, U32 a )	{ _mm512_storeu_si512( destination, a ); }
+		static U32 Add( U32 a, U32 b )							{ return _mm512_add_epi32( a, b ); }
+		static U32 Mul( U32 a, U32 b )							{ return _mm512_mullo_epi32( a, b ); }
+		static U32 Xor( U32 a, U32 b )							{ return _mm512_xor_si512( a, b ); }
+		template<int SHIFT> static U32 ShiftRight( U32 a )		{ return _mm512_srli_epi32( a, SHIFT ); }
+		template<int SHIFT> static U32 ShiftRightSigned( U32 a )	{ return _mm512_srai_epi32( a, SHIFT ); }
+		static U32 And( U32 a, U32 b )							{ return _mm512_and_si512( a, b ); }
+		static U32 ShiftRightBy( U32 a, int shift )				{ return _mm512_srl_epi32( a, _mm_cvtsi32_si128( shift ) ); }
+		static U32 ShiftLeftBy( U32 a, int shift )				{ return _mm512_sll_epi32( a, _mm_cvtsi32_si128( shift ) ); }
+		static U32 Min( U32 a, U32 b )							{ return _mm512_min_epu32( a, b ); }
+		static U32 SelectIfEqual( U32 a, U32 b, U32 ifEqual, U32 otherwise )	{ return _mm512_mask_blend_epi32( _mm512_cmpeq_epi32_mask( a, b ), otherwise, ifEqual ); }
+		static bool AllEqual( U32 a, U32 b )					{ return _mm512_cmpeq_epi32_mask( a, b ) == 0xFFFF; }
+
+		using F32 = __m512;
+		static F32 Set1F( float value )							{ return _mm512_set1_ps( value ); }
+		static F32 ToFloat( U32 a )								{ return _mm512_cvtepi32_ps( a ); }
+		static F32 MulF( F32 a, F32 b )							{ return _mm512_mul_ps( a, b ); }
+		static void StoreF( float* destination, F32 a )			{ _mm512_storeu_ps( destination, a ); }
+	};
+#elif defined( SQUIRRELNOISE5_SIMD_AVX2 )
+	struct Backend
+	{
+		static constexpr size_t LANES = 8;
+		using U32 = __m256i;
+
+		static U32 Set1( unsigned int value )					{ return _mm256_set1_epi32( (int) value ); }
+		static U32 Iota()										{ return _mm256_setr_epi32( 0, 1, 2, 3, 4, 5, 6, 7 ); }
+		static U32 Load( const unsigned int* source )			{ return _mm256_loadu_si256( (const __m256i*) source ); }
+		static void Store( unsigned int* destination, U32 a )	{ _mm256_storeu_si256( (__m256i*) destination, a ); }
+		static U32 Add( U32 a, U32 b )							{ return _mm256_add_epi32( a, b ); }
+		static U32 Mul( U32 a, U32 b )							{ return _mm256_mullo_epi32( a, b ); }
+		static U32 Xor( U32 a, U32 b )							{ return _mm256_xor_si256( a, b ); }
+		template<int SHIFT> static U32 ShiftRight( U32 a )		{ return _mm256_srli_epi32( a, SHIFT ); }
+		template<int SHIFT> static U32 ShiftRightSigned( U32 a )	{ return _mm256_srai_epi32( a, SHIFT ); }
+		static U32 And( U32 a, U32 b )							{ return _mm256_and_si256( a, b ); }
+		static U32 ShiftRightBy( U32 a, int shift )				{ return _mm256_srl_epi32( a, _mm_cvtsi32_si128( shift ) ); }
+		static U32 ShiftLeftBy( U32 a, int shift )				{ return _mm256_sll_epi32( a, _mm_cvtsi32_si128( shift ) ); }
+		static U32 Min( U32 a, U32 b )							{ return _mm256_min_epu32( a, b ); }
+		static U32 SelectIfEqual( U32 a, U32 b, U32 ifEqual, U32 otherwise )	{ return _mm256_blendv_epi8( otherwise, ifEqual, _mm256_cmpeq_epi32( a, b ) ); }
+		static bool AllEqual( U32 a, U32 b )					{ return _mm256_movemask_epi8( _mm256_cmpeq_epi32( a, b ) ) == -1; }
+
+		using F32 = __m256;
+		static F32 Set1F( float value )							{ return _mm256_set1_ps( value ); }
+		static F32 ToFloat( U32 a )								{ return _mm256_cvtepi32_ps( a ); }
+		static F32 MulF( F32 a, F32 b )							{ return _mm256_mul_ps( a, b ); }
+		static void StoreF( float* destination, F32 a )			{ _mm256_storeu_ps( destination, a ); }
+	};
+#elif defined( SQUIRRELNOISE5_SIMD_SSE41 )
+	struct Backend
+	{
+		static constexpr size_t LANES = 4;
+		using U32 = __m128i;
+
+		static U32 Set1( unsigned int value )					{ return _mm_set1_epi32( (int) value ); }
+		static U32 Iota()										{ return _mm_setr_epi32( 0, 1, 2, 3 ); }
+		static U32 Load( const unsigned int* source )			{ return _mm_loadu_si128( (const __m128i*) source ); }
+		static void Store( unsigned int* destination, U32 a )	{ _mm_storeu_si128( (__m128i*) destination, a ); }
+		static U32 Add( U32 a, U32 b )							{ return _mm_add_epi32( a, b ); }
+		static U32 Mul( U32 a, U32 b )							{ return _mm_mullo_epi32( a, b ); }
+		static U32 Xor( U32 a, U32 b )							{ return _mm_xor_si128( a, b ); }
+		template<int SHIFT> static U32 ShiftRight( U32 a )		{ return _mm_srli_epi32( a, SHIFT ); }
+		template<int SHIFT> static U32 ShiftRightSigned( U32 a )	{ return _mm_srai_epi32( a, SHIFT ); }
+		static U32 And( U32 a, U32 b )							{ return _mm_and_si128( a, b ); }
+		static U32 ShiftRightBy( U32 a, int shift )				{ return _mm_srl_epi32( a, _mm_cvtsi32_si128( shift ) ); }
+		static U32 ShiftLeftBy( U32 a, int shift )				{ return _mm_sll_epi32( a, _mm_cvtsi32_si128( shift ) ); }
+		static U32 Min( U32 a, U32 b )							{ return _mm_min_epu32( a, b ); }
+		static U32 SelectIfEqual( U32 a, U32 b, U32 ifEqual, U32 otherwise )	{ return _mm_blendv_epi8( otherwise, ifEqual, _mm_cmpeq_epi32( a, b ) ); }
+		static bool AllEqual( U32 a, U32 b )					{ return _mm_movemask_epi8( _mm_cmpeq_epi32( a, b ) ) == 0xFFFF; }
+
+		using F32 = __m128;
+		static F32 Set1F( float value )							{ return _mm_set1_ps( value ); }
+		static F32 ToFloat( U32 a )								{ return _mm_cvtepi32_ps( a ); }
+		static F32 MulF( F32 a, F32 b )							{ return _mm_mul_ps( a, b ); }
+		static void StoreF( float* destination, F32 a )			{ _mm_storeu_ps( destination, a ); }
+	};
+#elif defined( SQUIRRELNOISE5_SIMD_NEON )
+	struct Backend
+	{
+		static constexpr size_t LANES = 4;
+		using U32 = uint32x4_t;
+
+		static U32 Set1( unsigned int value )					{ return vdupq_n_u32( value ); }
+		static U32 Iota()										{ static const uint32_t IOTA[ 4 ] = { 0, 1, 2, 3 }; return vld1q_u32( IOTA ); }
+		static U32 Load( const unsigned int* source )			{ return vld1q_u32( (const uint32_t*) source ); }
+		static void Store( unsigned int* destination, U32 a )	{ vst1q_u32( (uint32_t*) destination, a ); }
+		static U32 Add( U32 a, U32 b )							{ return vaddq_u32( a, b ); }
+		static U32 Mul( U32 a, U32 b )							{ return vmulq_u32( a, b ); }
+		static U32 Xor( U32 a, U32 b )							{ return veorq_u32( a, b ); }
+		template<int SHIFT> static U32 ShiftRight( U32 a )		{ return vshrq_n_u32( a, SHIFT ); }
+		template<int SHIFT> static U32 ShiftRightSigned( U32 a )	{ return vreinterpretq_u32_s32( vshrq_n_s32( vreinterpretq_s32_u32( a ), SHIFT ) ); }
+		static U32 And( U32 a, U32 b )							{ return vandq_u32( a, b ); }
+		static U32 ShiftRightBy( U32 a, int shift )				{ return vshlq_u32( a, vdupq_n_s32( -shift ) ); }
+		static U32 ShiftLeftBy( U32 a, int shift )				{ return vshlq_u32( a, vdupq_n_s32( shift ) ); }
+		static U32 Min( U32 a, U32 b )							{ return vminq_u32( a, b ); }
+		static U32 SelectIfEqual( U32 a, U32 b, U32 ifEqual, U32 otherwise )	{ return vbslq_u32( vceqq_u32( a, b ), ifEqual, otherwise ); }
+		static bool AllEqual( U32 a, U32 b )
+		{
+			const uint32x4_t equal = vceqq_u32( a, b );
+			const uint32x2_t halves = vand_u32( vget_low_u32( equal ), vget_high_u32( equal ) );
+			return ( vget_lane_u32( halves, 0 ) & vget_lane_u32( halves, 1 ) ) != 0;
+		}
+
+		using F32 = float32x4_t;
+		static F32 Set1F( float value )							{ return vdupq_n_f32( value ); }
+		static F32 ToFloat( U32 a )								{ return vcvtq_f32_s32( vreinterpretq_s32_u32( a ) ); }
+		static F32 MulF( F32 a, F32 b )							{ return vmulq_f32( a, b ); }
+		static void StoreF( float* destination, F32 a )			{ vst1q_f32( destination, a ); }
+	};
+#else
+	struct Backend
+	{
+		static constexpr size_t LANES = 1;
+		using U32 = unsigned int;
+
+		static U32 Set1( unsigned int value )					{ return value; }
+		static U32 Iota()										{ return 0; }
+		static U32 Load( const unsigned int* source )			{ return *source; }
+		static void Store( unsigned int* destination, U32 a )	{ *destination = a; }
+		static U32 Add( U32 a, U32 b )							{ return a + b; }
+		static U32 Mul( U32 a, U32 b )							{ return a * b; }
+		static U32 Xor( U32 a, U32 b )							{ return a ^ b; }
+		template<int SHIFT> static U32 ShiftRight( U32 a )		{ return a >> SHIFT; }
+		template<int SHIFT> static U32 ShiftRightSigned( U32 a )	{ return (U32)( (int) a >> SHIFT ); }
+		static U32 And( U32 a, U32 b )							{ return a & b; }
+		static U32 ShiftRightBy( U32 a, int shift )				{ return a >> shift; }
+		static U32 ShiftLeftBy( U32 a, int shift )				{ return a << shift; }
+		static U32 Min( U32 a, U32 b )							{ return ( a < b ) ? a : b; }
+		static U32 SelectIfEqual( U32 a, U32 b, U32 ifEqual, U32 otherwise )	{ return ( a == b ) ? ifEqual : otherwise; }
+		static bool AllEqual( U32 a, U32 b )					{ return a == b; }
+
+		using F32 = float;
+		static F32 Set1F( float value )							{ return value; }
+		static F32 ToFloat( U32 a )								{ return (float) (int) a; }
+		static F32 MulF( F32 a, F32 b )							{ return a * b; }
+		static void StoreF( float* destination, F32 a )			{ *destination = a; }
+	};
+#endif
+
+	//-------------------------------------------------------------------------------------------
+	// SquirrelNoise5() applied to every lane.  Must be kept in sync with the scalar version!
+	//
+	template<typename B>
+	inline typename B::U32 SquirrelNoise5Lanes( typename B::U32 mangledBits, typename B::U32 seed )
+	{
+		mangledBits = B::Mul( mangledBits, B::Set1( 0xd2a80a3f ) );
+		mangledBits = B::Add( mangledBits, seed );
+		mangledBits = B::Xor( mangledBits, B::template ShiftRight<9>( mangledBits ) );
+		mangledBits = B::Add( mangledBits, B::Set1( 0xa884f197 ) );
+		mangledBits = B::Xor( mangledBits, B::template ShiftRight<11>( mangledBits ) );
+		mangledBits = B::Mul( mangledBits, B::Set1( 0x6C736F4B ) );
+		mangledBits = B::Xor( mangledBits, B::template ShiftRight<13>( mangledBits ) );
+		mangledBits = B::Add( mangledBits, B::Set1( 0xB79F3ABB ) );
+		mangledBits = B::Xor( mangledBits, B::template ShiftRight<15>( mangledBits ) );
+		mangledBits = B::Mul( mangledBits, B::Set1( 0x1b56c4f5 ) );
+		mangledBits = B::Xor( mangledBits, B::template ShiftRight<17>( mangledBits ) );
+		return mangledBits;
+	}
+
+	//-------------------------------------------------------------------------------------------
+	// Computes noise for positions start, start+1, ... and hands every register of results to
+	//	storeLanes( offset, noise ), finishing the tail with storeScalar( offset, noise ).
+	//
+	template<typename B, typename StoreLanes, typename StoreScalar>
+	inline void RangeKernel( int start, size_t count, unsigned int seed, StoreLanes storeLanes, StoreScalar storeScalar )
+	{
+		const typename B::U32 seedLanes = B::Set1( seed );
+		const typename B::U32 step = B::Set1( (unsigned int) B::LANES );
+		typename B::U32 positions = B::Add( B::Set1( (unsigned int) start ), B::Iota() );
+
+		const size_t vectorCount = count - ( count % ( 2 * B::LANES ) );
+
+		size_t i = 0;
+		for( ; i < vectorCount; i += 2 * B::LANES )
+		{
+			const typename B::U32 nextPositions = B::Add( positions, step );
+			const typename B::U32 noise0 = SquirrelNoise5Lanes<B>( positions, seedLanes );
+			const typename B::U32 noise1 = SquirrelNoise5Lanes<B>( nextPositions, seedLanes );
+			storeLanes( i, noise0 );
+			storeLanes( i + B::LANES, noise1 );
+			positions = B::Add( nextPositions, step );
+		}
+
+		for( ; i < count; ++i )
+			storeScalar( i, SquirrelNoise5( (int) ( (unsigned int) start + (unsigned int) i ), seed ) );
+	}
+
+	//-------------------------------------------------------------------------------------------
+	// Float-only mappings, matching Get1dNoiseZeroToOneFast() / Get1dNoiseNegOneToOneFast().
+	//
+	template<typename B>
+	inline typename B::F32 ZeroToOneFastLanes( typename B::U32 noise )
+	{
+		return B::MulF( B::Set1F( 1.0f / 16777216.0f ), B::ToFloat( B::template ShiftRight<8>( noise ) ) );
+	}
+
+	template<typename B>
+	inline typename B::F32 NegOneToOneFastLanes( typename B::U32 noise )
+	{
+		return B::MulF( B::Set1F( 1.0f / 8388608.0f ), B::ToFloat( B::template ShiftRightSigned<8>( noise ) ) );
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+inline void Get1dNoiseUintBatch( const int* indices, unsigned int* out, size_t count, unsigned int seed )
+{
+	using B = SquirrelNoise5Simd::Backend;
+	const unsigned int* positions = reinterpret_cast<const unsigned int*>( indices );
+	const B::U32 seedLanes = B::Set1( seed );
+
+	const size_t vectorCount = count - ( count % ( 2 * B::LANES ) );
+
+	size_t i = 0;
+	for( ; i < vectorCount; i += 2 * B::LANES )
+	{
+		const B::U32 noise0 = SquirrelNoise5Simd::SquirrelNoise5Lanes<B>( B::Load( positions + i ), seedLanes );
+		const B::U32 noise1 = SquirrelNoise5Simd::SquirrelNoise5Lanes<B>( B::Load( positions + i + B::LANES ), seedLanes );
+		B::Store( out + i, noise0 );
+		B::Store( out + i + B::LANES, noise1 );
+	}
+
+	for( ; i < count; ++i )
+		out[ i ] = SquirrelNoise5( indices[ i ], seed );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+inline void Get1dNoiseUintRange( int start, size_t count, unsigned int seed, unsigned int* out )
+{
+	using B = SquirrelNoise5Simd::Backend;
+	SquirrelNoise5Simd::RangeKernel<B>( start, count, seed,
+		[ out ]( size_t offset, B::U32 noise ) { B::Store( out + offset, noise ); },
+		[ out ]( size_t offset, unsigned int noise ) { out[ offset ] = noise; } );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+namespace SquirrelNoise5Simd
+{
+	// Same primes used by Get2dNoiseUint() / Get3dNoiseUint() / Get4dNoiseUint()
+	constexpr unsigned int PRIME1 = 198491317;
+	constexpr unsigned int PRIME2 = 6542989;
+	constexpr unsigned int PRIME3 = 357239;
+
+	// Number of raw samples generated at a time before being mapped to floats (lives on the stack)
+	constexpr size_t MAPPING_CHUNK_SIZE = 256;
+
+	//-------------------------------------------------------------------------------------------
+	template<typename MapFunc>
+	inline void MapRange( int start, size_t count, unsigned int seed, float* out, MapFunc mapToFloat )
+	{
+		unsigned int chunk[ MAPPING_CHUNK_SIZE ];
+		for( size_t i = 0; i < count; i += MAPPING_CHUNK_SIZE )
+		{
+			const size_t chunkCount = ( count - i < MAPPING_CHUNK_SIZE ) ? count - i : MAPPING_CHUNK_SIZE;
+			Get1dNoiseUintRange( (int) ( (unsigned int) start + (unsigned int) i ), chunkCount, seed, chunk );
+			for( size_t j = 0; j < chunkCount; ++j )
+				out[ i + j ] = mapToFloat( chunk[ j ] );
+		}
+	}
+
+	//-------------------------------------------------------------------------------------------
+	// Walks the rows of a 2D/3D grid, handing each one to rowFunc( start, width, seed, rowOut ).
+	//
+	template<typename T, typename RowFunc>
+	inline void Fill2d( int x0, int y0, size_t width, size_t height, size_t stride, unsigned int seed, T* out, RowFunc rowFunc )
+	{
+		for( size_t y = 0; y < height; ++y )
+		{
+			const unsigned int rowTerm = PRIME1 * ( (unsigned int) y0 + (unsigned int) y );
+			rowFunc( (int) ( (unsigned int) x0 + rowTerm ), width, seed, out + y * stride );
+		}
+	}
+
+	template<typename T, typename RowFunc>
+	inline void Fill3d( int x0, int y0, int z0, size_t width, size_t height, size_t depth, size_t rowStride, size_t sliceStride, unsigned int seed, T* out, RowFunc rowFunc )
+	{
+		for( size_t z = 0; z < depth; ++z )
+		{
+			const unsigned int planeTerm = (unsigned int) x0 + PRIME2 * ( (unsigned int) z0 + (unsigned int) z );
+			T* sliceOut = out + z * sliceStride;
+			for( size_t y = 0; y < height; ++y )
+			{
+				const unsigned int rowTerm = PRIME1 * ( (unsigned int) y0 + (unsigned int) y );
+				rowFunc( (int) ( planeTerm + rowTerm ), width, seed, sliceOut + y * rowStride );
+			}
+		}
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+inline void Get1dNoiseZeroToOneRange( int start, size_t count, unsigned int seed, float* out )
+{
+	constexpr double ONE_OVER_MAX_UINT = (1.0 / (double) 0xFFFFFFFF);
+	SquirrelNoise5Simd::MapRange( start, count, seed, out, []( unsigned int bits ) { return (float)( ONE_OVER_MAX_UINT * (double) bits ); } );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+inline void Get1dNoiseNegOneToOneRange( int start, size_t count, unsigned int seed, float* out )
+{
+	constexpr double ONE_OVER_MAX_INT = (1.0 / (double) 0x7FFFFFFF);
+	SquirrelNoise5Simd::MapRange( start, count, seed, out, []( unsigned int bits ) { return (float)( ONE_OVER_MAX_INT * (double) (int) bits ); } );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+inline void Fill2dNoiseUint( int x0, int y0, size_t width, size_t height, size_t stride, unsigned int seed, unsigned int* out )
+{
+	SquirrelNoise5Simd::Fill2d( x0, y0, width, height, stride, seed, out, Get1dNoiseUintRange );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+inline void Fill3dNoiseUint( int x0, int y0, int z0, size_t width, size_t height, size_t depth, size_t rowStride, size_t sliceStride, unsigned int seed, unsigned int* out )
+{
+	SquirrelNoise5Simd::Fill3d( x0, y0, z0, width, height, depth, rowStride, sliceStride, seed, out, Get1dNoiseUintRange );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+inline void Fill2dNoiseZeroToOne( int x0, int y0, size_t width, size_t height, size_t stride, unsigned int seed, float* out )
+{
+	SquirrelNoise5Simd::Fill2d( x0, y0, width, height, stride, seed, out, Get1dNoiseZeroToOneRange );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+inline void Fill3dNoiseZeroToOne( int x0, int y0, int z0, size_t width, size_t height, size_t depth, size_t rowStride, size_t sliceStride, unsigned int seed, float* out )
+{
+	SquirrelNoise5Simd::Fill3d( x0, y0, z0, width, height, depth, rowStride, sliceStride, seed, out, Get1dNoiseZeroToOneRange );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+inline void Fill2dNoiseNegOneToOne( int x0, int y0, size_t width, size_t height, size_t stride, unsigned int seed, float* out )
+{
+	SquirrelNoise5Simd::Fill2d( x0, y0, width, height, stride, seed, out, Get1dNoiseNegOneToOneRange );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+inline void Fill3dNoiseNegOneToOne( int x0, int y0, int z0, size_t width, size_t height, size_t depth, size_t rowStride, size_t sliceStride, unsigned int seed, float* out )
+{
+	SquirrelNoise5Simd::Fill3d( x0, y0, z0, width, height, depth, rowStride, sliceStride, seed, out, Get1dNoiseNegOneToOneRange );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+inline void Get1dNoiseZeroToOneFastRange( int start, size_t count, unsigned int seed, float* out )
+{
+	using B = SquirrelNoise5Simd::Backend;
+	SquirrelNoise5Simd::RangeKernel<B>( start, count, seed,
+		[ out ]( size_t offset, B::U32 noise ) { B::StoreF( out + offset, SquirrelNoise5Simd::ZeroToOneFastLanes<B>( noise ) ); },
+		[ out ]( size_t offset, unsigned int noise ) { out[ offset ] = (1.0f / 16777216.0f) * (float) (int)( noise >> 8 ); } );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+inline void Get1dNoiseNegOneToOneFastRange( int start, size_t count, unsigned int seed, float* out )
+{
+	using B = SquirrelNoise5Simd::Backend;
+	SquirrelNoise5Simd::RangeKernel<B>( start, count, seed,
+		[ out ]( size_t offset, B::U32 noise ) { B::StoreF( out + offset, SquirrelNoise5Simd::NegOneToOneFastLanes<B>( noise ) ); },
+		[ out ]( size_t offset, unsigned int noise ) { out[ offset ] = (1.0f / 8388608.0f) * (float)( (int) noise >> 8 ); } );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+inline void Fill2dNoiseZeroToOneFast( int x0, int y0, size_t width, size_t height, size_t stride, unsigned int seed, float* out )
+{
+	SquirrelNoise5Simd::Fill2d( x0, y0, width, height, stride, seed, out, Get1dNoiseZeroToOneFastRange );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+inline void Fill3dNoiseZeroToOneFast( int x0, int y0, int z0, size_t width, size_t height, size_t depth, size_t rowStride, size_t sliceStride, unsigned int seed, float* out )
+{
+	SquirrelNoise5Simd::Fill3d( x0, y0, z0, width, height, depth, rowStride, sliceStride, seed, out, Get1dNoiseZeroToOneFastRange );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+inline void Fill2dNoiseNegOneToOneFast( int x0, int y0, size_t width, size_t height, size_t stride, unsigned int seed, float* out )
+{
+	SquirrelNoise5Simd::Fill2d( x0, y0, width, height, stride, seed, out, Get1dNoiseNegOneToOneFastRange );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+inline void Fill3dNoiseNegOneToOneFast( int x0, int y0, int z0, size_t width, size_t height, size_t depth, size_t rowStride, size_t sliceStride, unsigned int seed, float* out )
+{
+	SquirrelNoise5Simd::Fill3d( x0, y0, z0, width, height, depth, rowStride, sliceStride, seed, out, Get1dNoiseNegOneToOneFastRange );
+}
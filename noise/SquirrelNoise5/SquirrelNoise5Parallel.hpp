@@ -0,0 +1,333 @@
+//-----------------------------------------------------------------------------------------------
+// SquirrelNoise5Parallel.hpp
+//
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "SquirrelNoise5Batch.hpp"
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+// SquirrelNoise5Parallel - Multithreaded region fills for SquirrelNoise5
+//
+// Since the noise functions are state-free, filling a large region is embarrassingly parallel.
+//	noise::ParallelFill splits a 2D/3D/4D region into cache-sized tiles and runs them on a small
+//	work-stealing thread pool, writing into a single caller-supplied output buffer.
+//
+// Every tile is generated with the same row functions used by the serial fills, so the output
+//	is identical to the serial path no matter how many threads are used.
+//
+// Tiles always cover whole rows, or a multiple of 64 bytes of a row when one row alone is bigger
+//	than a tile, so with a 64-byte aligned buffer and strides no two threads ever write to the
+//	same cache line.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace noise
+{
+	//-------------------------------------------------------------------------------------------
+	// Describes a 1-4 dimensional region of noise and how it is laid out in the output buffer.
+	//	Unused dimensions keep their default size of 1, and strides are given in elements.
+	//
+	struct NoiseRegion
+	{
+		int x0 = 0, y0 = 0, z0 = 0, t0 = 0;
+		size_t width = 1, height = 1, depth = 1, duration = 1;
+		size_t rowStride = 0, sliceStride = 0, volumeStride = 0;
+
+		static NoiseRegion Make2d( int x0, int y0, size_t width, size_t height, size_t stride );
+		static NoiseRegion Make3d( int x0, int y0, int z0, size_t width, size_t height, size_t depth, size_t rowStride, size_t sliceStride );
+		static NoiseRegion Make4d( int x0, int y0, int z0, int t0, size_t width, size_t height, size_t depth, size_t duration, size_t rowStride, size_t sliceStride, size_t volumeStride );
+	};
+
+
+	//-------------------------------------------------------------------------------------------
+	class ParallelFill
+	{
+	public:
+		// Target size of a single tile; small enough to stay in L2 while it is being written.
+		static constexpr size_t TILE_BYTES = 64 * 1024;
+		static constexpr size_t CACHE_LINE_BYTES = 64;
+
+		// threadCount includes the calling thread, which also works on tiles during a fill.
+		//	0 means std::thread::hardware_concurrency(); 1 runs everything serially.
+		explicit ParallelFill( unsigned int threadCount = 0 );
+		~ParallelFill();
+
+		ParallelFill( const ParallelFill& ) = delete;
+		ParallelFill& operator=( const ParallelFill& ) = delete;
+
+		unsigned int GetThreadCount() const { return static_cast<unsigned int>( m_queues.size() ); }
+
+		// Same results as the serial Fill2dNoiseUint() / Fill3dNoiseUint() / Get4dNoiseUint().
+		void Fill2dNoiseUint( int x0, int y0, size_t width, size_t height, size_t stride, unsigned int seed, unsigned int* out );
+		void Fill3dNoiseUint( int x0, int y0, int z0, size_t width, size_t height, size_t depth, size_t rowStride, size_t sliceStride, unsigned int seed, unsigned int* out );
+		void Fill4dNoiseUint( int x0, int y0, int z0, int t0, size_t width, size_t height, size_t depth, size_t duration, size_t rowStride, size_t sliceStride, size_t volumeStride, unsigned int seed, unsigned int* out );
+
+		// Generic fill: rowFunc is any of the Get1dNoise*Range() functions (or anything with the
+		//	same signature), e.g. `pool.Fill( region, seed, out, Get1dNoiseZeroToOneFastRange );`
+		template<typename T, typename RowFunc>
+		void Fill( const NoiseRegion& region, unsigned int seed, T* out, RowFunc rowFunc );
+
+	private:
+		struct WorkQueue
+		{
+			std::mutex mutex;
+			std::deque<size_t> tiles;
+		};
+
+		void RunTiles( size_t tileCount, const std::function<void( size_t )>& tileFunc );
+		void WorkOnTiles( size_t queueIndex );
+		bool PopTile( size_t queueIndex, size_t& out_tile );
+		void WorkerMain( size_t queueIndex );
+
+		std::vector<WorkQueue> m_queues;					// One per thread; the last one belongs to the caller
+		std::vector<std::thread> m_workers;
+
+		std::mutex m_runMutex;								// Serializes concurrent fills on the same pool
+		std::mutex m_wakeMutex;
+		std::condition_variable m_wakeCondition;
+		std::condition_variable m_doneCondition;
+		const std::function<void( size_t )>* m_tileFunc = nullptr;
+		size_t m_generation = 0;
+		size_t m_activeWorkers = 0;
+		bool m_quit = false;
+	};
+}
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+// Inline function definitions below
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace noise
+{
+	//-------------------------------------------------------------------------------------------
+	inline NoiseRegion NoiseRegion::Make2d( int x0, int y0, size_t width, size_t height, size_t stride )
+	{
+		NoiseRegion region;
+		region.x0 = x0;
+		region.y0 = y0;
+		region.width = width;
+		region.height = height;
+		region.rowStride = stride;
+		return region;
+	}
+
+	//-------------------------------------------------------------------------------------------
+	inline NoiseRegion NoiseRegion::Make3d( int x0, int y0, int z0, size_t width, size_t height, size_t depth, size_t rowStride, size_t sliceStride )
+	{
+		NoiseRegion region = Make2d( x0, y0, width, height, rowStride );
+		region.z0 = z0;
+		region.depth = depth;
+		region.sliceStride = sliceStride;
+		return region;
+	}
+
+	//-------------------------------------------------------------------------------------------
+	inline NoiseRegion NoiseRegion::Make4d( int x0, int y0, int z0, int t0, size_t width, size_t height, size_t depth, size_t duration, size_t rowStride, size_t sliceStride, size_t volumeStride )
+	{
+		NoiseRegion region = Make3d( x0, y0, z0, width, height, depth, rowStride, sliceStride );
+		region.t0 = t0;
+		region.duration = duration;
+		region.volumeStride = volumeStride;
+		return region;
+	}
+
+
+	//-------------------------------------------------------------------------------------------
+	inline ParallelFill::ParallelFill( unsigned int threadCount )
+	{
+		if( threadCount == 0 )
+			threadCount = std::thread::hardware_concurrency();
+		if( threadCount == 0 )
+			threadCount = 1;
+
+		m_queues = std::vector<WorkQueue>( threadCount );
+		m_workers.reserve( threadCount - 1 );
+		for( size_t i = 0; i + 1 < threadCount; ++i )
+			m_workers.emplace_back( &ParallelFill::WorkerMain, this, i );
+	}
+
+	//-------------------------------------------------------------------------------------------
+	inline ParallelFill::~ParallelFill()
+	{
+		{
+			std::lock_guard<std::mutex> lock( m_wakeMutex );
+			m_quit = true;
+		}
+		m_wakeCondition.notify_all();
+		for( std::thread& worker : m_workers )
+			worker.join();
+	}
+
+	//-------------------------------------------------------------------------------------------
+	inline void ParallelFill::Fill2dNoiseUint( int x0, int y0, size_t width, size_t height, size_t stride, unsigned int seed, unsigned int* out )
+	{
+		Fill( NoiseRegion::Make2d( x0, y0, width, height, stride ), seed, out, Get1dNoiseUintRange );
+	}
+
+	//-------------------------------------------------------------------------------------------
+	inline void ParallelFill::Fill3dNoiseUint( int x0, int y0, int z0, size_t width, size_t height, size_t depth, size_t rowStride, size_t sliceStride, unsigned int seed, unsigned int* out )
+	{
+		Fill( NoiseRegion::Make3d( x0, y0, z0, width, height, depth, rowStride, sliceStride ), seed, out, Get1dNoiseUintRange );
+	}
+
+	//-------------------------------------------------------------------------------------------
+	inline void ParallelFill::Fill4dNoiseUint( int x0, int y0, int z0, int t0, size_t width, size_t height, size_t depth, size_t duration, size_t rowStride, size_t sliceStride, size_t volumeStride, unsigned int seed, unsigned int* out )
+	{
+		Fill( NoiseRegion::Make4d( x0, y0, z0, t0, width, height, depth, duration, rowStride, sliceStride, volumeStride ), seed, out, Get1dNoiseUintRange );
+	}
+
+	//-------------------------------------------------------------------------------------------
+	template<typename T, typename RowFunc>
+	inline void ParallelFill::Fill( const NoiseRegion& region, unsigned int seed, T* out, RowFunc rowFunc )
+	{
+		const size_t rowCount = region.height * region.depth * region.duration;
+		if( region.width == 0 || rowCount == 0 )
+			return;
+
+		// Split long rows at cache line boundaries, then group as many rows as fit in a tile
+		constexpr size_t LINE_ELEMENTS = ( CACHE_LINE_BYTES / sizeof( T ) ) ? CACHE_LINE_BYTES / sizeof( T ) : 1;
+		constexpr size_t TILE_ELEMENTS = TILE_BYTES / sizeof( T );
+		const size_t tileWidth = ( region.width <= TILE_ELEMENTS ) ? region.width : TILE_ELEMENTS - ( TILE_ELEMENTS % LINE_ELEMENTS );
+		const size_t rowsPerTile = ( TILE_ELEMENTS / tileWidth ) ? TILE_ELEMENTS / tileWidth : 1;
+		const size_t tilesPerRow = ( region.width + tileWidth - 1 ) / tileWidth;
+		const size_t rowBlocks = ( rowCount + rowsPerTile - 1 ) / rowsPerTile;
+
+		const std::function<void( size_t )> tileFunc = [ & ]( size_t tile )
+		{
+			const size_t firstRow = ( tile / tilesPerRow ) * rowsPerTile;
+			const size_t lastRow = ( firstRow + rowsPerTile < rowCount ) ? firstRow + rowsPerTile : rowCount;
+			const size_t x = ( tile % tilesPerRow ) * tileWidth;
+			const size_t count = ( x + tileWidth < region.width ) ? tileWidth : region.width - x;
+
+			for( size_t row = firstRow; row < lastRow; ++row )
+			{
+				const size_t y = row % region.height;
+				const size_t z = ( row / region.height ) % region.depth;
+				const size_t t = row / ( region.height * region.depth );
+
+				// Same coordinate hash as Get4dNoiseUint(), done in unsigned math to wrap safely
+				const unsigned int start = (unsigned int) region.x0 + (unsigned int) x
+					+ SquirrelNoise5Simd::PRIME1 * ( (unsigned int) region.y0 + (unsigned int) y )
+					+ SquirrelNoise5Simd::PRIME2 * ( (unsigned int) region.z0 + (unsigned int) z )
+					+ SquirrelNoise5Simd::PRIME3 * ( (unsigned int) region.t0 + (unsigned int) t );
+				T* rowOut = out + x + y * region.rowStride + z * region.sliceStride + t * region.volumeStride;
+				rowFunc( (int) start, count, seed, rowOut );
+			}
+		};
+
+		RunTiles( rowBlocks * tilesPerRow, tileFunc );
+	}
+
+	//-------------------------------------------------------------------------------------------
+	inline void ParallelFill::RunTiles( size_t tileCount, const std::function<void( size_t )>& tileFunc )
+	{
+		std::lock_guard<std::mutex> runLock( m_runMutex );
+
+		if( m_workers.empty() || tileCount == 1 )
+		{
+			for( size_t tile = 0; tile < tileCount; ++tile )
+				tileFunc( tile );
+			return;
+		}
+
+		// Hand every thread a contiguous block of tiles to start with; idle threads steal later
+		const size_t queueCount = m_queues.size();
+		for( size_t i = 0; i < queueCount; ++i )
+		{
+			std::lock_guard<std::mutex> queueLock( m_queues[ i ].mutex );
+			const size_t first = tileCount * i / queueCount;
+			const size_t last = tileCount * ( i + 1 ) / queueCount;
+			for( size_t tile = first; tile < last; ++tile )
+				m_queues[ i ].tiles.push_back( tile );
+		}
+
+		{
+			std::lock_guard<std::mutex> lock( m_wakeMutex );
+			m_tileFunc = &tileFunc;
+			m_activeWorkers = m_workers.size();
+			++m_generation;
+		}
+		m_wakeCondition.notify_all();
+
+		WorkOnTiles( queueCount - 1 );
+
+		// Wait for the workers to finish their last tiles and go back to sleep, so that tileFunc
+		//	is never touched after it goes out of scope.
+		std::unique_lock<std::mutex> lock( m_wakeMutex );
+		m_doneCondition.wait( lock, [ this ] { return m_activeWorkers == 0; } );
+		m_tileFunc = nullptr;
+	}
+
+	//-------------------------------------------------------------------------------------------
+	inline void ParallelFill::WorkOnTiles( size_t queueIndex )
+	{
+		size_t tile = 0;
+		while( PopTile( queueIndex, tile ) )
+			( *m_tileFunc )( tile );
+	}
+
+	//-------------------------------------------------------------------------------------------
+	// Pops from the back of our own queue, or steals from the front of someone else's.
+	//
+	inline bool ParallelFill::PopTile( size_t queueIndex, size_t& out_tile )
+	{
+		{
+			WorkQueue& own = m_queues[ queueIndex ];
+			std::lock_guard<std::mutex> lock( own.mutex );
+			if( !own.tiles.empty() )
+			{
+				out_tile = own.tiles.back();
+				own.tiles.pop_back();
+				return true;
+			}
+		}
+
+		const size_t queueCount = m_queues.size();
+		for( size_t offset = 1; offset < queueCount; ++offset )
+		{
+			WorkQueue& victim = m_queues[ ( queueIndex + offset ) % queueCount ];
+			std::lock_guard<std::mutex> lock( victim.mutex );
+			if( !victim.tiles.empty() )
+			{
+				out_tile = victim.tiles.front();
+				victim.tiles.pop_front();
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	//-------------------------------------------------------------------------------------------
+	inline void ParallelFill::WorkerMain( size_t queueIndex )
+	{
+		size_t seenGeneration = 0;
+		for( ;; )
+		{
+			{
+				std::unique_lock<std::mutex> lock( m_wakeMutex );
+				m_wakeCondition.wait( lock, [ & ] { return m_quit || m_generation != seenGeneration; } );
+				if( m_quit )
+					return;
+				seenGeneration = m_generation;
+			}
+
+			WorkOnTiles( queueIndex );
+
+			{
+				std::lock_guard<std::mutex> lock( m_wakeMutex );
+				--m_activeWorkers;
+			}
+			m_doneCondition.notify_one();
+		}
+	}
+}
@@ -0,0 +1,706 @@
+//-----------------------------------------------------------------------------------------------
+// SquirrelNoise5Smooth.hpp
+//
+#pragma once
+
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+#include "SquirrelNoise5Batch.hpp"
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+// SquirrelNoise5Smooth - Smoothed (value) and gradient (Perlin-style) noise, with fBm octaves
+//
+// Built on top of the raw SquirrelNoise5 hashes, as suggested in its header.  Two families:
+//	Compute*dFractalNoise	smoothed value noise: lattice-corner noise values, blended with a
+//							quintic fade curve
+//	Compute*dPerlinNoise	gradient noise: lattice-corner pseudo-random gradients, dotted with
+//							the offset to the sample and blended with the same fade curve
+//
+// Both sum NUM_OCTAVES octaves of fractional Brownian motion (fBm), a compile-time constant so
+//	that the octave loops unroll; use NUM_OCTAVES=1 for plain value/gradient noise.  Results are
+//	in [-1,1] when renormalize is true (the default).
+//
+// All the lattice-corner hashes of every octave are gathered first and computed in one call to
+//	the SIMD batch kernel.  Each octave hashes its index as an extra coordinate (see OCTAVE_PRIME)
+//	rather than bumping the seed, which keeps the whole batch on a single seed.
+//
+// The Fill2d/Fill3d versions evaluate a regular grid of samples and compute every lattice-corner
+//	hash only once with the grid-fill kernel, sharing it between all the neighbouring samples that
+//	use it.  Their output is identical to calling the point versions for every sample, as long as
+//	the compiler isn't allowed to fuse multiply-adds differently in each (e.g. -ffp-contract=off,
+//	which is the default behaviour of MSVC's /fp:precise).
+//
+// The *AndDerivatives versions also return the analytic partial derivatives with respect to each
+//	position coordinate, computed from the same corner hashes (for normals, flow fields...).
+//	Their value is the same as the plain versions'.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//-----------------------------------------------------------------------------------------------
+// Smoothed value noise (fBm).  scale is the size of a lattice cell at the first octave, in the
+//	same units as the positions; every octave multiplies the frequency by octaveScale and the
+//	amplitude by octavePersistence.
+//
+template<unsigned int NUM_OCTAVES=1> float Compute1dFractalNoise( float posX, float scale=1.f, float octavePersistence=0.5f, float octaveScale=2.f, bool renormalize=true, unsigned int seed=0 );
+template<unsigned int NUM_OCTAVES=1> float Compute2dFractalNoise( float posX, float posY, float scale=1.f, float octavePersistence=0.5f, float octaveScale=2.f, bool renormalize=true, unsigned int seed=0 );
+template<unsigned int NUM_OCTAVES=1> float Compute3dFractalNoise( float posX, float posY, float posZ, float scale=1.f, float octavePersistence=0.5f, float octaveScale=2.f, bool renormalize=true, unsigned int seed=0 );
+template<unsigned int NUM_OCTAVES=1> float Compute4dFractalNoise( float posX, float posY, float posZ, float posT, float scale=1.f, float octavePersistence=0.5f, float octaveScale=2.f, bool renormalize=true, unsigned int seed=0 );
+
+//-----------------------------------------------------------------------------------------------
+// Gradient (Perlin-style) noise (fBm).  Same parameters as above.
+//
+template<unsigned int NUM_OCTAVES=1> float Compute1dPerlinNoise( float posX, float scale=1.f, float octavePersistence=0.5f, float octaveScale=2.f, bool renormalize=true, unsigned int seed=0 );
+template<unsigned int NUM_OCTAVES=1> float Compute2dPerlinNoise( float posX, float posY, float scale=1.f, float octavePersistence=0.5f, float octaveScale=2.f, bool renormalize=true, unsigned int seed=0 );
+template<unsigned int NUM_OCTAVES=1> float Compute3dPerlinNoise( float posX, float posY, float posZ, float scale=1.f, float octavePersistence=0.5f, float octaveScale=2.f, bool renormalize=true, unsigned int seed=0 );
+template<unsigned int NUM_OCTAVES=1> float Compute4dPerlinNoise( float posX, float posY, float posZ, float posT, float scale=1.f, float octavePersistence=0.5f, float octaveScale=2.f, bool renormalize=true, unsigned int seed=0 );
+
+//-----------------------------------------------------------------------------------------------
+// Grid fills: out[ y*stride + x ] = Compute2d*Noise<NUM_OCTAVES>( posX + x*step, posY + y*step, ... )
+//	and likewise for 3D, with strides given in elements.  step must be positive.
+//
+template<unsigned int NUM_OCTAVES=1> void Fill2dFractalNoise( float posX, float posY, float step, size_t width, size_t height, size_t stride, float* out, float scale=1.f, float octavePersistence=0.5f, float octaveScale=2.f, bool renormalize=true, unsigned int seed=0 );
+template<unsigned int NUM_OCTAVES=1> void Fill3dFractalNoise( float posX, float posY, float posZ, float step, size_t width, size_t height, size_t depth, size_t rowStride, size_t sliceStride, float* out, float scale=1.f, float octavePersistence=0.5f, float octaveScale=2.f, bool renormalize=true, unsigned int seed=0 );
+template<unsigned int NUM_OCTAVES=1> void Fill2dPerlinNoise( float posX, float posY, float step, size_t width, size_t height, size_t stride, float* out, float scale=1.f, float octavePersistence=0.5f, float octaveScale=2.f, bool renormalize=true, unsigned int seed=0 );
+template<unsigned int NUM_OCTAVES=1> void Fill3dPerlinNoise( float posX, float posY, float posZ, float step, size_t width, size_t height, size_t depth, size_t rowStride, size_t sliceStride, float* out, float scale=1.f, float octavePersistence=0.5f, float octaveScale=2.f, bool renormalize=true, unsigned int seed=0 );
+
+//-----------------------------------------------------------------------------------------------
+// Value and partial derivatives (d/dposX, d/dposY[, d/dposZ]) in one evaluation.  The Fill
+//	versions write each derivative to its own grid, laid out like out.
+//
+template<unsigned int NUM_OCTAVES=1> float Compute2dFractalNoiseAndDerivatives( float posX, float posY, float& out_dx, float& out_dy, float scale=1.f, float octavePersistence=0.5f, float octaveScale=2.f, bool renormalize=true, unsigned int seed=0 );
+template<unsigned int NUM_OCTAVES=1> float Compute3dFractalNoiseAndDerivatives( float posX, float posY, float posZ, float& out_dx, float& out_dy, float& out_dz, float scale=1.f, float octavePersistence=0.5f, float octaveScale=2.f, bool renormalize=true, unsigned int seed=0 );
+template<unsigned int NUM_OCTAVES=1> float Compute2dPerlinNoiseAndDerivatives( float posX, float posY, float& out_dx, float& out_dy, float scale=1.f, float octavePersistence=0.5f, float octaveScale=2.f, bool renormalize=true, unsigned int seed=0 );
+template<unsigned int NUM_OCTAVES=1> float Compute3dPerlinNoiseAndDerivatives( float posX, float posY, float posZ, float& out_dx, float& out_dy, float& out_dz, float scale=1.f, float octavePersistence=0.5f, float octaveScale=2.f, bool renormalize=true, unsigned int seed=0 );
+template<unsigned int NUM_OCTAVES=1> void Fill2dFractalNoiseAndDerivatives( float posX, float posY, float step, size_t width, size_t height, size_t stride, float* out, float* out_dx, float* out_dy, float scale=1.f, float octavePersistence=0.5f, float octaveScale=2.f, bool renormalize=true, unsigned int seed=0 );
+template<unsigned int NUM_OCTAVES=1> void Fill3dFractalNoiseAndDerivatives( float posX, float posY, float posZ, float step, size_t width, size_t height, size_t depth, size_t rowStride, size_t sliceStride, float* out, float* out_dx, float* out_dy, float* out_dz, float scale=1.f, float octavePersistence=0.5f, float octaveScale=2.f, bool renormalize=true, unsigned int seed=0 );
+template<unsigned int NUM_OCTAVES=1> void Fill2dPerlinNoiseAndDerivatives( float posX, float posY, float step, size_t width, size_t height, size_t stride, float* out, float* out_dx, float* out_dy, float scale=1.f, float octavePersistence=0.5f, float octaveScale=2.f, bool renormalize=true, unsigned int seed=0 );
+template<unsigned int NUM_OCTAVES=1> void Fill3dPerlinNoiseAndDerivatives( float posX, float posY, float posZ, float step, size_t width, size_t height, size_t depth, size_t rowStride, size_t sliceStride, float* out, float* out_dx, float* out_dy, float* out_dz, float scale=1.f, float octavePersistence=0.5f, float octaveScale=2.f, bool renormalize=true, unsigned int seed=0 );
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+// Inline function definitions below
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace SquirrelNoise5Smooth
+{
+	// Large prime number with non-boring bits, used to hash the octave index as an extra coordinate
+	constexpr unsigned int OCTAVE_PRIME = 1183186591;
+
+	// Offset added to the position of every octave, so that lattice points of different octaves
+	//	don't line up at the origin.
+	constexpr float OCTAVE_OFFSET = 0.636764989593174f;
+
+	// Multipliers used to fold lattice coordinates into a single index, same as Get*dNoiseUint()
+	constexpr unsigned int AXIS_PRIMES[ 4 ] = { 1, SquirrelNoise5Simd::PRIME1, SquirrelNoise5Simd::PRIME2, SquirrelNoise5Simd::PRIME3 };
+
+	//-------------------------------------------------------------------------------------------
+	// Unit gradients; indexed by the top bits of a corner hash.
+	//
+	constexpr float SQRT_HALF = 0.70710678118654752f;
+	constexpr float SQRT_THIRD = 0.57735026918962576f;
+
+	constexpr float GRADIENTS_2D[ 8 ][ 2 ] =
+	{
+		{ 1.f, 0.f }, { SQRT_HALF, SQRT_HALF }, { 0.f, 1.f }, { -SQRT_HALF, SQRT_HALF },
+		{ -1.f, 0.f }, { -SQRT_HALF, -SQRT_HALF }, { 0.f, -1.f }, { SQRT_HALF, -SQRT_HALF },
+	};
+
+	// The 12 cube edge directions (plus 4 repeated, as in Perlin's improved noise)
+	constexpr float GRADIENTS_3D[ 16 ][ 3 ] =
+	{
+		{ SQRT_HALF, SQRT_HALF, 0.f }, { -SQRT_HALF, SQRT_HALF, 0.f }, { SQRT_HALF, -SQRT_HALF, 0.f }, { -SQRT_HALF, -SQRT_HALF, 0.f },
+		{ SQRT_HALF, 0.f, SQRT_HALF }, { -SQRT_HALF, 0.f, SQRT_HALF }, { SQRT_HALF, 0.f, -SQRT_HALF }, { -SQRT_HALF, 0.f, -SQRT_HALF },
+		{ 0.f, SQRT_HALF, SQRT_HALF }, { 0.f, -SQRT_HALF, SQRT_HALF }, { 0.f, SQRT_HALF, -SQRT_HALF }, { 0.f, -SQRT_HALF, -SQRT_HALF },
+		{ SQRT_HALF, SQRT_HALF, 0.f }, { -SQRT_HALF, SQRT_HALF, 0.f }, { 0.f, -SQRT_HALF, SQRT_HALF }, { 0.f, -SQRT_HALF, -SQRT_HALF },
+	};
+
+	// The 32 tesseract edge directions
+	constexpr float GRADIENTS_4D[ 32 ][ 4 ] =
+	{
+		{ 0.f, SQRT_THIRD, SQRT_THIRD, SQRT_THIRD }, { 0.f, SQRT_THIRD, SQRT_THIRD, -SQRT_THIRD }, { 0.f, SQRT_THIRD, -SQRT_THIRD, SQRT_THIRD }, { 0.f, SQRT_THIRD, -SQRT_THIRD, -SQRT_THIRD },
+		{ 0.f, -SQRT_THIRD, SQRT_THIRD, SQRT_THIRD }, { 0.f, -SQRT_THIRD, SQRT_THIRD, -SQRT_THIRD }, { 0.f, -SQRT_THIRD, -SQRT_THIRD, SQRT_THIRD }, { 0.f, -SQRT_THIRD, -SQRT_THIRD, -SQRT_THIRD },
+		{ SQRT_THIRD, 0.f, SQRT_THIRD, SQRT_THIRD }, { SQRT_THIRD, 0.f, SQRT_THIRD, -SQRT_THIRD }, { SQRT_THIRD, 0.f, -SQRT_THIRD, SQRT_THIRD }, { SQRT_THIRD, 0.f, -SQRT_THIRD, -SQRT_THIRD },
+		{ -SQRT_THIRD, 0.f, SQRT_THIRD, SQRT_THIRD }, { -SQRT_THIRD, 0.f, SQRT_THIRD, -SQRT_THIRD }, { -SQRT_THIRD, 0.f, -SQRT_THIRD, SQRT_THIRD }, { -SQRT_THIRD, 0.f, -SQRT_THIRD, -SQRT_THIRD },
+		{ SQRT_THIRD, SQRT_THIRD, 0.f, SQRT_THIRD }, { SQRT_THIRD, SQRT_THIRD, 0.f, -SQRT_THIRD }, { SQRT_THIRD, -SQRT_THIRD, 0.f, SQRT_THIRD }, { SQRT_THIRD, -SQRT_THIRD, 0.f, -SQRT_THIRD },
+		{ -SQRT_THIRD, SQRT_THIRD, 0.f, SQRT_THIRD }, { -SQRT_THIRD, SQRT_THIRD, 0.f, -SQRT_THIRD }, { -SQRT_THIRD, -SQRT_THIRD, 0.f, SQRT_THIRD }, { -SQRT_THIRD, -SQRT_THIRD, 0.f, -SQRT_THIRD },
+		{ SQRT_THIRD, SQRT_THIRD, SQRT_THIRD, 0.f }, { SQRT_THIRD, SQRT_THIRD, -SQRT_THIRD, 0.f }, { SQRT_THIRD, -SQRT_THIRD, SQRT_THIRD, 0.f }, { SQRT_THIRD, -SQRT_THIRD, -SQRT_THIRD, 0.f },
+		{ -SQRT_THIRD, SQRT_THIRD, SQRT_THIRD, 0.f }, { -SQRT_THIRD, SQRT_THIRD, -SQRT_THIRD, 0.f }, { -SQRT_THIRD, -SQRT_THIRD, SQRT_THIRD, 0.f }, { -SQRT_THIRD, -SQRT_THIRD, -SQRT_THIRD, 0.f },
+	};
+
+	// Maximum magnitude of gradient noise with unit gradients is sqrt(DIM)/2; these undo it.
+	constexpr float GRADIENT_NORMALIZATION[ 5 ] = { 0.f, 2.f, 1.41421356237309505f, 1.15470053837925153f, 1.f };
+
+	//-------------------------------------------------------------------------------------------
+	// Quintic fade curve, 6t^5 - 15t^4 + 10t^3 (zero first and second derivatives at 0 and 1).
+	//
+	inline float Fade( float t )
+	{
+		return t * t * t * ( t * ( t * 6.f - 15.f ) + 10.f );
+	}
+
+	//-------------------------------------------------------------------------------------------
+	// Derivative of Fade(), 30t^4 - 60t^3 + 30t^2.
+	//
+	inline float FadeDerivative( float t )
+	{
+		return 30.f * t * t * ( t * ( t - 2.f ) + 1.f );
+	}
+
+	//-------------------------------------------------------------------------------------------
+	// Lattice cell and fractional position of one coordinate at a given octave.  Both the point
+	//	and the grid versions go through here, so they always agree on which cell a sample is in.
+	//
+	inline void LocateInCell( float pos, float octaveFrequency, unsigned int octave, int& out_cell, float& out_fraction )
+	{
+		const float octavePos = ( pos * octaveFrequency ) + ( OCTAVE_OFFSET * (float) octave );
+		const float cell = std::floor( octavePos );
+		out_cell = (int) cell;
+		out_fraction = octavePos - cell;
+	}
+
+	//-------------------------------------------------------------------------------------------
+	// Blends the 2^DIM corner hashes of a lattice cell; corner c is offset by +1 along axis d
+	//	when bit d of c is set.
+	//
+	// With DERIVATIVES, also writes the partial derivatives with respect to each fraction to
+	//	out_derivatives[ 0 .. DIM ), carried along through every blend with the product rule.
+	//
+	template<int DIM, bool GRADIENT, bool DERIVATIVES=false>
+	inline float NoiseInCell( const unsigned int* cornerHashes, const float* fractions, float* out_derivatives=nullptr )
+	{
+		constexpr int NUM_CORNERS = 1 << DIM;
+		float values[ NUM_CORNERS ];
+		float derivatives[ DERIVATIVES ? NUM_CORNERS : 1 ][ DIM ];
+		for( int corner = 0; corner < NUM_CORNERS; ++corner )
+		{
+			const unsigned int hash = cornerHashes[ corner ];
+			if constexpr( !GRADIENT )
+			{
+				values[ corner ] = (1.0f / 8388608.0f) * (float)( (int) hash >> 8 );
+				if constexpr( DERIVATIVES )
+				{
+					for( int d = 0; d < DIM; ++d )
+						derivatives[ corner ][ d ] = 0.f;
+				}
+			}
+			else
+			{
+				float offsets[ DIM ];
+				for( int d = 0; d < DIM; ++d )
+					offsets[ d ] = ( corner & ( 1 << d ) ) ? fractions[ d ] - 1.f : fractions[ d ];
+
+				// The derivatives of a corner's dot product are just its gradient
+				if constexpr( DIM == 1 )
+				{
+					const float gradient = (1.0f / 8388608.0f) * (float)( (int) hash >> 8 );
+					values[ corner ] = offsets[ 0 ] * gradient;
+					if constexpr( DERIVATIVES )
+						derivatives[ corner ][ 0 ] = gradient;
+				}
+				else if constexpr( DIM == 2 )
+				{
+					const float* gradient = GRADIENTS_2D[ hash >> 29 ];
+					values[ corner ] = gradient[ 0 ] * offsets[ 0 ] + gradient[ 1 ] * offsets[ 1 ];
+					if constexpr( DERIVATIVES )
+					{
+						for( int d = 0; d < DIM; ++d )
+							derivatives[ corner ][ d ] = gradient[ d ];
+					}
+				}
+				else if constexpr( DIM == 3 )
+				{
+					const float* gradient = GRADIENTS_3D[ hash >> 28 ];
+					values[ corner ] = gradient[ 0 ] * offsets[ 0 ] + gradient[ 1 ] * offsets[ 1 ] + gradient[ 2 ] * offsets[ 2 ];
+					if constexpr( DERIVATIVES )
+					{
+						for( int d = 0; d < DIM; ++d )
+							derivatives[ corner ][ d ] = gradient[ d ];
+					}
+				}
+				else
+				{
+					const float* gradient = GRADIENTS_4D[ hash >> 27 ];
+					values[ corner ] = gradient[ 0 ] * offsets[ 0 ] + gradient[ 1 ] * offsets[ 1 ] + gradient[ 2 ] * offsets[ 2 ] + gradient[ 3 ] * offsets[ 3 ];
+					if constexpr( DERIVATIVES )
+					{
+						for( int d = 0; d < DIM; ++d )
+							derivatives[ corner ][ d ] = gradient[ d ];
+					}
+				}
+			}
+		}
+
+		// Collapse one axis at a time: after axis d, values[0 .. 2^(DIM-d-1)) hold the blended corners
+		for( int d = 0; d < DIM; ++d )
+		{
+			const float fade = Fade( fractions[ d ] );
+			const int half = NUM_CORNERS >> ( d + 1 );
+			for( int corner = 0; corner < half; ++corner )
+			{
+				const float low = values[ 2 * corner ];
+				const float high = values[ 2 * corner + 1 ];
+				values[ corner ] = low + fade * ( high - low );
+
+				if constexpr( DERIVATIVES )
+				{
+					for( int k = 0; k < DIM; ++k )
+					{
+						const float lowDerivative = derivatives[ 2 * corner ][ k ];
+						const float highDerivative = derivatives[ 2 * corner + 1 ][ k ];
+						derivatives[ corner ][ k ] = lowDerivative + fade * ( highDerivative - lowDerivative );
+					}
+					derivatives[ corner ][ d ] += FadeDerivative( fractions[ d ] ) * ( high - low );
+				}
+			}
+		}
+
+		if constexpr( DERIVATIVES )
+		{
+			for( int d = 0; d < DIM; ++d )
+				out_derivatives[ d ] = GRADIENT ? derivatives[ 0 ][ d ] * GRADIENT_NORMALIZATION[ DIM ] : derivatives[ 0 ][ d ];
+		}
+
+		if constexpr( GRADIENT )
+			return values[ 0 ] * GRADIENT_NORMALIZATION[ DIM ];
+		else
+			return values[ 0 ];
+	}
+
+	//-------------------------------------------------------------------------------------------
+	// Point evaluation.  Gathers every corner index of every octave, hashes them in one batch,
+	//	then blends octave by octave.  With DERIVATIVES, out_derivatives[ 0 .. DIM ) receives the
+	//	partial derivatives with respect to position.
+	//
+	template<unsigned int NUM_OCTAVES, int DIM, bool GRADIENT, bool DERIVATIVES=false>
+	inline float ComputeFractal( const float* position, float scale, float octavePersistence, float octaveScale, bool renormalize, unsigned int seed, float* out_derivatives=nullptr )
+	{
+		static_assert( NUM_OCTAVES > 0, "At least one octave is required" );
+		constexpr int NUM_CORNERS = 1 << DIM;
+
+		int cornerIndices[ NUM_OCTAVES * NUM_CORNERS ];
+		float fractions[ NUM_OCTAVES ][ DIM ];
+
+		float octaveFrequency = 1.f / scale;
+		for( unsigned int octave = 0; octave < NUM_OCTAVES; ++octave )
+		{
+			unsigned int baseIndex = OCTAVE_PRIME * octave;
+			for( int d = 0; d < DIM; ++d )
+			{
+				int cell = 0;
+				LocateInCell( position[ d ], octaveFrequency, octave, cell, fractions[ octave ][ d ] );
+				baseIndex += AXIS_PRIMES[ d ] * (unsigned int) cell;
+			}
+
+			for( int corner = 0; corner < NUM_CORNERS; ++corner )
+			{
+				unsigned int index = baseIndex;
+				for( int d = 0; d < DIM; ++d )
+					index += ( corner & ( 1 << d ) ) ? AXIS_PRIMES[ d ] : 0;
+				cornerIndices[ octave * NUM_CORNERS + corner ] = (int) index;
+			}
+			octaveFrequency *= octaveScale;
+		}
+
+		unsigned int cornerHashes[ NUM_OCTAVES * NUM_CORNERS ];
+		Get1dNoiseUintBatch( cornerIndices, cornerHashes, NUM_OCTAVES * NUM_CORNERS, seed );
+
+		float totalNoise = 0.f;
+		float totalAmplitude = 0.f;
+		float amplitude = 1.f;
+		float totalDerivatives[ DIM ] = {};
+		float derivativeScale = 1.f / scale;	// Fractions move octaveFrequency times faster than the position
+		for( unsigned int octave = 0; octave < NUM_OCTAVES; ++octave )
+		{
+			float derivatives[ DIM ];
+			totalNoise += amplitude * NoiseInCell<DIM, GRADIENT, DERIVATIVES>( cornerHashes + octave * NUM_CORNERS, fractions[ octave ], derivatives );
+			if constexpr( DERIVATIVES )
+			{
+				for( int d = 0; d < DIM; ++d )
+					totalDerivatives[ d ] += amplitude * derivativeScale * derivatives[ d ];
+				derivativeScale *= octaveScale;
+			}
+			totalAmplitude += amplitude;
+			amplitude *= octavePersistence;
+		}
+
+		if constexpr( DERIVATIVES )
+		{
+			for( int d = 0; d < DIM; ++d )
+				out_derivatives[ d ] = renormalize ? totalDerivatives[ d ] / totalAmplitude : totalDerivatives[ d ];
+		}
+
+		return renormalize ? totalNoise / totalAmplitude : totalNoise;
+	}
+
+	//-------------------------------------------------------------------------------------------
+	// Grid evaluation for DIM = 2 or 3.  For every octave, the hashes of all the lattice corners
+	//	touched by the grid are generated once with Fill2dNoiseUint()/Fill3dNoiseUint() and
+	//	then looked up by every sample of the cells they belong to.
+	//
+	// Octaves with cells smaller than the sample spacing would need more lattice hashes than
+	//	samples, so those hash the corners of each sample directly instead.
+	//
+	// With DERIVATIVES, derivativeOuts[ d ] is a grid laid out like out that receives the partial
+	//	derivative with respect to axis d.
+	//
+	template<unsigned int NUM_OCTAVES, int DIM, bool GRADIENT, bool DERIVATIVES=false>
+	inline void FillFractal( const float* position, float step, const size_t* counts, const size_t* strides, float* out, float scale, float octavePersistence, float octaveScale, bool renormalize, unsigned int seed, float* const* derivativeOuts=nullptr )
+	{
+		static_assert( NUM_OCTAVES > 0, "At least one octave is required" );
+		static_assert( DIM == 2 || DIM == 3, "Grid fills are only available in 2D and 3D" );
+		assert( step > 0.f );
+		constexpr int NUM_CORNERS = 1 << DIM;
+
+		const size_t depth = ( DIM == 3 ) ? counts[ 2 ] : 1;
+		const size_t sliceStride = ( DIM == 3 ) ? strides[ 2 ] : 0;
+		if( counts[ 0 ] == 0 || counts[ 1 ] == 0 || depth == 0 )
+			return;
+
+		std::vector<int> cells[ DIM ];
+		std::vector<float> fractions[ DIM ];
+		std::vector<unsigned int> lattice;
+
+		float octaveFrequency = 1.f / scale;
+		float totalAmplitude = 0.f;
+		float amplitude = 1.f;
+		for( unsigned int octave = 0; octave < NUM_OCTAVES; ++octave )
+		{
+			// Cells and fractions only depend on one coordinate each, so compute them per axis
+			int latticeMin[ DIM ];
+			size_t latticeSize[ DIM ];
+			for( int d = 0; d < DIM; ++d )
+			{
+				cells[ d ].resize( counts[ d ] );
+				fractions[ d ].resize( counts[ d ] );
+				for( size_t i = 0; i < counts[ d ]; ++i )
+					LocateInCell( position[ d ] + step * (float) i, octaveFrequency, octave, cells[ d ][ i ], fractions[ d ][ i ] );
+				latticeMin[ d ] = cells[ d ].front();
+				latticeSize[ d ] = (size_t) ( (long long) cells[ d ].back() - latticeMin[ d ] ) + 2;
+			}
+
+			// Offsetting x0 by the octave term gives the same indices as ComputeFractal()
+			const size_t latticeCount = latticeSize[ 0 ] * latticeSize[ 1 ] * ( DIM == 3 ? latticeSize[ 2 ] : 1 );
+			const bool useLattice = latticeCount <= counts[ 0 ] * counts[ 1 ] * depth * NUM_CORNERS;
+			const int latticeX0 = (int) ( (unsigned int) latticeMin[ 0 ] + OCTAVE_PRIME * octave );
+			if( useLattice )
+			{
+				lattice.resize( latticeCount );
+				if constexpr( DIM == 2 )
+					Fill2dNoiseUint( latticeX0, latticeMin[ 1 ], latticeSize[ 0 ], latticeSize[ 1 ], latticeSize[ 0 ], seed, lattice.data() );
+				else
+					Fill3dNoiseUint( latticeX0, latticeMin[ 1 ], latticeMin[ 2 ], latticeSize[ 0 ], latticeSize[ 1 ], latticeSize[ 2 ], latticeSize[ 0 ], latticeSize[ 0 ] * latticeSize[ 1 ], seed, lattice.data() );
+			}
+
+			for( size_t z = 0; z < depth; ++z )
+			{
+				for( size_t y = 0; y < counts[ 1 ]; ++y )
+				{
+					float* rowOut = out + z * sliceStride + y * strides[ 1 ];
+					for( size_t x = 0; x < counts[ 0 ]; ++x )
+					{
+						size_t latticeOffset = (size_t) ( cells[ 0 ][ x ] - latticeMin[ 0 ] ) + (size_t) ( cells[ 1 ][ y ] - latticeMin[ 1 ] ) * latticeSize[ 0 ];
+						float sampleFractions[ DIM ] = { fractions[ 0 ][ x ], fractions[ 1 ][ y ] };
+						if constexpr( DIM == 3 )
+						{
+							latticeOffset += (size_t) ( cells[ 2 ][ z ] - latticeMin[ 2 ] ) * latticeSize[ 0 ] * latticeSize[ 1 ];
+							sampleFractions[ 2 ] = fractions[ 2 ][ z ];
+						}
+
+						unsigned int cornerHashes[ NUM_CORNERS ];
+						if( useLattice )
+						{
+							for( int corner = 0; corner < NUM_CORNERS; ++corner )
+							{
+								size_t cornerOffset = latticeOffset;
+								cornerOffset += ( corner & 1 ) ? 1 : 0;
+								cornerOffset += ( corner & 2 ) ? latticeSize[ 0 ] : 0;
+								if constexpr( DIM == 3 )
+									cornerOffset += ( corner & 4 ) ? latticeSize[ 0 ] * latticeSize[ 1 ] : 0;
+								cornerHashes[ corner ] = lattice[ cornerOffset ];
+							}
+						}
+						else
+						{
+							unsigned int baseIndex = (unsigned int) latticeX0 + ( (unsigned int) cells[ 0 ][ x ] - (unsigned int) latticeMin[ 0 ] ) + AXIS_PRIMES[ 1 ] * (unsigned int) cells[ 1 ][ y ];
+							if constexpr( DIM == 3 )
+								baseIndex += AXIS_PRIMES[ 2 ] * (unsigned int) cells[ 2 ][ z ];
+
+							int cornerIndices[ NUM_CORNERS ];
+							for( int corner = 0; corner < NUM_CORNERS; ++corner )
+							{
+								unsigned int index = baseIndex;
+								for( int d = 0; d < DIM; ++d )
+									index += ( corner & ( 1 << d ) ) ? AXIS_PRIMES[ d ] : 0;
+								cornerIndices[ corner ] = (int) index;
+							}
+							Get1dNoiseUintBatch( cornerIndices, cornerHashes, NUM_CORNERS, seed );
+						}
+
+						float derivatives[ DIM ];
+						const float noise = amplitude * NoiseInCell<DIM, GRADIENT, DERIVATIVES>( cornerHashes, sampleFractions, derivatives );
+						rowOut[ x * strides[ 0 ] ] = ( octave == 0 ) ? noise : rowOut[ x * strides[ 0 ] ] + noise;
+						if constexpr( DERIVATIVES )
+						{
+							const size_t sampleOffset = z * sliceStride + y * strides[ 1 ] + x * strides[ 0 ];
+							for( int d = 0; d < DIM; ++d )
+							{
+								const float derivative = amplitude * octaveFrequency * derivatives[ d ];
+								float& derivativeOut = derivativeOuts[ d ][ sampleOffset ];
+								derivativeOut = ( octave == 0 ) ? derivative : derivativeOut + derivative;
+							}
+						}
+					}
+				}
+			}
+
+			totalAmplitude += amplitude;
+			amplitude *= octavePersistence;
+			octaveFrequency *= octaveScale;
+		}
+
+		if( !renormalize )
+			return;
+
+		for( size_t z = 0; z < depth; ++z )
+		{
+			for( size_t y = 0; y < counts[ 1 ]; ++y )
+			{
+				float* rowOut = out + z * sliceStride + y * strides[ 1 ];
+				for( size_t x = 0; x < counts[ 0 ]; ++x )
+					rowOut[ x * strides[ 0 ] ] /= totalAmplitude;
+
+				if constexpr( DERIVATIVES )
+				{
+					for( int d = 0; d < DIM; ++d )
+					{
+						float* derivativeRow = derivativeOuts[ d ] + z * sliceStride + y * strides[ 1 ];
+						for( size_t x = 0; x < counts[ 0 ]; ++x )
+							derivativeRow[ x * strides[ 0 ] ] /= totalAmplitude;
+					}
+				}
+			}
+		}
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+template<unsigned int NUM_OCTAVES>
+inline float Compute1dFractalNoise( float posX, float scale, float octavePersistence, float octaveScale, bool renormalize, unsigned int seed )
+{
+	const float position[ 1 ] = { posX };
+	return SquirrelNoise5Smooth::ComputeFractal<NUM_OCTAVES, 1, false>( position, scale, octavePersistence, octaveScale, renormalize, seed );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+template<unsigned int NUM_OCTAVES>
+inline float Compute2dFractalNoise( float posX, float posY, float scale, float octavePersistence, float octaveScale, bool renormalize, unsigned int seed )
+{
+	const float position[ 2 ] = { posX, posY };
+	return SquirrelNoise5Smooth::ComputeFractal<NUM_OCTAVES, 2, false>( position, scale, octavePersistence, octaveScale, renormalize, seed );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+template<unsigned int NUM_OCTAVES>
+inline float Compute3dFractalNoise( float posX, float posY, float posZ, float scale, float octavePersistence, float octaveScale, bool renormalize, unsigned int seed )
+{
+	const float position[ 3 ] = { posX, posY, posZ };
+	return SquirrelNoise5Smooth::ComputeFractal<NUM_OCTAVES, 3, false>( position, scale, octavePersistence, octaveScale, renormalize, seed );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+template<unsigned int NUM_OCTAVES>
+inline float Compute4dFractalNoise( float posX, float posY, float posZ, float posT, float scale, float octavePersistence, float octaveScale, bool renormalize, unsigned int seed )
+{
+	const float position[ 4 ] = { posX, posY, posZ, posT };
+	return SquirrelNoise5Smooth::ComputeFractal<NUM_OCTAVES, 4, false>( position, scale, octavePersistence, octaveScale, renormalize, seed );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+template<unsigned int NUM_OCTAVES>
+inline float Compute1dPerlinNoise( float posX, float scale, float octavePersistence, float octaveScale, bool renormalize, unsigned int seed )
+{
+	const float position[ 1 ] = { posX };
+	return SquirrelNoise5Smooth::ComputeFractal<NUM_OCTAVES, 1, true>( position, scale, octavePersistence, octaveScale, renormalize, seed );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+template<unsigned int NUM_OCTAVES>
+inline float Compute2dPerlinNoise( float posX, float posY, float scale, float octavePersistence, float octaveScale, bool renormalize, unsigned int seed )
+{
+	const float position[ 2 ] = { posX, posY };
+	return SquirrelNoise5Smooth::ComputeFractal<NUM_OCTAVES, 2, true>( position, scale, octavePersistence, octaveScale, renormalize, seed );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+template<unsigned int NUM_OCTAVES>
+inline float Compute3dPerlinNoise( float posX, float posY, float posZ, float scale, float octavePersistence, float octaveScale, bool renormalize, unsigned int seed )
+{
+	const float position[ 3 ] = { posX, posY, posZ };
+	return SquirrelNoise5Smooth::ComputeFractal<NUM_OCTAVES, 3, true>( position, scale, octavePersistence, octaveScale, renormalize, seed );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+template<unsigned int NUM_OCTAVES>
+inline float Compute4dPerlinNoise( float posX, float posY, float posZ, float posT, float scale, float octavePersistence, float octaveScale, bool renormalize, unsigned int seed )
+{
+	const float position[ 4 ] = { posX, posY, posZ, posT };
+	return SquirrelNoise5Smooth::ComputeFractal<NUM_OCTAVES, 4, true>( position, scale, octavePersistence, octaveScale, renormalize, seed );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+template<unsigned int NUM_OCTAVES>
+inline void Fill2dFractalNoise( float posX, float posY, float step, size_t width, size_t height, size_t stride, float* out, float scale, float octavePersistence, float octaveScale, bool renormalize, unsigned int seed )
+{
+	const float position[ 2 ] = { posX, posY };
+	const size_t counts[ 2 ] = { width, height };
+	const size_t strides[ 2 ] = { 1, stride };
+	SquirrelNoise5Smooth::FillFractal<NUM_OCTAVES, 2, false>( position, step, counts, strides, out, scale, octavePersistence, octaveScale, renormalize, seed );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+template<unsigned int NUM_OCTAVES>
+inline void Fill3dFractalNoise( float posX, float posY, float posZ, float step, size_t width, size_t height, size_t depth, size_t rowStride, size_t sliceStride, float* out, float scale, float octavePersistence, float octaveScale, bool renormalize, unsigned int seed )
+{
+	const float position[ 3 ] = { posX, posY, posZ };
+	const size_t counts[ 3 ] = { width, height, depth };
+	const size_t strides[ 3 ] = { 1, rowStride, sliceStride };
+	SquirrelNoise5Smooth::FillFractal<NUM_OCTAVES, 3, false>( position, step, counts, strides, out, scale, octavePersistence, octaveScale, renormalize, seed );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+template<unsigned int NUM_OCTAVES>
+inline void Fill2dPerlinNoise( float posX, float posY, float step, size_t width, size_t height, size_t stride, float* out, float scale, float octavePersistence, float octaveScale, bool renormalize, unsigned int seed )
+{
+	const float position[ 2 ] = { posX, posY };
+	const size_t counts[ 2 ] = { width, height };
+	const size_t strides[ 2 ] = { 1, stride };
+	SquirrelNoise5Smooth::FillFractal<NUM_OCTAVES, 2, true>( position, step, counts, strides, out, scale, octavePersistence, octaveScale, renormalize, seed );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+template<unsigned int NUM_OCTAVES>
+inline void Fill3dPerlinNoise( float posX, float posY, float posZ, float step, size_t width, size_t height, size_t depth, size_t rowStride, size_t sliceStride, float* out, float scale, float octavePersistence, float octaveScale, bool renormalize, unsigned int seed )
+{
+	const float position[ 3 ] = { posX, posY, posZ };
+	const size_t counts[ 3 ] = { width, height, depth };
+	const size_t strides[ 3 ] = { 1, rowStride, sliceStride };
+	SquirrelNoise5Smooth::FillFractal<NUM_OCTAVES, 3, true>( position, step, counts, strides, out, scale, octavePersistence, octaveScale, renormalize, seed );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+template<unsigned int NUM_OCTAVES>
+inline float Compute2dFractalNoiseAndDerivatives( float posX, float posY, float& out_dx, float& out_dy, float scale, float octavePersistence, float octaveScale, bool renormalize, unsigned int seed )
+{
+	const float position[ 2 ] = { posX, posY };
+	float derivatives[ 2 ];
+	const float noise = SquirrelNoise5Smooth::ComputeFractal<NUM_OCTAVES, 2, false, true>( position, scale, octavePersistence, octaveScale, renormalize, seed, derivatives );
+	out_dx = derivatives[ 0 ];
+	out_dy = derivatives[ 1 ];
+	return noise;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+template<unsigned int NUM_OCTAVES>
+inline float Compute3dFractalNoiseAndDerivatives( float posX, float posY, float posZ, float& out_dx, float& out_dy, float& out_dz, float scale, float octavePersistence, float octaveScale, bool renormalize, unsigned int seed )
+{
+	const float position[ 3 ] = { posX, posY, posZ };
+	float derivatives[ 3 ];
+	const float noise = SquirrelNoise5Smooth::ComputeFractal<NUM_OCTAVES, 3, false, true>( position, scale, octavePersistence, octaveScale, renormalize, seed, derivatives );
+	out_dx = derivatives[ 0 ];
+	out_dy = derivatives[ 1 ];
+	out_dz = derivatives[ 2 ];
+	return noise;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+template<unsigned int NUM_OCTAVES>
+inline float Compute2dPerlinNoiseAndDerivatives( float posX, float posY, float& out_dx, float& out_dy, float scale, float octavePersistence, float octaveScale, bool renormalize, unsigned int seed )
+{
+	const float position[ 2 ] = { posX, posY };
+	float derivatives[ 2 ];
+	const float noise = SquirrelNoise5Smooth::ComputeFractal<NUM_OCTAVES, 2, true, true>( position, scale, octavePersistence, octaveScale, renormalize, seed, derivatives );
+	out_dx = derivatives[ 0 ];
+	out_dy = derivatives[ 1 ];
+	return noise;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+template<unsigned int NUM_OCTAVES>
+inline float Compute3dPerlinNoiseAndDerivatives( float posX, float posY, float posZ, float& out_dx, float& out_dy, float& out_dz, float scale, float octavePersistence, float octaveScale, bool renormalize, unsigned int seed )
+{
+	const float position[ 3 ] = { posX, posY, posZ };
+	float derivatives[ 3 ];
+	const float noise = SquirrelNoise5Smooth::ComputeFractal<NUM_OCTAVES, 3, true, true>( position, scale, octavePersistence, octaveScale, renormalize, seed, derivatives );
+	out_dx = derivatives[ 0 ];
+	out_dy = derivatives[ 1 ];
+	out_dz = derivatives[ 2 ];
+	return noise;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+template<unsigned int NUM_OCTAVES>
+inline void Fill2dFractalNoiseAndDerivatives( float posX, float posY, float step, size_t width, size_t height, size_t stride, float* out, float* out_dx, float* out_dy, float scale, float octavePersistence, float octaveScale, bool renormalize, unsigned int seed )
+{
+	const float position[ 2 ] = { posX, posY };
+	const size_t counts[ 2 ] = { width, height };
+	const size_t strides[ 2 ] = { 1, stride };
+	float* const derivativeOuts[ 2 ] = { out_dx, out_dy };
+	SquirrelNoise5Smooth::FillFractal<NUM_OCTAVES, 2, false, true>( position, step, counts, strides, out, scale, octavePersistence, octaveScale, renormalize, seed, derivativeOuts );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+template<unsigned int NUM_OCTAVES>
+inline void Fill3dFractalNoiseAndDerivatives( float posX, float posY, float posZ, float step, size_t width, size_t height, size_t depth, size_t rowStride, size_t sliceStride, float* out, float* out_dx, float* out_dy, float* out_dz, float scale, float octavePersistence, float octaveScale, bool renormalize, unsigned int seed )
+{
+	const float position[ 3 ] = { posX, posY, posZ };
+	const size_t counts[ 3 ] = { width, height, depth };
+	const size_t strides[ 3 ] = { 1, rowStride, sliceStride };
+	float* const derivativeOuts[ 3 ] = { out_dx, out_dy, out_dz };
+	SquirrelNoise5Smooth::FillFractal<NUM_OCTAVES, 3, false, true>( position, step, counts, strides, out, scale, octavePersistence, octaveScale, renormalize, seed, derivativeOuts );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+template<unsigned int NUM_OCTAVES>
+inline void Fill2dPerlinNoiseAndDerivatives( float posX, float posY, float step, size_t width, size_t height, size_t stride, float* out, float* out_dx, float* out_dy, float scale, float octavePersistence, float octaveScale, bool renormalize, unsigned int seed )
+{
+	const float position[ 2 ] = { posX, posY };
+	const size_t counts[ 2 ] = { width, height };
+	const size_t strides[ 2 ] = { 1, stride };
+	float* const derivativeOuts[ 2 ] = { out_dx, out_dy };
+	SquirrelNoise5Smooth::FillFractal<NUM_OCTAVES, 2, true, true>( position, step, counts, strides, out, scale, octavePersistence, octaveScale, renormalize, seed, derivativeOuts );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+template<unsigned int NUM_OCTAVES>
+inline void Fill3dPerlinNoiseAndDerivatives( float posX, float posY, float posZ, float step, size_t width, size_t height, size_t depth, size_t rowStride, size_t sliceStride, float* out, float* out_dx, float* out_dy, float* out_dz, float scale, float octavePersistence, float octaveScale, bool renormalize, unsigned int seed )
+{
+	const float position[ 3 ] = { posX, posY, posZ };
+	const size_t counts[ 3 ] = { width, height, depth };
+	const size_t strides[ 3 ] = { 1, rowStride, sliceStride };
+	float* const derivativeOuts[ 3 ] = { out_dx, out_dy, out_dz };
+	SquirrelNoise5Smooth::FillFractal<NUM_OCTAVES, 3, true, true>( position, step, counts, strides, out, scale, octavePersistence, octaveScale, renormalize, seed, derivativeOuts );
+}
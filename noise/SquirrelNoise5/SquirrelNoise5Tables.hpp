@@ -0,0 +1,122 @@
+//-----------------------------------------------------------------------------------------------
+// SquirrelNoise5Tables.hpp
+//
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include "SquirrelNoise5.hpp"
+#include "SquirrelRng.hpp"
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+// SquirrelNoise5Tables - Compile-time noise tables (C++17)
+//
+// Since all the noise functions are constexpr, fixed tables (dither patterns, jitter tables,
+//	seeded permutations...) can be generated entirely by the compiler.  Declare the result as a
+//	constexpr variable to have it end up in read-only data with zero startup cost:
+//
+//		constexpr auto DITHER = MakeNoiseTile2dZeroToOne<64, 64, 1234>();
+//		constexpr auto PERMUTATION = MakePermutationTable<256, 42>();
+//
+// Compilers cap how much work a constant expression may do, each in its own unit:
+//	- MSVC counts evaluation steps, about 15 per entry (a permutation entry a bit more).  The
+//	  default /constexpr:steps100000 only fits ~6K entries; pass about 16 steps per entry for
+//	  bigger tables (e.g. /constexpr:steps1100000 for 64K entries).
+//	- GCC's default -fconstexpr-ops-limit=33554432 fits tables and permutations of 64K entries
+//	  (128K no longer fit, measured with GCC 12); raise it for anything bigger.
+//	- clang's default -fconstexpr-steps=1048576 also limits the table size; raise it (or split
+//	  the table) if a large table fails to compile.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//-----------------------------------------------------------------------------------------------
+// TABLE[ i ] = Get1dNoiseUint( i, SEED ) (or Get1dNoiseZeroToOne) for i in [0, N)
+//
+template<size_t N, unsigned int SEED=0> constexpr std::array<uint32_t, N> MakeNoiseTable();
+template<size_t N, unsigned int SEED=0> constexpr std::array<float, N> MakeNoiseTableZeroToOne();
+
+//-----------------------------------------------------------------------------------------------
+// TILE[ y*W + x ] = Get2dNoiseUint( x, y, SEED ) (or Get2dNoiseZeroToOne) in row-major order
+//
+template<size_t W, size_t H, unsigned int SEED=0> constexpr std::array<uint32_t, W * H> MakeNoiseTile2d();
+template<size_t W, size_t H, unsigned int SEED=0> constexpr std::array<float, W * H> MakeNoiseTile2dZeroToOne();
+
+//-----------------------------------------------------------------------------------------------
+// A seeded random permutation of [0, N), shuffled with Fisher-Yates using SquirrelRng( SEED ).
+//
+template<size_t N, unsigned int SEED=0> constexpr std::array<uint32_t, N> MakePermutationTable();
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+// Inline function definitions below
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------------------------
+template<size_t N, unsigned int SEED>
+constexpr std::array<uint32_t, N> MakeNoiseTable()
+{
+	std::array<uint32_t, N> table{};
+	for( size_t i = 0; i < N; ++i )
+		table[ i ] = Get1dNoiseUint( (int) i, SEED );
+	return table;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+template<size_t N, unsigned int SEED>
+constexpr std::array<float, N> MakeNoiseTableZeroToOne()
+{
+	std::array<float, N> table{};
+	for( size_t i = 0; i < N; ++i )
+		table[ i ] = Get1dNoiseZeroToOne( (int) i, SEED );
+	return table;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+template<size_t W, size_t H, unsigned int SEED>
+constexpr std::array<uint32_t, W * H> MakeNoiseTile2d()
+{
+	std::array<uint32_t, W * H> tile{};
+	for( size_t y = 0; y < H; ++y )
+		for( size_t x = 0; x < W; ++x )
+			tile[ y * W + x ] = Get2dNoiseUint( (int) x, (int) y, SEED );
+	return tile;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+template<size_t W, size_t H, unsigned int SEED>
+constexpr std::array<float, W * H> MakeNoiseTile2dZeroToOne()
+{
+	std::array<float, W * H> tile{};
+	for( size_t y = 0; y < H; ++y )
+		for( size_t x = 0; x < W; ++x )
+			tile[ y * W + x ] = Get2dNoiseZeroToOne( (int) x, (int) y, SEED );
+	return tile;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+template<size_t N, unsigned int SEED>
+constexpr std::array<uint32_t, N> MakePermutationTable()
+{
+	static_assert( N <= 0x7FFFFFFF, "Permutation tables are limited to 2^31 - 1 entries" );
+
+	std::array<uint32_t, N> table{};
+	for( size_t i = 0; i < N; ++i )
+		table[ i ] = (uint32_t) i;
+
+	SquirrelRng rng( SEED );
+	for( size_t i = N; i > 1; --i )
+	{
+		const size_t j = (size_t) rng.RollRandomIntLessThan( (int) i );
+		const uint32_t swapped = table[ i - 1 ];
+		table[ i - 1 ] = table[ j ];
+		table[ j ] = swapped;
+	}
+	return table;
+}
@@ -0,0 +1,646 @@
+//-----------------------------------------------------------------------------------------------
+// SquirrelNoise5TileCache.hpp
+//
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "SquirrelNoise5.hpp"
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+// SquirrelNoise5TileCache - Thread-safe LRU cache for expensive noise tiles
+//
+// Raw noise is cheaper to recompute than to cache, but composed noise (many fBm octaves, domain
+//	warping, erosion...) isn't.  noise::TileCache keeps generated tiles of such noise, keyed by
+//	(generator id, seed, LOD, tile coordinate), so that overlapping requests from frame to frame
+//	only pay for the tiles they haven't seen before:
+//
+//		noise::TileCache cache( 64 * 64, 256 << 20, []( const noise::TileKey& key, float* out, size_t )
+//		{
+//			const float step = (float)( 1 << key.lod );
+//			Fill2dPerlinNoise<6>( key.tileX * 64 * step, key.tileY * 64 * step, step, 64, 64, 64, out, 250.f, 0.5f, 2.f, true, key.seed );
+//		} );
+//		noise::TileHandle tile = cache.Acquire( key );		// Generates the tile on a miss
+//		const float* heights = tile.GetData();
+//
+// The cache is split into shards, each with its own lock, LRU list and share of the byte budget.
+//	Tile storage comes from slabs that are reused as tiles are evicted, so a warm cache does no
+//	allocations.  A tile is pinned while any TileHandle refers to it: pinned tiles are never
+//	evicted or overwritten, and evicted/invalidated tiles are recycled when their last handle
+//	goes away.  When two threads miss the same tile, only one of them generates it.
+//
+// The generator is called from any thread that misses (and from the prefetch threads), so it
+//	must be thread-safe.  It gets the whole key, so a single cache can hold the output of several
+//	generators, told apart by key.generatorId.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace noise
+{
+	//-------------------------------------------------------------------------------------------
+	struct TileKey
+	{
+		unsigned int generatorId = 0;
+		unsigned int seed = 0;
+		int lod = 0;
+		int tileX = 0, tileY = 0, tileZ = 0;
+
+		bool operator==( const TileKey& other ) const;
+		bool operator!=( const TileKey& other ) const { return !( *this == other ); }
+	};
+
+	//-------------------------------------------------------------------------------------------
+	struct TileKeyHash
+	{
+		size_t operator()( const TileKey& key ) const;
+	};
+
+	//-------------------------------------------------------------------------------------------
+	struct TileCacheStats
+	{
+		uint64_t hits = 0;
+		uint64_t misses = 0;			// Tiles generated by Acquire()
+		uint64_t prefetches = 0;		// Tiles generated by the prefetch threads
+		uint64_t evictions = 0;
+		size_t tileCount = 0;			// Tiles currently cached
+		size_t allocatedBytes = 0;		// Tile storage, including recycled slots
+	};
+
+	class TileCache;
+
+	//-------------------------------------------------------------------------------------------
+	// Keeps a tile pinned (and its data valid) for as long as it exists.  Move-only, and cheap.
+	//
+	class TileHandle
+	{
+	public:
+		TileHandle() = default;
+		TileHandle( TileHandle&& other ) noexcept;
+		TileHandle& operator=( TileHandle&& other ) noexcept;
+		~TileHandle();
+
+		TileHandle( const TileHandle& ) = delete;
+		TileHandle& operator=( const TileHandle& ) = delete;
+
+		const float* GetData() const;
+		size_t GetSize() const;
+		explicit operator bool() const { return m_slot != nullptr; }
+		void Reset();
+
+	private:
+		friend class TileCache;
+		struct Slot;
+		TileHandle( TileCache* cache, Slot* slot ) : m_cache( cache ), m_slot( slot ) {}
+
+		TileCache* m_cache = nullptr;
+		Slot* m_slot = nullptr;
+	};
+
+
+	//-------------------------------------------------------------------------------------------
+	class TileCache
+	{
+	public:
+		// Fills out[ 0, elementCount ) with the tile for key.
+		typedef std::function<void( const TileKey& key, float* out, size_t elementCount )> Generator;
+
+		static constexpr size_t SLAB_TILES = 16;			// Tiles allocated at once when a shard grows
+
+		// tileElements floats per tile; byteBudget bounds the tile storage (at least one tile per
+		//	shard is always kept).  shardCount 0 picks one from the hardware concurrency, and
+		//	prefetchThreadCount background threads serve Prefetch() (0 disables it).
+		TileCache( size_t tileElements, size_t byteBudget, Generator generator, unsigned int shardCount = 0, unsigned int prefetchThreadCount = 1 );
+		~TileCache();
+
+		TileCache( const TileCache& ) = delete;
+		TileCache& operator=( const TileCache& ) = delete;
+
+		size_t GetTileElements() const { return m_tileElements; }
+
+		// Returns the tile, generating it first on a miss.  If the generator throws, nothing is
+		//	cached and the exception propagates.
+		TileHandle Acquire( const TileKey& key );
+
+		// Returns the tile only if it is cached and ready; never generates.
+		TileHandle TryAcquire( const TileKey& key );
+
+		// Queues tiles to be generated in the background, e.g. the ones the camera will need next
+		//	frame.  Tiles already cached are skipped.  Without prefetch threads this does nothing.
+		void Prefetch( const TileKey* keys, size_t count );
+		void WaitForPrefetches();
+
+		// Drops the cached tiles of one generator/seed/LOD inside [ min, max ] (inclusive), or every
+		//	tile.  Handles acquired before the call keep their data until they are released.
+		void InvalidateRegion( unsigned int generatorId, unsigned int seed, int lod, int minX, int minY, int minZ, int maxX, int maxY, int maxZ );
+		void Clear();
+
+		TileCacheStats GetStats() const;
+
+	private:
+		friend class TileHandle;
+		typedef TileHandle::Slot Slot;
+		struct Shard;
+
+		TileHandle AcquireInternal( const TileKey& key, bool prefetch );
+		Shard& GetShard( const TileKey& key ) const;
+		template<typename Predicate> void Invalidate( Predicate predicate );
+		Slot* AllocateSlot( Shard& shard );
+		void Uncache( Shard& shard, Slot* slot );
+		void Release( Slot* slot );
+		void ReleaseLocked( Shard& shard, Slot* slot );
+		void PrefetchMain();
+
+		size_t m_tileElements = 0;
+		Generator m_generator;
+		std::vector<std::unique_ptr<Shard>> m_shards;
+
+		std::mutex m_prefetchMutex;
+		std::condition_variable m_prefetchCondition;
+		std::condition_variable m_prefetchIdleCondition;
+		std::deque<TileKey> m_prefetchQueue;
+		size_t m_prefetchBusy = 0;
+		bool m_quit = false;
+		std::vector<std::thread> m_prefetchThreads;
+	};
+
+
+	//-------------------------------------------------------------------------------------------
+	struct TileHandle::Slot
+	{
+		TileKey key;
+		float* data = nullptr;
+		Slot* prev = nullptr;							// LRU list while cached (head is the most recent),
+		Slot* next = nullptr;							//	free list otherwise
+		size_t shardIndex = 0;
+		unsigned int pins = 0;
+		bool ready = false;
+		bool cached = false;
+	};
+
+
+	//-------------------------------------------------------------------------------------------
+	struct TileCache::Shard
+	{
+		mutable std::mutex mutex;
+		std::condition_variable readyCondition;			// A pending tile became ready or was dropped
+		std::unordered_map<TileKey, Slot*, TileKeyHash> tiles;
+		std::deque<Slot> slots;							// Stable addresses
+		std::vector<std::unique_ptr<float[]>> slabs;
+		Slot* freeList = nullptr;
+		Slot* lruHead = nullptr;
+		Slot* lruTail = nullptr;
+		size_t index = 0;
+		size_t capacity = 1;							// Tiles
+		size_t cachedCount = 0;
+		uint64_t hits = 0;
+		uint64_t misses = 0;
+		uint64_t prefetches = 0;
+		uint64_t evictions = 0;
+	};
+}
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+// Inline function definitions below
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace noise
+{
+	//-------------------------------------------------------------------------------------------
+	inline bool TileKey::operator==( const TileKey& other ) const
+	{
+		return generatorId == other.generatorId && seed == other.seed && lod == other.lod
+			&& tileX == other.tileX && tileY == other.tileY && tileZ == other.tileZ;
+	}
+
+	//-------------------------------------------------------------------------------------------
+	inline size_t TileKeyHash::operator()( const TileKey& key ) const
+	{
+		const unsigned int position = Get3dNoiseUint( key.tileX, key.tileY, key.tileZ, key.seed );
+		return Get2dNoiseUint( (int) position, key.lod, key.generatorId );
+	}
+
+
+	//-------------------------------------------------------------------------------------------
+	inline TileHandle::TileHandle( TileHandle&& other ) noexcept
+		: m_cache( other.m_cache ), m_slot( other.m_slot )
+	{
+		other.m_cache = nullptr;
+		other.m_slot = nullptr;
+	}
+
+	//-------------------------------------------------------------------------------------------
+	inline TileHandle& TileHandle::operator=( TileHandle&& other ) noexcept
+	{
+		if( this != &other )
+		{
+			Reset();
+			m_cache = other.m_cache;
+			m_slot = other.m_slot;
+			other.m_cache = nullptr;
+			other.m_slot = nullptr;
+		}
+		return *this;
+	}
+
+	//-------------------------------------------------------------------------------------------
+	inline TileHandle::~TileHandle()
+	{
+		Reset();
+	}
+
+	//-------------------------------------------------------------------------------------------
+	inline const float* TileHandle::GetData() const
+	{
+		return m_slot ? m_slot->data : nullptr;
+	}
+
+	//-------------------------------------------------------------------------------------------
+	inline size_t TileHandle::GetSize() const
+	{
+		return m_slot ? m_cache->m_tileElements : 0;
+	}
+
+	//-------------------------------------------------------------------------------------------
+	inline void TileHandle::Reset()
+	{
+		if( m_slot )
+			m_cache->Release( m_slot );
+		m_cache = nullptr;
+		m_slot = nullptr;
+	}
+
+
+	//-------------------------------------------------------------------------------------------
+	inline TileCache::TileCache( size_t tileElements, size_t byteBudget, Generator generator, unsigned int shardCount, unsigned int prefetchThreadCount )
+		: m_tileElements( tileElements ? tileElements : 1 ), m_generator( std::move( generator ) )
+	{
+		if( shardCount == 0 )
+			shardCount = 2 * std::thread::hardware_concurrency();
+		if( shardCount == 0 )
+			shardCount = 1;
+
+		// Every shard keeps at least one tile, so don't make more shards than the budget can hold
+		const size_t budgetTiles = byteBudget / ( m_tileElements * sizeof( float ) );
+		if( budgetTiles < shardCount )
+			shardCount = budgetTiles ? (unsigned int) budgetTiles : 1;
+
+		m_shards.reserve( shardCount );
+		for( unsigned int i = 0; i < shardCount; ++i )
+		{
+			m_shards.emplace_back( new Shard );
+			m_shards.back()->index = i;
+			m_shards.back()->capacity = budgetTiles * ( i + 1 ) / shardCount - budgetTiles * i / shardCount;
+			if( m_shards.back()->capacity == 0 )
+				m_shards.back()->capacity = 1;
+		}
+
+		m_prefetchThreads.reserve( prefetchThreadCount );
+		for( unsigned int i = 0; i < prefetchThreadCount; ++i )
+			m_prefetchThreads.emplace_back( &TileCache::PrefetchMain, this );
+	}
+
+	//-------------------------------------------------------------------------------------------
+	inline TileCache::~TileCache()
+	{
+		{
+			std::lock_guard<std::mutex> lock( m_prefetchMutex );
+			m_quit = true;
+			m_prefetchQueue.clear();
+		}
+		m_prefetchCondition.notify_all();
+		for( std::thread& thread : m_prefetchThreads )
+			thread.join();
+	}
+
+	//-------------------------------------------------------------------------------------------
+	inline TileHandle TileCache::Acquire( const TileKey& key )
+	{
+		return AcquireInternal( key, false );
+	}
+
+	//-------------------------------------------------------------------------------------------
+	inline TileHandle TileCache::TryAcquire( const TileKey& key )
+	{
+		Shard& shard = GetShard( key );
+		std::lock_guard<std::mutex> lock( shard.mutex );
+		const auto it = shard.tiles.find( key );
+		if( it == shard.tiles.end() || !it->second->ready )
+			return TileHandle();
+
+		Slot* slot = it->second;
+		++slot->pins;
+		++shard.hits;
+		return TileHandle( this, slot );
+	}
+
+	//-------------------------------------------------------------------------------------------
+	inline TileHandle TileCache::AcquireInternal( const TileKey& key, bool prefetch )
+	{
+		Shard& shard = GetShard( key );
+		std::unique_lock<std::mutex> lock( shard.mutex );
+
+		for( ;; )
+		{
+			const auto it = shard.tiles.find( key );
+			if( it == shard.tiles.end() )
+				break;
+
+			// Pinning a pending tile keeps it alive while we wait for whoever is generating it
+			Slot* slot = it->second;
+			++slot->pins;
+			if( !slot->ready )
+				shard.readyCondition.wait( lock, [ slot ] { return slot->ready || !slot->cached; } );
+
+			if( slot->ready )
+			{
+				if( slot->cached && slot != shard.lruHead )
+				{
+					// Move to the front of the LRU list
+					slot->prev->next = slot->next;
+					if( slot->next )
+						slot->next->prev = slot->prev;
+					else
+						shard.lruTail = slot->prev;
+					slot->prev = nullptr;
+					slot->next = shard.lruHead;
+					shard.lruHead->prev = slot;
+					shard.lruHead = slot;
+				}
+				if( !prefetch )
+					++shard.hits;
+				return TileHandle( this, slot );
+			}
+
+			// Generation failed, or the tile was invalidated before it was done: try again
+			ReleaseLocked( shard, slot );
+		}
+
+		Slot* slot = AllocateSlot( shard );
+		slot->key = key;
+		slot->pins = 1;
+		slot->ready = false;
+		slot->cached = true;
+		slot->prev = nullptr;
+		slot->next = shard.lruHead;
+		if( shard.lruHead )
+			shard.lruHead->prev = slot;
+		else
+			shard.lruTail = slot;
+		shard.lruHead = slot;
+		shard.tiles.emplace( key, slot );
+		++shard.cachedCount;
+		if( prefetch )
+			++shard.prefetches;
+		else
+			++shard.misses;
+		lock.unlock();
+
+		try
+		{
+			m_generator( key, slot->data, m_tileElements );
+		}
+		catch( ... )
+		{
+			lock.lock();
+			if( slot->cached )
+				Uncache( shard, slot );
+			ReleaseLocked( shard, slot );
+			lock.unlock();
+			shard.readyCondition.notify_all();
+			throw;
+		}
+
+		lock.lock();
+		slot->ready = true;
+		lock.unlock();
+		shard.readyCondition.notify_all();
+		return TileHandle( this, slot );
+	}
+
+	//-------------------------------------------------------------------------------------------
+	inline void TileCache::Prefetch( const TileKey* keys, size_t count )
+	{
+		if( m_prefetchThreads.empty() || count == 0 )
+			return;
+
+		{
+			std::lock_guard<std::mutex> lock( m_prefetchMutex );
+			for( size_t i = 0; i < count; ++i )
+				m_prefetchQueue.push_back( keys[ i ] );
+		}
+		m_prefetchCondition.notify_all();
+	}
+
+	//-------------------------------------------------------------------------------------------
+	inline void TileCache::WaitForPrefetches()
+	{
+		std::unique_lock<std::mutex> lock( m_prefetchMutex );
+		m_prefetchIdleCondition.wait( lock, [ this ] { return m_prefetchQueue.empty() && m_prefetchBusy == 0; } );
+	}
+
+	//-------------------------------------------------------------------------------------------
+	inline void TileCache::InvalidateRegion( unsigned int generatorId, unsigned int seed, int lod, int minX, int minY, int minZ, int maxX, int maxY, int maxZ )
+	{
+		Invalidate( [ & ]( const TileKey& key )
+		{
+			return key.generatorId == generatorId && key.seed == seed && key.lod == lod
+				&& key.tileX >= minX && key.tileX <= maxX
+				&& key.tileY >= minY && key.tileY <= maxY
+				&& key.tileZ >= minZ && key.tileZ <= maxZ;
+		} );
+	}
+
+	//-------------------------------------------------------------------------------------------
+	inline void TileCache::Clear()
+	{
+		Invalidate( []( const TileKey& ) { return true; } );
+	}
+
+	//-------------------------------------------------------------------------------------------
+	inline TileCacheStats TileCache::GetStats() const
+	{
+		TileCacheStats stats;
+		for( const std::unique_ptr<Shard>& shard : m_shards )
+		{
+			std::lock_guard<std::mutex> lock( shard->mutex );
+			stats.hits += shard->hits;
+			stats.misses += shard->misses;
+			stats.prefetches += shard->prefetches;
+			stats.evictions += shard->evictions;
+			stats.tileCount += shard->cachedCount;
+			stats.allocatedBytes += shard->slots.size() * m_tileElements * sizeof( float );
+		}
+		return stats;
+	}
+
+	//-------------------------------------------------------------------------------------------
+	inline TileCache::Shard& TileCache::GetShard( const TileKey& key ) const
+	{
+		// High bits, since the unordered_map buckets use the low ones
+		const uint64_t hash = (uint32_t) TileKeyHash()( key );
+		return *m_shards[ (size_t)( ( hash * m_shards.size() ) >> 32 ) ];
+	}
+
+	//-------------------------------------------------------------------------------------------
+	template<typename Predicate>
+	inline void TileCache::Invalidate( Predicate predicate )
+	{
+		for( const std::unique_ptr<Shard>& shard : m_shards )
+		{
+			bool droppedPending = false;
+			{
+				std::lock_guard<std::mutex> lock( shard->mutex );
+				for( auto it = shard->tiles.begin(); it != shard->tiles.end(); )
+				{
+					Slot* slot = it->second;
+					++it;
+					if( predicate( slot->key ) )
+					{
+						droppedPending |= !slot->ready;
+						Uncache( *shard, slot );
+						if( slot->pins == 0 )
+							ReleaseLocked( *shard, slot );
+					}
+				}
+			}
+			if( droppedPending )
+				shard->readyCondition.notify_all();
+		}
+	}
+
+	//-------------------------------------------------------------------------------------------
+	// Takes a slot from the free list, evicting the least recently used unpinned tile first if
+	//	the shard is full.  Only grows past the budget when every cached tile is pinned.
+	//
+	inline TileHandle::Slot* TileCache::AllocateSlot( Shard& shard )
+	{
+		if( shard.cachedCount >= shard.capacity )
+		{
+			for( Slot* victim = shard.lruTail; victim; victim = victim->prev )
+			{
+				if( victim->pins == 0 )
+				{
+					Uncache( shard, victim );
+					ReleaseLocked( shard, victim );
+					++shard.evictions;
+					break;
+				}
+			}
+		}
+
+		if( !shard.freeList )
+		{
+			const size_t remaining = ( shard.slots.size() < shard.capacity ) ? shard.capacity - shard.slots.size() : 1;
+			const size_t slabTiles = ( remaining < SLAB_TILES ) ? remaining : SLAB_TILES;
+			shard.slabs.emplace_back( new float[ slabTiles * m_tileElements ] );
+			for( size_t i = 0; i < slabTiles; ++i )
+			{
+				shard.slots.emplace_back();
+				Slot* slot = &shard.slots.back();
+				slot->data = shard.slabs.back().get() + i * m_tileElements;
+				slot->shardIndex = shard.index;
+				slot->next = shard.freeList;
+				shard.freeList = slot;
+			}
+		}
+
+		Slot* slot = shard.freeList;
+		shard.freeList = slot->next;
+		return slot;
+	}
+
+	//-------------------------------------------------------------------------------------------
+	// Removes a tile from the map and the LRU list; its slot is recycled once it is unpinned.
+	//
+	inline void TileCache::Uncache( Shard& shard, Slot* slot )
+	{
+		shard.tiles.erase( slot->key );
+		if( slot->prev )
+			slot->prev->next = slot->next;
+		else
+			shard.lruHead = slot->next;
+		if( slot->next )
+			slot->next->prev = slot->prev;
+		else
+			shard.lruTail = slot->prev;
+		slot->prev = nullptr;
+		slot->next = nullptr;
+		slot->cached = false;
+		--shard.cachedCount;
+	}
+
+	//-------------------------------------------------------------------------------------------
+	inline void TileCache::Release( Slot* slot )
+	{
+		Shard& shard = *m_shards[ slot->shardIndex ];
+		std::lock_guard<std::mutex> lock( shard.mutex );
+		ReleaseLocked( shard, slot );
+	}
+
+	//-------------------------------------------------------------------------------------------
+	inline void TileCache::ReleaseLocked( Shard& shard, Slot* slot )
+	{
+		if( slot->pins > 0 )
+			--slot->pins;
+		if( slot->pins == 0 && !slot->cached )
+		{
+			slot->ready = false;
+			slot->next = shard.freeList;
+			shard.freeList = slot;
+		}
+	}
+
+	//-------------------------------------------------------------------------------------------
+	inline void TileCache::PrefetchMain()
+	{
+		for( ;; )
+		{
+			TileKey key;
+			{
+				std::unique_lock<std::mutex> lock( m_prefetchMutex );
+				m_prefetchCondition.wait( lock, [ this ] { return m_quit || !m_prefetchQueue.empty(); } );
+				if( m_quit )
+					return;
+				key = m_prefetchQueue.front();
+				m_prefetchQueue.pop_front();
+				++m_prefetchBusy;
+			}
+
+			try
+			{
+				// Skip tiles that are cached already, without touching their LRU position
+				Shard& shard = GetShard( key );
+				bool cached = false;
+				{
+					std::lock_guard<std::mutex> lock( shard.mutex );
+					cached = shard.tiles.find( key ) != shard.tiles.end();
+				}
+				if( !cached )
+					AcquireInternal( key, true );
+			}
+			catch( ... )
+			{
+				// A failed prefetch just leaves the tile to be generated (and fail) on Acquire()
+			}
+
+			bool idle = false;
+			{
+				std::lock_guard<std::mutex> lock( m_prefetchMutex );
+				--m_prefetchBusy;
+				idle = m_prefetchQueue.empty() && m_prefetchBusy == 0;
+			}
+			if( idle )
+				m_prefetchIdleCondition.notify_all();
+		}
+	}
+}
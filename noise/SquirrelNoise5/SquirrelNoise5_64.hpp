@@ -0,0 +1,133 @@
+//-----------------------------------------------------------------------------------------------
+// SquirrelNoise5_64.hpp
+//
+#pragma once
+
+#include <cstdint>
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+// SquirrelNoise5_64 - 64-bit index / 64-bit output variants of SquirrelNoise5
+//
+// The regular functions take (signed) 32-bit indices and hash N-dimensional coordinates down to
+//	a single 32-bit index, so coordinates past ~2^31 wrap around and the N-D variants start to
+//	collide long before that.  These take 64-bit indices and seeds, fold N-D coordinates into a
+//	64-bit index, and return 64 reasonably-well-scrambled bits in a single pass.
+//
+// All 64 output bits are usable, so the high and low 32 bits of one call can be handed to two
+//	different 32-bit consumers.  Results are NOT related to the 32-bit functions in any way.
+//
+// The mixing follows the same multiply / add seed / xor-shift structure as SquirrelNoise5,
+//	widened to 64 bits: every input and seed bit affects every output bit (worst measured
+//	bit-influence is within sampling noise of 50%).
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//-----------------------------------------------------------------------------------------------
+// Raw pseudorandom noise functions (random-access / deterministic), 64-bit versions.
+//
+constexpr uint64_t SquirrelNoise5_64( int64_t positionX, uint64_t seed );
+constexpr uint64_t Get1dNoiseUint64( int64_t index, uint64_t seed=0 );
+constexpr uint64_t Get2dNoiseUint64( int64_t indexX, int64_t indexY, uint64_t seed=0 );
+constexpr uint64_t Get3dNoiseUint64( int64_t indexX, int64_t indexY, int64_t indexZ, uint64_t seed=0 );
+constexpr uint64_t Get4dNoiseUint64( int64_t indexX, int64_t indexY, int64_t indexZ, int64_t indexT, uint64_t seed=0 );
+
+//-----------------------------------------------------------------------------------------------
+// Same functions, mapped to doubles in [0,1) using the top 53 bits.
+//
+constexpr double Get1dNoiseZeroToOne64( int64_t index, uint64_t seed=0 );
+constexpr double Get2dNoiseZeroToOne64( int64_t indexX, int64_t indexY, uint64_t seed=0 );
+constexpr double Get3dNoiseZeroToOne64( int64_t indexX, int64_t indexY, int64_t indexZ, uint64_t seed=0 );
+constexpr double Get4dNoiseZeroToOne64( int64_t indexX, int64_t indexY, int64_t indexZ, int64_t indexT, uint64_t seed=0 );
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+// Inline function definitions below
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------------------------
+// Fast hash of an int64 into a different (unrecognizable) uint64.
+//
+constexpr uint64_t SquirrelNoise5_64( int64_t positionX, uint64_t seed )
+{
+	constexpr uint64_t SQ5_64_BIT_NOISE1 = 0xD6E8FEB86659FD93;
+	constexpr uint64_t SQ5_64_BIT_NOISE2 = 0xBF58476D1CE4E5B9;
+	constexpr uint64_t SQ5_64_BIT_NOISE3 = 0x94D049BB133111EB;
+
+	uint64_t mangledBits = (uint64_t) positionX;
+	mangledBits *= SQ5_64_BIT_NOISE1;
+	mangledBits += seed;
+	mangledBits ^= (mangledBits >> 32);
+	mangledBits *= SQ5_64_BIT_NOISE2;
+	mangledBits ^= (mangledBits >> 29);
+	mangledBits *= SQ5_64_BIT_NOISE3;
+	mangledBits ^= (mangledBits >> 32);
+	return mangledBits;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+constexpr uint64_t Get1dNoiseUint64( int64_t index, uint64_t seed )
+{
+	return SquirrelNoise5_64( index, seed );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+constexpr uint64_t Get2dNoiseUint64( int64_t indexX, int64_t indexY, uint64_t seed )
+{
+	constexpr uint64_t PRIME_NUMBER = 0x9E3779B97F4A7C55; // Large prime number with non-boring bits
+	return SquirrelNoise5_64( (int64_t)( (uint64_t) indexX + (PRIME_NUMBER * (uint64_t) indexY) ), seed );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+constexpr uint64_t Get3dNoiseUint64( int64_t indexX, int64_t indexY, int64_t indexZ, uint64_t seed )
+{
+	constexpr uint64_t PRIME1 = 0x9E3779B97F4A7C55; // Large prime number with non-boring bits
+	constexpr uint64_t PRIME2 = 0xC2B2AE3D27D4EB4F; // Large prime number with distinct and non-boring bits
+	return SquirrelNoise5_64( (int64_t)( (uint64_t) indexX + (PRIME1 * (uint64_t) indexY) + (PRIME2 * (uint64_t) indexZ) ), seed );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+constexpr uint64_t Get4dNoiseUint64( int64_t indexX, int64_t indexY, int64_t indexZ, int64_t indexT, uint64_t seed )
+{
+	constexpr uint64_t PRIME1 = 0x9E3779B97F4A7C55; // Large prime number with non-boring bits
+	constexpr uint64_t PRIME2 = 0xC2B2AE3D27D4EB4F; // Large prime number with distinct and non-boring bits
+	constexpr uint64_t PRIME3 = 0x165667B19E3779F9; // Large prime number with distinct and non-boring bits
+	return SquirrelNoise5_64( (int64_t)( (uint64_t) indexX + (PRIME1 * (uint64_t) indexY) + (PRIME2 * (uint64_t) indexZ) + (PRIME3 * (uint64_t) indexT) ), seed );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+constexpr double Get1dNoiseZeroToOne64( int64_t index, uint64_t seed )
+{
+	constexpr double ONE_OVER_2_TO_53 = (1.0 / 9007199254740992.0);
+	return ONE_OVER_2_TO_53 * (double)( SquirrelNoise5_64( index, seed ) >> 11 );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+constexpr double Get2dNoiseZeroToOne64( int64_t indexX, int64_t indexY, uint64_t seed )
+{
+	constexpr double ONE_OVER_2_TO_53 = (1.0 / 9007199254740992.0);
+	return ONE_OVER_2_TO_53 * (double)( Get2dNoiseUint64( indexX, indexY, seed ) >> 11 );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+constexpr double Get3dNoiseZeroToOne64( int64_t indexX, int64_t indexY, int64_t indexZ, uint64_t seed )
+{
+	constexpr double ONE_OVER_2_TO_53 = (1.0 / 9007199254740992.0);
+	return ONE_OVER_2_TO_53 * (double)( Get3dNoiseUint64( indexX, indexY, indexZ, seed ) >> 11 );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+constexpr double Get4dNoiseZeroToOne64( int64_t indexX, int64_t indexY, int64_t indexZ, int64_t indexT, uint64_t seed )
+{
+	constexpr double ONE_OVER_2_TO_53 = (1.0 / 9007199254740992.0);
+	return ONE_OVER_2_TO_53 * (double)( Get4dNoiseUint64( indexX, indexY, indexZ, indexT, seed ) >> 11 );
+}
@@ -0,0 +1,240 @@
+//-----------------------------------------------------------------------------------------------
+// SquirrelPermutation.hpp
+//
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include "SquirrelNoise5Batch.hpp"
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+// SquirrelPermutation - Random-access shuffles of [0, domainSize) on top of SquirrelNoise5
+//
+// Permute( i, n, seed ) is a seeded bijection of [0, n): for a given n and seed, every index
+//	maps to a different result, so reading i = 0, 1, 2... visits the whole domain in a shuffled
+//	order.  It needs no table and no state, so any thread can compute any element of a
+//	shuffle of billions of indices on its own:
+//
+//		for( unsigned int i = workerBegin; i < workerEnd; ++i )
+//			Spawn( candidates[ Permute( i, candidateCount, seed ) ] );
+//
+// It is a Feistel network over the smallest power-of-two domain that holds n, with
+//	SquirrelNoise5 as the round function, walking the cycle again until the result lands
+//	back in [0, n) ("cycle-walking").  The domain split is allowed to be uneven (in alternating
+//	rounds), so the power-of-two domain is always less than twice n and each lookup averages
+//	less than two walks.  Unpermute() is the inverse.
+//
+// This is a well-mixed shuffle for simulations and sampling, NOT a cryptographic one.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//-----------------------------------------------------------------------------------------------
+// Element index of a random permutation of [0, domainSize), and its inverse:
+//	Unpermute( Permute( i, n, seed ), n, seed ) == i.  index must be < domainSize.
+//
+constexpr unsigned int Permute( unsigned int index, unsigned int domainSize, unsigned int seed=0 );
+constexpr unsigned int Unpermute( unsigned int permutedIndex, unsigned int domainSize, unsigned int seed=0 );
+
+//-----------------------------------------------------------------------------------------------
+// Batch versions, using the SIMD kernel: out[i] = Permute( indices[i], domainSize, seed ), and
+//	out[i] = Permute( start + i, domainSize, seed ) for a contiguous range.
+//
+inline void PermuteBatch( const unsigned int* indices, unsigned int* out, size_t count, unsigned int domainSize, unsigned int seed=0 );
+inline void PermuteRange( unsigned int start, size_t count, unsigned int domainSize, unsigned int seed, unsigned int* out );
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+// Inline function definitions below
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace SquirrelPermutation
+{
+	constexpr int ROUNDS = 6;
+	constexpr unsigned int ROUND_PRIME = 0x9E3779B1; // Large prime number with non-boring bits, separates the rounds' inputs
+
+	//-------------------------------------------------------------------------------------------
+	// Every round moves the low lowBits[ round & 1 ] bits (the "right half") to the top and
+	//	xors the remaining bits with the round function of them.  The two widths add up to the
+	//	total bit count, so consecutive rounds alternate between the uneven halves.
+	//
+	struct Shape
+	{
+		int lowBits[ 2 ] = { 0, 0 };
+		unsigned int lowMasks[ 2 ] = { 0, 0 };
+	};
+
+	//-------------------------------------------------------------------------------------------
+	constexpr Shape MakeShape( unsigned int domainSize )
+	{
+		int bits = 1;
+		while( bits < 32 && ( domainSize - 1 ) >> bits )
+			++bits;
+
+		Shape shape;
+		shape.lowBits[ 0 ] = bits / 2;
+		shape.lowBits[ 1 ] = bits - bits / 2;
+		shape.lowMasks[ 0 ] = ( 1u << shape.lowBits[ 0 ] ) - 1u;
+		shape.lowMasks[ 1 ] = ( 1u << shape.lowBits[ 1 ] ) - 1u;
+		return shape;
+	}
+
+	//-------------------------------------------------------------------------------------------
+	constexpr unsigned int Encrypt( unsigned int value, const Shape& shape, unsigned int seed )
+	{
+		for( int round = 0; round < ROUNDS; ++round )
+		{
+			const int lowBits = shape.lowBits[ round & 1 ];
+			const int highBits = shape.lowBits[ ( round & 1 ) ^ 1 ];
+			const unsigned int right = value & shape.lowMasks[ round & 1 ];
+			const unsigned int left = value >> lowBits;
+			const unsigned int roundNoise = SquirrelNoise5( (int)( right + ROUND_PRIME * (unsigned int) round ), seed );
+			value = ( right << highBits ) + ( left ^ ( roundNoise & shape.lowMasks[ ( round & 1 ) ^ 1 ] ) );
+		}
+		return value;
+	}
+
+	//-------------------------------------------------------------------------------------------
+	constexpr unsigned int Decrypt( unsigned int value, const Shape& shape, unsigned int seed )
+	{
+		for( int round = ROUNDS - 1; round >= 0; --round )
+		{
+			const int lowBits = shape.lowBits[ round & 1 ];
+			const int highBits = shape.lowBits[ ( round & 1 ) ^ 1 ];
+			const unsigned int right = value >> highBits;
+			const unsigned int roundNoise = SquirrelNoise5( (int)( right + ROUND_PRIME * (unsigned int) round ), seed );
+			const unsigned int left = ( value & shape.lowMasks[ ( round & 1 ) ^ 1 ] ) ^ ( roundNoise & shape.lowMasks[ ( round & 1 ) ^ 1 ] );
+			value = ( left << lowBits ) + right;
+		}
+		return value;
+	}
+
+	//-------------------------------------------------------------------------------------------
+	// Encrypt() applied to every lane.  Must be kept in sync with the scalar version!
+	//
+	template<typename B>
+	inline typename B::U32 EncryptLanes( typename B::U32 value, const Shape& shape, typename B::U32 seed )
+	{
+		for( int round = 0; round < ROUNDS; ++round )
+		{
+			const int lowBits = shape.lowBits[ round & 1 ];
+			const int highBits = shape.lowBits[ ( round & 1 ) ^ 1 ];
+			const typename B::U32 right = B::And( value, B::Set1( shape.lowMasks[ round & 1 ] ) );
+			const typename B::U32 left = B::ShiftRightBy( value, lowBits );
+			const typename B::U32 roundNoise = SquirrelNoise5Simd::SquirrelNoise5Lanes<B>( B::Add( right, B::Set1( ROUND_PRIME * (unsigned int) round ) ), seed );
+			value = B::Add( B::ShiftLeftBy( right, highBits ), B::Xor( left, B::And( roundNoise, B::Set1( shape.lowMasks[ ( round & 1 ) ^ 1 ] ) ) ) );
+		}
+		return value;
+	}
+
+	//-------------------------------------------------------------------------------------------
+	// Permutes two registers of indices at once (to hide the multiply latency), cycle-walking
+	//	until every lane of both is back in [0, domainSize).  Lanes that are done keep their value.
+	//
+	template<typename B>
+	inline void PermuteLanes( typename B::U32& value0, typename B::U32& value1, const Shape& shape, typename B::U32 last, typename B::U32 seed )
+	{
+		value0 = EncryptLanes<B>( value0, shape, seed );
+		value1 = EncryptLanes<B>( value1, shape, seed );
+		for( ;; )
+		{
+			const typename B::U32 clamped0 = B::Min( value0, last );
+			const typename B::U32 clamped1 = B::Min( value1, last );
+			if( B::AllEqual( clamped0, value0 ) && B::AllEqual( clamped1, value1 ) )
+				return;
+
+			value0 = B::SelectIfEqual( clamped0, value0, value0, EncryptLanes<B>( value0, shape, seed ) );
+			value1 = B::SelectIfEqual( clamped1, value1, value1, EncryptLanes<B>( value1, shape, seed ) );
+		}
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+constexpr unsigned int Permute( unsigned int index, unsigned int domainSize, unsigned int seed )
+{
+	assert( index < domainSize );
+	const SquirrelPermutation::Shape shape = SquirrelPermutation::MakeShape( domainSize );
+
+	// Walking the cycle from index always comes back into the domain, at index itself at worst
+	unsigned int value = index;
+	do
+	{
+		value = SquirrelPermutation::Encrypt( value, shape, seed );
+	} while( value >= domainSize );
+	return value;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+constexpr unsigned int Unpermute( unsigned int permutedIndex, unsigned int domainSize, unsigned int seed )
+{
+	assert( permutedIndex < domainSize );
+	const SquirrelPermutation::Shape shape = SquirrelPermutation::MakeShape( domainSize );
+
+	unsigned int value = permutedIndex;
+	do
+	{
+		value = SquirrelPermutation::Decrypt( value, shape, seed );
+	} while( value >= domainSize );
+	return value;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+inline void PermuteBatch( const unsigned int* indices, unsigned int* out, size_t count, unsigned int domainSize, unsigned int seed )
+{
+	using B = SquirrelNoise5Simd::Backend;
+	const SquirrelPermutation::Shape shape = SquirrelPermutation::MakeShape( domainSize );
+	const B::U32 seedLanes = B::Set1( seed );
+	const B::U32 last = B::Set1( domainSize - 1 );
+#if !defined( NDEBUG )
+	for( size_t i = 0; i < count; ++i )
+		assert( indices[ i ] < domainSize ); // An index outside the domain would cycle-walk forever
+#endif
+
+	const size_t vectorCount = count - ( count % ( 2 * B::LANES ) );
+
+	size_t i = 0;
+	for( ; i < vectorCount; i += 2 * B::LANES )
+	{
+		B::U32 value0 = B::Load( indices + i );
+		B::U32 value1 = B::Load( indices + i + B::LANES );
+		SquirrelPermutation::PermuteLanes<B>( value0, value1, shape, last, seedLanes );
+		B::Store( out + i, value0 );
+		B::Store( out + i + B::LANES, value1 );
+	}
+
+	for( ; i < count; ++i )
+		out[ i ] = Permute( indices[ i ], domainSize, seed );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+inline void PermuteRange( unsigned int start, size_t count, unsigned int domainSize, unsigned int seed, unsigned int* out )
+{
+	assert( count <= domainSize && start <= domainSize - count ); // An index outside the domain would cycle-walk forever
+	using B = SquirrelNoise5Simd::Backend;
+	const SquirrelPermutation::Shape shape = SquirrelPermutation::MakeShape( domainSize );
+	const B::U32 seedLanes = B::Set1( seed );
+	const B::U32 last = B::Set1( domainSize - 1 );
+	const B::U32 step = B::Set1( (unsigned int) B::LANES );
+	B::U32 positions = B::Add( B::Set1( start ), B::Iota() );
+
+	const size_t vectorCount = count - ( count % ( 2 * B::LANES ) );
+
+	size_t i = 0;
+	for( ; i < vectorCount; i += 2 * B::LANES )
+	{
+		B::U32 value0 = positions;
+		B::U32 value1 = B::Add( positions, step );
+		positions = B::Add( value1, step );
+		SquirrelPermutation::PermuteLanes<B>( value0, value1, shape, last, seedLanes );
+		B::Store( out + i, value0 );
+		B::Store( out + i + B::LANES, value1 );
+	}
+
+	for( ; i < count; ++i )
+		out[ i ] = Permute( start + (unsigned int) i, domainSize, seed );
+}
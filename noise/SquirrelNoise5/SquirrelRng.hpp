@@ -0,0 +1,165 @@
+//-----------------------------------------------------------------------------------------------
+// SquirrelRng.hpp
+//
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#if defined( __has_include )
+	#if __has_include( <span> )
+		#include <span>
+	#endif
+#endif
+#include "SquirrelNoise5Batch.hpp"
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+// SquirrelRng - Counter-based random number generator on top of SquirrelNoise5
+//
+// Every roll is simply Get1dNoiseUint( position++, seed ), so the whole state is two 32-bit
+//	numbers: the generator can be copied, saved, rewound or fast-forwarded (Discard) in O(1).
+//	Each stream has a period of 2^32 rolls.
+//
+// Ranges are reduced with a multiply-shift instead of `%`, which is both faster and unbiased
+//	(the rare biased results are rejected and re-rolled).  Bulk Fill methods go through the
+//	SIMD range kernel.
+//
+// Independent streams for worker threads are made with Substream(), which derives a new seed
+//	from the current one in O(1), with no coordination between threads.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+class SquirrelRng
+{
+public:
+	explicit constexpr SquirrelRng( unsigned int seed=0, unsigned int position=0 ) : m_seed( seed ), m_position( position ) {}
+
+	constexpr unsigned int GetSeed() const { return m_seed; }
+	constexpr unsigned int GetPosition() const { return m_position; }
+	constexpr void SetPosition( unsigned int position ) { m_position = position; }
+	constexpr void Discard( unsigned int count ) { m_position += count; }
+
+	// Returns a generator for an independent stream, e.g. one per worker thread.  Same seed and
+	//	streamIndex always give the same stream; the parent's position does not matter.
+	constexpr SquirrelRng Substream( unsigned int streamIndex ) const;
+
+	constexpr unsigned int RollRandomUint32();
+	constexpr int RollRandomIntLessThan( int maxNotInclusive );					// [0, maxNotInclusive); maxNotInclusive must be > 0
+	constexpr int RollRandomIntInRange( int minInclusive, int maxInclusive );	// [minInclusive, maxInclusive]
+	constexpr float RollRandomFloatZeroToOne();									// [0,1), see Get1dNoiseZeroToOneFast()
+	constexpr float RollRandomFloatInRange( float minInclusive, float maxExclusive );	// [minInclusive, maxExclusive)
+	constexpr bool RollRandomChance( float probabilityOfReturningTrue );
+
+	// Bulk versions: same results as calling the single-roll version count times.
+	void Fill( uint32_t* out, size_t count );
+	void FillZeroToOne( float* out, size_t count );
+#if defined( __cpp_lib_span )
+	void Fill( std::span<uint32_t> out )			{ Fill( out.data(), out.size() ); }
+	void FillZeroToOne( std::span<float> out )		{ FillZeroToOne( out.data(), out.size() ); }
+#endif
+
+private:
+	constexpr unsigned int RollRandomUintLessThan( unsigned int range );
+
+	unsigned int m_seed = 0;
+	unsigned int m_position = 0;
+};
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+// Inline function definitions below
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+static_assert( std::is_same<uint32_t, unsigned int>::value, "SquirrelRng::Fill() expects uint32_t to be unsigned int" );
+
+
+//-----------------------------------------------------------------------------------------------
+constexpr SquirrelRng SquirrelRng::Substream( unsigned int streamIndex ) const
+{
+	constexpr unsigned int SUBSTREAM_SEED_NOISE = 0x5bd1e995; // Keeps substream seeds away from Get1dNoiseUint( streamIndex, m_seed )
+	return SquirrelRng( SquirrelNoise5( (int) streamIndex, m_seed ^ SUBSTREAM_SEED_NOISE ), 0 );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+constexpr unsigned int SquirrelRng::RollRandomUint32()
+{
+	return SquirrelNoise5( (int) m_position++, m_seed );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Lemire's multiply-shift range reduction: the high 32 bits of roll * range are uniform in
+//	[0, range) once the few low-word values that would over-represent some results are rejected.
+//
+constexpr unsigned int SquirrelRng::RollRandomUintLessThan( unsigned int range )
+{
+	uint64_t product = (uint64_t) RollRandomUint32() * range;
+	unsigned int lowBits = (unsigned int) product;
+	if( lowBits < range )
+	{
+		const unsigned int threshold = (0u - range) % range;
+		while( lowBits < threshold )
+		{
+			product = (uint64_t) RollRandomUint32() * range;
+			lowBits = (unsigned int) product;
+		}
+	}
+	return (unsigned int)( product >> 32 );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+constexpr int SquirrelRng::RollRandomIntLessThan( int maxNotInclusive )
+{
+	return (int) RollRandomUintLessThan( (unsigned int) maxNotInclusive );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+constexpr int SquirrelRng::RollRandomIntInRange( int minInclusive, int maxInclusive )
+{
+	const unsigned int range = (unsigned int) maxInclusive - (unsigned int) minInclusive + 1u;
+	if( range == 0 ) // Full 32-bit range
+		return (int) RollRandomUint32();
+
+	return (int)( (unsigned int) minInclusive + RollRandomUintLessThan( range ) );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+constexpr float SquirrelRng::RollRandomFloatZeroToOne()
+{
+	return Get1dNoiseZeroToOneFast( (int) m_position++, m_seed );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+constexpr float SquirrelRng::RollRandomFloatInRange( float minInclusive, float maxExclusive )
+{
+	return minInclusive + ( maxExclusive - minInclusive ) * RollRandomFloatZeroToOne();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+constexpr bool SquirrelRng::RollRandomChance( float probabilityOfReturningTrue )
+{
+	return RollRandomFloatZeroToOne() < probabilityOfReturningTrue;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+inline void SquirrelRng::Fill( uint32_t* out, size_t count )
+{
+	Get1dNoiseUintRange( (int) m_position, count, m_seed, out );
+	m_position += (unsigned int) count;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+inline void SquirrelRng::FillZeroToOne( float* out, size_t count )
+{
+	Get1dNoiseZeroToOneFastRange( (int) m_position, count, m_seed, out );
+	m_position += (unsigned int) count;
+}
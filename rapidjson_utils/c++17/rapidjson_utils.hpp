@@ -29,26 +29,430 @@
 //
 
 #include <cassert>
+#include <cerrno>
+#include <charconv>
+#include <cstdint>
 #include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <optional>
 #include <climits>
+#include <limits>
+#include <map>
+#include <memory>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#if defined(__has_include)
+	#if __has_include(<span>)
+		#include <span>
+	#endif
+#endif
+#if defined(_WIN32)
+	#ifndef WIN32_LEAN_AND_MEAN
+		#define WIN32_LEAN_AND_MEAN
+	#endif
+	#ifndef NOMINMAX
+		#define NOMINMAX
+	#endif
+	#include <windows.h>
+	#include <io.h>
+	#include <sys/stat.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <sys/uio.h>
+	#include <unistd.h>
+#endif
 #include "RapidJSON/rapidjson.h"
 #include "RapidJSON/document.h"
 #include "RapidJSON/encodings.h"
 #include "RapidJSON/filereadstream.h"
+#include "RapidJSON/reader.h"
+#include "RapidJSON/writer.h"
 
 namespace rjutils  // RapidJSON Utils
 {
-	inline bool ParseFile(const char* file_name, rapidjson::Document& out_document)
+	// `static_assert(false, ...)` is rejected by most compilers even inside a discarded
+	// `if constexpr` branch, so the assertion has to depend on the template parameter.
+	template<typename T>
+	struct dependent_false : std::false_type {};
+
+	//
+	// Instrumentation
+	//
+	// Define RJUTILS_INSTRUMENTATION before including this header to count what the hot paths do:
+	// member lookups and misses, Extract<>() calls that fell back to `default_value` because of a
+	// type mismatch, numbers sent as strings, and the bytes and wall time of every ParseFile*()
+	// call. Define RJUTILS_INSTRUMENTATION_KEYS as well to also break lookups down per member
+	// name, which tells which objects are worth an IndexedObject and which fields upstreams send
+	// as strings:
+	//
+	//     const rjutils::InstrumentationStats stats = rjutils::GetInstrumentationStats();
+	//     for (const auto& [key, keyStats] : rjutils::GetInstrumentationKeyStats())
+	//         ...
+	//
+	// Counters are thread-local (plain relaxed stores, no atomic read-modify-writes) and only
+	// summed up when asked for. Without RJUTILS_INSTRUMENTATION every hook is discarded at
+	// compile time and the getters return zeros.
+	//
+
+#if defined(RJUTILS_INSTRUMENTATION_KEYS) && !defined(RJUTILS_INSTRUMENTATION)
+	#define RJUTILS_INSTRUMENTATION
+#endif
+
+#if defined(RJUTILS_INSTRUMENTATION)
+	constexpr bool INSTRUMENTATION_ENABLED = true;
+#else
+	constexpr bool INSTRUMENTATION_ENABLED = false;
+#endif
+
+	struct InstrumentationStats
+	{
+		uint64_t member_lookups = 0;
+		uint64_t member_misses = 0;
+		uint64_t type_mismatches = 0;			// Extract<>() fell back to default_value on an existing member
+		uint64_t numeric_strings = 0;			// Numbers converted from strings by ExtractFromNumericOrString
+		uint64_t numeric_string_failures = 0;	// ... whose string wasn't a valid number
+		uint64_t files_parsed = 0;
+		uint64_t file_bytes = 0;
+		uint64_t file_parse_nanoseconds = 0;
+	};
+
+	struct InstrumentationKeyStats
+	{
+		uint64_t lookups = 0;
+		uint64_t misses = 0;
+		uint64_t type_mismatches = 0;
+		uint64_t numeric_strings = 0;
+	};
+
+#if defined(RJUTILS_INSTRUMENTATION)
+	// One per thread, registered for as long as the thread lives
+	class ThreadInstrumentation
+	{
+	public:
+		ThreadInstrumentation();
+		~ThreadInstrumentation();
+
+		// Only ever written by the owning thread, so a load and a store are enough
+		static void Add(std::atomic<uint64_t>& counter, uint64_t amount)
+		{
+			counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+		}
+
+		void AddTo(InstrumentationStats& out_stats) const
+		{
+			out_stats.member_lookups += member_lookups.load(std::memory_order_relaxed);
+			out_stats.member_misses += member_misses.load(std::memory_order_relaxed);
+			out_stats.type_mismatches += type_mismatches.load(std::memory_order_relaxed);
+			out_stats.numeric_strings += numeric_strings.load(std::memory_order_relaxed);
+			out_stats.numeric_string_failures += numeric_string_failures.load(std::memory_order_relaxed);
+			out_stats.files_parsed += files_parsed.load(std::memory_order_relaxed);
+			out_stats.file_bytes += file_bytes.load(std::memory_order_relaxed);
+			out_stats.file_parse_nanoseconds += file_parse_nanoseconds.load(std::memory_order_relaxed);
+		}
+
+		std::atomic<uint64_t> member_lookups{ 0 };
+		std::atomic<uint64_t> member_misses{ 0 };
+		std::atomic<uint64_t> type_mismatches{ 0 };
+		std::atomic<uint64_t> numeric_strings{ 0 };
+		std::atomic<uint64_t> numeric_string_failures{ 0 };
+		std::atomic<uint64_t> files_parsed{ 0 };
+		std::atomic<uint64_t> file_bytes{ 0 };
+		std::atomic<uint64_t> file_parse_nanoseconds{ 0 };
+
+	#if defined(RJUTILS_INSTRUMENTATION_KEYS)
+		void AddKey(std::string_view key, uint64_t InstrumentationKeyStats::* counter)
+		{
+			std::lock_guard<std::mutex> lock(keys_mutex);
+			auto it = keys.find(key);
+			if (it == keys.end())
+				it = keys.emplace(std::string(key), InstrumentationKeyStats()).first;
+			++(it->second.*counter);
+		}
+
+		void AddKeysTo(std::map<std::string, InstrumentationKeyStats, std::less<>>& out_keys)
+		{
+			std::lock_guard<std::mutex> lock(keys_mutex);
+			for (const auto& [key, keyStats] : keys)
+				AddKeyStats(out_keys[key], keyStats);
+		}
+
+		static void AddKeyStats(InstrumentationKeyStats& out_stats, const InstrumentationKeyStats& stats)
+		{
+			out_stats.lookups += stats.lookups;
+			out_stats.misses += stats.misses;
+			out_stats.type_mismatches += stats.type_mismatches;
+			out_stats.numeric_strings += stats.numeric_strings;
+		}
+	#endif
+
+	#if defined(RJUTILS_INSTRUMENTATION_KEYS)
+	private:
+		std::mutex keys_mutex;					// Uncontended except while aggregating
+		std::map<std::string, InstrumentationKeyStats, std::less<>> keys;
+	#endif
+	};
+
+	struct InstrumentationRegistry
+	{
+		std::mutex mutex;
+		std::vector<ThreadInstrumentation*> threads;
+		InstrumentationStats retired;			// Counts of threads that already exited
+		InstrumentationStats baseline;			// Subtracted after a reset
+	#if defined(RJUTILS_INSTRUMENTATION_KEYS)
+		std::map<std::string, InstrumentationKeyStats, std::less<>> retired_keys;
+		std::map<std::string, InstrumentationKeyStats, std::less<>> baseline_keys;
+	#endif
+
+		static InstrumentationRegistry& Get()
+		{
+			static InstrumentationRegistry registry;
+			return registry;
+		}
+	};
+
+	inline ThreadInstrumentation::ThreadInstrumentation()
+	{
+		InstrumentationRegistry& registry = InstrumentationRegistry::Get();
+		std::lock_guard<std::mutex> lock(registry.mutex);
+		registry.threads.push_back(this);
+	}
+
+	inline ThreadInstrumentation::~ThreadInstrumentation()
+	{
+		InstrumentationRegistry& registry = InstrumentationRegistry::Get();
+		std::lock_guard<std::mutex> lock(registry.mutex);
+		AddTo(registry.retired);
+	#if defined(RJUTILS_INSTRUMENTATION_KEYS)
+		AddKeysTo(registry.retired_keys);
+	#endif
+		registry.threads.erase(std::find(registry.threads.begin(), registry.threads.end(), this));
+	}
+
+	inline ThreadInstrumentation& GetThreadInstrumentation()
+	{
+		thread_local ThreadInstrumentation instrumentation;
+		return instrumentation;
+	}
+
+	inline InstrumentationStats SumInstrumentationStats(InstrumentationRegistry& registry)
+	{
+		InstrumentationStats stats = registry.retired;
+		for (const ThreadInstrumentation* thread : registry.threads)
+			thread->AddTo(stats);
+		return stats;
+	}
+
+	#if defined(RJUTILS_INSTRUMENTATION_KEYS)
+	inline std::map<std::string, InstrumentationKeyStats, std::less<>> SumInstrumentationKeyStats(InstrumentationRegistry& registry)
+	{
+		std::map<std::string, InstrumentationKeyStats, std::less<>> keys = registry.retired_keys;
+		for (ThreadInstrumentation* thread : registry.threads)
+			thread->AddKeysTo(keys);
+		return keys;
+	}
+	#endif
+#endif
+
+	// Totals of every thread since the start (or the last ResetInstrumentationStats())
+	inline InstrumentationStats GetInstrumentationStats()
+	{
+		InstrumentationStats stats;
+	#if defined(RJUTILS_INSTRUMENTATION)
+		InstrumentationRegistry& registry = InstrumentationRegistry::Get();
+		std::lock_guard<std::mutex> lock(registry.mutex);
+		stats = SumInstrumentationStats(registry);
+		stats.member_lookups -= registry.baseline.member_lookups;
+		stats.member_misses -= registry.baseline.member_misses;
+		stats.type_mismatches -= registry.baseline.type_mismatches;
+		stats.numeric_strings -= registry.baseline.numeric_strings;
+		stats.numeric_string_failures -= registry.baseline.numeric_string_failures;
+		stats.files_parsed -= registry.baseline.files_parsed;
+		stats.file_bytes -= registry.baseline.file_bytes;
+		stats.file_parse_nanoseconds -= registry.baseline.file_parse_nanoseconds;
+	#endif
+		return stats;
+	}
+
+	// Per member name totals, only collected with RJUTILS_INSTRUMENTATION_KEYS
+	inline std::vector<std::pair<std::string, InstrumentationKeyStats>> GetInstrumentationKeyStats()
+	{
+		std::vector<std::pair<std::string, InstrumentationKeyStats>> result;
+	#if defined(RJUTILS_INSTRUMENTATION_KEYS)
+		InstrumentationRegistry& registry = InstrumentationRegistry::Get();
+		std::lock_guard<std::mutex> lock(registry.mutex);
+		for (auto& [key, keyStats] : SumInstrumentationKeyStats(registry))
+		{
+			const auto baseline = registry.baseline_keys.find(key);
+			if (baseline != registry.baseline_keys.end())
+			{
+				keyStats.lookups -= baseline->second.lookups;
+				keyStats.misses -= baseline->second.misses;
+				keyStats.type_mismatches -= baseline->second.type_mismatches;
+				keyStats.numeric_strings -= baseline->second.numeric_strings;
+			}
+			if (keyStats.lookups || keyStats.numeric_strings)
+				result.emplace_back(key, keyStats);
+		}
+	#endif
+		return result;
+	}
+
+	// Threads keep counting on their own, so a reset only moves the baseline
+	inline void ResetInstrumentationStats()
+	{
+	#if defined(RJUTILS_INSTRUMENTATION)
+		InstrumentationRegistry& registry = InstrumentationRegistry::Get();
+		std::lock_guard<std::mutex> lock(registry.mutex);
+		registry.baseline = SumInstrumentationStats(registry);
+		#if defined(RJUTILS_INSTRUMENTATION_KEYS)
+		registry.baseline_keys = SumInstrumentationKeyStats(registry);
+		#endif
+	#endif
+	}
+
+	// Hooks, called from `if constexpr (INSTRUMENTATION_ENABLED)` blocks so that their arguments
+	// aren't even evaluated when instrumentation is off
+
+	inline std::string_view InstrumentationKey(const char* member) { return std::string_view(member); }
+	template<typename Ch>
+	inline std::string_view InstrumentationKey(const rapidjson::GenericStringRef<Ch>& member) { return std::string_view(member.s, member.length); }
+	inline std::string_view InstrumentationKey(const rapidjson::Value& member) { return std::string_view(member.GetString(), member.GetStringLength()); }
+
+	inline void InstrumentLookup([[maybe_unused]] std::string_view key, [[maybe_unused]] bool found)
+	{
+	#if defined(RJUTILS_INSTRUMENTATION)
+		ThreadInstrumentation& instrumentation = GetThreadInstrumentation();
+		ThreadInstrumentation::Add(instrumentation.member_lookups, 1);
+		if (!found)
+			ThreadInstrumentation::Add(instrumentation.member_misses, 1);
+		#if defined(RJUTILS_INSTRUMENTATION_KEYS)
+		instrumentation.AddKey(key, &InstrumentationKeyStats::lookups);
+		if (!found)
+			instrumentation.AddKey(key, &InstrumentationKeyStats::misses);
+		#endif
+	#endif
+	}
+
+	inline void InstrumentTypeMismatch([[maybe_unused]] std::string_view key)
+	{
+	#if defined(RJUTILS_INSTRUMENTATION)
+		ThreadInstrumentation::Add(GetThreadInstrumentation().type_mismatches, 1);
+		#if defined(RJUTILS_INSTRUMENTATION_KEYS)
+		GetThreadInstrumentation().AddKey(key, &InstrumentationKeyStats::type_mismatches);
+		#endif
+	#endif
+	}
+
+	// Value-level: counted without a key
+	inline void InstrumentNumericString([[maybe_unused]] bool converted)
+	{
+	#if defined(RJUTILS_INSTRUMENTATION)
+		ThreadInstrumentation& instrumentation = GetThreadInstrumentation();
+		ThreadInstrumentation::Add(instrumentation.numeric_strings, 1);
+		if (!converted)
+			ThreadInstrumentation::Add(instrumentation.numeric_string_failures, 1);
+	#endif
+	}
+
+	inline void InstrumentNumericStringKey([[maybe_unused]] std::string_view key)
+	{
+	#if defined(RJUTILS_INSTRUMENTATION_KEYS)
+		GetThreadInstrumentation().AddKey(key, &InstrumentationKeyStats::numeric_strings);
+	#endif
+	}
+
+	// Times a ParseFile*() call; nested timers (e.g. a fallback to ParseFileInsitu()) are only
+	// counted once, by the outermost one. A nested timer hands its bytes to the outermost one
+	// when that one didn't get any, since fallbacks are usually taken before the size is known.
+	class ScopedParseTimer
+	{
+	public:
+	#if defined(RJUTILS_INSTRUMENTATION)
+		ScopedParseTimer()
+			: outer(Outermost())
+			, start(std::chrono::steady_clock::now())
+		{
+			if (!outer)
+				Outermost() = this;
+		}
+
+		~ScopedParseTimer()
+		{
+			if (outer)
+			{
+				if (outer->bytes == 0)
+					outer->bytes = bytes;
+				return;
+			}
+
+			Outermost() = nullptr;
+			if (bytes == 0)
+				return;
+
+			const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+			ThreadInstrumentation& instrumentation = GetThreadInstrumentation();
+			ThreadInstrumentation::Add(instrumentation.files_parsed, 1);
+			ThreadInstrumentation::Add(instrumentation.file_bytes, bytes);
+			ThreadInstrumentation::Add(instrumentation.file_parse_nanoseconds, static_cast<uint64_t>(elapsed.count()));
+		}
+
+		ScopedParseTimer(const ScopedParseTimer&) = delete;
+		ScopedParseTimer& operator=(const ScopedParseTimer&) = delete;
+
+		void SetBytes(size_t bytes_) { bytes = bytes_; }
+
+	private:
+		static ScopedParseTimer*& Outermost()
+		{
+			thread_local ScopedParseTimer* outermost = nullptr;
+			return outermost;
+		}
+
+		ScopedParseTimer* outer;		// Null for the outermost timer
+		std::chrono::steady_clock::time_point start;
+		size_t bytes = 0;
+	#else
+		void SetBytes(size_t) {}
+	#endif
+	};
+
+	// fopen() without MSVC's deprecation warning. The "b" modes are the same as the text ones on
+	// POSIX, so pass those.
+	inline FILE* OpenFile(const char* file_name, const char* mode)
 	{
-		// We avoid using ifstream here as recommended in the documentation to improve the performance
-		// https://rapidjson.org/md_doc_stream.html
 	#ifdef _WIN32
 		#pragma warning(disable:4996)
-		FILE* fp = fopen(file_name, "rb");
+		FILE* fp = fopen(file_name, mode);
 		#pragma warning(default:4996)
+		return fp;
 	#else
-		FILE* fp = fopen(file_name, "r");
+		return fopen(file_name, mode);
 	#endif
+	}
+
+	inline bool ParseFile(const char* file_name, rapidjson::Document& out_document)
+	{
+		ScopedParseTimer timer;
+
+		// We avoid using ifstream here as recommended in the documentation to improve the performance
+		// https://rapidjson.org/md_doc_stream.html
+		FILE* fp = OpenFile(file_name, "rb");
 		assert(fp);
 		if (!fp)
 			return false;
@@ -60,233 +464,3218 @@ namespace rjutils  // RapidJSON Utils
 
 		rapidjson::FileReadStream is(fp, readBuffer, BUFFER_SIZE);
 		out_document.ParseStream(is);
+		timer.SetBytes(is.Tell());
 		fclose(fp);
 		free(readBuffer);
 
 		return !out_document.HasParseError();
 	}
 
-	template<typename DataType, typename Ch = char, typename RapidJsonTarget>
-	inline bool IsValid(const RapidJsonTarget& target_element, const Ch* member)
+	// Owns a parsed Document together with the buffer its strings point into.
+	//
+	// Filled by ParseFileInsitu() / ParseFileMapped(), which parse in-situ: strings are decoded in
+	// place and never copied into the Document allocator, so peak memory is roughly the file size
+	// plus the DOM nodes. The buffer is released together with the Document, so values (and any
+	// `const char*` extracted from them) must not outlive this object.
+	class InsituDocument
 	{
-		static_assert (std::is_same<RapidJsonTarget, rapidjson::Document>::value || std::is_same<RapidJsonTarget, rapidjson::Value>::value, "rjutil::IsValid<>() only supports rapidjson::Document and rapidjson::Value as the first parameter");
-		if (!target_element.HasMember(member))
-			return false;
-
-		if constexpr (std::is_same<DataType, int32_t>::value)
-			return target_element[member].IsInt();
-		else if constexpr (std::is_same<DataType, uint32_t>::value)
-			return target_element[member].IsUint();
-		else if constexpr (std::is_same<DataType, int64_t>::value)
-			return target_element[member].IsInt64();
-		else if constexpr (std::is_same<DataType, uint64_t>::value)
-			return target_element[member].IsUint64();
-		else if constexpr (std::is_same<DataType, bool>::value)
-			return target_element[member].IsBool();
-		else if constexpr (std::is_floating_point<DataType>::value)
-			return target_element[member].IsDouble();
-		else if constexpr (std::is_same<DataType, char>::value
-			|| std::is_same<DataType, const char>::value
-			|| std::is_same<DataType, char*>::value
-			|| std::is_same<DataType, const char*>::value
-			|| std::is_same<DataType, std::string>::value
-			|| std::is_same<DataType, const std::string>::value)
-			return target_element[member].IsString();
-		else if constexpr (std::is_integral<DataType>::value && std::is_signed<DataType>::value)
-			return target_element[member].IsInt64();
-		else if constexpr (std::is_integral<DataType>::value && std::is_unsigned<DataType>::value)
-			return target_element[member].IsUint64();
-		else
-			static_assert(false, "Attempting to invoke rjutil::IsValid<>() with invalid data type");
+	public:
+		InsituDocument() = default;
+		~InsituDocument() { Release(); }
 
-		return false;
-	}
+		InsituDocument(const InsituDocument&) = delete;
+		InsituDocument& operator=(const InsituDocument&) = delete;
 
-	template<typename Ch = char, typename RapidJsonTarget>
-	inline bool IsValidArray(const RapidJsonTarget& target_element, const Ch* member)
-	{
-		static_assert (std::is_same<RapidJsonTarget, rapidjson::Document>::value || std::is_same<RapidJsonTarget, rapidjson::Value>::value, "rjutil::IsValidJsonArray() only supports rapidjson::Document and rapidjson::Value as the first parameter");
-		return target_element.HasMember(member) && target_element[member].IsArray();
-	}
+		InsituDocument(InsituDocument&& other) noexcept { *this = std::move(other); }
+		InsituDocument& operator=(InsituDocument&& other) noexcept
+		{
+			if (this != &other)
+			{
+				Release();
+				document = std::move(other.document);
+				buffer = std::exchange(other.buffer, nullptr);
+				buffer_size = std::exchange(other.buffer_size, 0);
+				mapped = std::exchange(other.mapped, false);
+			}
+			return *this;
+		}
 
-	template<typename Ch = char, typename RapidJsonTarget>
-	inline bool IsValidObject(const RapidJsonTarget& target_element, const Ch* member)
-	{
-		static_assert (std::is_same<RapidJsonTarget, rapidjson::Document>::value || std::is_same<RapidJsonTarget, rapidjson::Value>::value, "rjutil::IsValidJsonObject() only supports rapidjson::Document and rapidjson::Value as the first parameter");
-		return target_element.HasMember(member) && target_element[member].IsObject();
-	}
+		rapidjson::Document& GetDocument() { return document; }
+		const rapidjson::Document& GetDocument() const { return document; }
+		rapidjson::Document* operator->() { return &document; }
+		const rapidjson::Document* operator->() const { return &document; }
 
-	template<typename DataType, typename Ch = char, typename RapidJsonTarget>
-	inline DataType Extract(const RapidJsonTarget& target_element, const Ch* member, DataType default_value)
-	{
-		static_assert (std::is_same<RapidJsonTarget, rapidjson::Document>::value || std::is_same<RapidJsonTarget, rapidjson::Value>::value, "rjutil::Extract<>() only supports rapidjson::Document and rapidjson::Value as the first parameter");
+		// True if the file was memory-mapped rather than read into a heap buffer
+		bool IsMapped() const { return mapped; }
 
-		if (!target_element.HasMember(member))
-			return default_value;
+		// Size of the file the Document was parsed from
+		size_t GetBufferSize() const { return buffer_size; }
 
-		if constexpr (std::is_same<DataType, int32_t>::value)
-		{
-			if (target_element[member].IsInt())
-				return target_element[member].GetInt();
+	private:
+		friend bool ParseFileInsitu(const char* file_name, InsituDocument& out_document);
+		friend bool ParseFileMapped(const char* file_name, InsituDocument& out_document);
+		friend bool ParseFileCached(const char* file_name, InsituDocument& out_document);
 
-			// If you hit this assert, there's a good chance you're not specializing the function
-			// call (e.g. `Extract<int32_t>`) and the compiler is relying in detecting the type of
-			// DataType parameter. If you're specializing it, you probably selected the wrong type
-			// for the specialization.
-			assert(!target_element[member].IsNumber());
-		}
-		else if constexpr (std::is_same<DataType, uint32_t>::value)
-		{
-			if (target_element[member].IsUint())
-				return target_element[member].GetUint();
-		}
-		else if constexpr (std::is_same<DataType, int64_t>::value)
-		{
-			if (target_element[member].IsInt64())
-				return target_element[member].GetInt64();
-		}
-		else if constexpr (std::is_same<DataType, uint64_t>::value)
-		{
-			if (target_element[member].IsUint64())
-				return target_element[member].GetUint64();
-		}
-		else if constexpr (std::is_same<DataType, bool>::value)
-		{
-			if (target_element[member].IsBool())
-				return target_element[member].GetBool();
-		}
-		else if constexpr (std::is_same<DataType, float>::value)
+		void Release()
 		{
-			if (target_element[member].IsDouble())
-				return static_cast<float>(target_element[member].GetDouble());
+			document.SetNull();
+			if (!buffer)
+				return;
+		#ifdef _WIN32
+			if (mapped)
+				UnmapViewOfFile(buffer);
+		#else
+			if (mapped)
+				munmap(buffer, buffer_size);
+		#endif
+			else
+				free(buffer);
+			buffer = nullptr;
+			buffer_size = 0;
+			mapped = false;
 		}
-		else if constexpr (std::is_floating_point<DataType>::value)
-		{
-			if (target_element[member].IsDouble())
-				return target_element[member].GetDouble();
-		}
-		else if constexpr (std::is_same<DataType, char>::value
-			|| std::is_same<DataType, const char>::value
-			|| std::is_same<DataType, char*>::value
-			|| std::is_same<DataType, const char*>::value
-			|| std::is_same<DataType, std::string>::value
-			|| std::is_same<DataType, const std::string>::value)
+
+		bool Parse()
 		{
-			if (target_element[member].IsString())
-				return target_element[member].GetString();
+			document.ParseInsitu(buffer);
+			return !document.HasParseError();
 		}
-		else if constexpr (std::is_integral<DataType>::value && std::is_signed<DataType>::value)
+
+		rapidjson::Document document;
+		char* buffer = nullptr;
+		size_t buffer_size = 0;
+		bool mapped = false;
+	};
+
+	// Reads the whole file with a single read into the buffer returned by `allocate(size)`, which
+	// needs room for `size` bytes (and may return nullptr). `out_error` gets the errno of the
+	// failed step, or 0.
+	template<typename Allocate>
+	inline bool ReadWholeFile(const char* file_name, Allocate&& allocate, size_t& out_size, int& out_error)
+	{
+		FILE* fp = OpenFile(file_name, "rb");
+		if (!fp)
 		{
-			if (target_element[member].IsInt64())
-				return target_element[member].GetInt64();
+			out_error = errno;
+			return false;
 		}
-		else if constexpr (std::is_integral<DataType>::value && std::is_unsigned<DataType>::value)
+
+	#ifdef _WIN32
+		_fseeki64(fp, 0, SEEK_END);
+		const long long fileSize = _ftelli64(fp);
+		_fseeki64(fp, 0, SEEK_SET);
+	#else
+		struct stat fileStat;
+		const long long fileSize = fstat(fileno(fp), &fileStat) == 0 ? static_cast<long long>(fileStat.st_size) : -1;
+	#endif
+		if (fileSize < 0)
 		{
-			if (target_element[member].IsUint64())
-				return target_element[member].GetUint64();
+			out_error = errno;
+			fclose(fp);
+			return false;
 		}
-		else
+
+		const size_t size = static_cast<size_t>(fileSize);
+		char* buffer = allocate(size);
+		if (!buffer && size > 0)	// An empty std::vector may have no storage at all
 		{
-			static_assert(false, "Attempting to invoke rjutil::Extract<>() with invalid data type");
+			out_error = ENOMEM;
+			fclose(fp);
+			return false;
 		}
 
-		return default_value;
+		const size_t bytesRead = size ? fread(buffer, 1, size, fp) : 0;
+		out_error = bytesRead == size ? 0 : (ferror(fp) ? errno : EIO);
+		fclose(fp);
+		out_size = size;
+		return out_error == 0;
 	}
 
-	template<typename DataType, typename Ch = char, typename RapidJsonTarget>
-	inline DataType ExtractFromNumericOrString(const RapidJsonTarget& target_element, const Ch* member, DataType default_value)
+	// Reads the whole file with a single read into a malloc()ed, null-terminated buffer. Returns
+	// nullptr on errors.
+	inline char* ReadFileToBuffer(const char* file_name, size_t& out_size)
 	{
-		static_assert (std::is_same<RapidJsonTarget, rapidjson::Document>::value || std::is_same<RapidJsonTarget, rapidjson::Value>::value, "ExtractFromNumericOrString() only supports rapidjson::Document and rapidjson::Value as the first parameter");
-
-		if (!target_element.HasMember(member))
-			return default_value;
-
-		if (target_element[member].IsNumber())
-			return Extract<DataType>(target_element, member, default_value);
-
-		if (target_element[member].IsString())
+		char* buffer = nullptr;
+		size_t size = 0;
+		int error = 0;
+		auto allocate = [&](size_t file_size) { buffer = static_cast<char*>(malloc(file_size + 1)); return buffer; };
+		if (!ReadWholeFile(file_name, allocate, size, error))
 		{
-			if constexpr (std::is_same<DataType, int32_t>::value)
-			{
-				const int32_t value = strtol(target_element[member].GetString(), nullptr, 10);
+			assert(buffer && "rjutils: can't open the file");
+			free(buffer);
+			return nullptr;
+		}
 
-				// If you hit this assert, there's a good chance you're not specializing the function
-				// call (e.g. `ExtractFromNumericOrString<int32_t>`) and the compiler is relying in
-				// detecting the type of DataType parameter. If you're specializing it, you probably
-				// selected the wrong type for the specialization.
-				//
-				// Please notice: If you ARE specializing it and still getting this error, use a
-				// larger variable type (e.g. int64_t). You're getting results out of signed 32 bits
-				// int bounds.
-				assert(errno != ERANGE);
+		buffer[size] = '\0';
+		out_size = size;
+		return buffer;
+	}
 
-				if (errno != 0)
-					return default_value;
+	// Reads the whole file with a single read into a buffer owned by `out_document` and parses it
+	// in-situ.
+	inline bool ParseFileInsitu(const char* file_name, InsituDocument& out_document)
+	{
+		ScopedParseTimer timer;
+		out_document.Release();
 
-				return value;
-			}
-			else if constexpr (std::is_same<DataType, uint32_t>::value)
-			{
-				const uint32_t value = strtoul(target_element[member].GetString(), nullptr, 10);
+		size_t size = 0;
+		char* buffer = ReadFileToBuffer(file_name, size);
+		if (!buffer)
+			return false;
 
-				// Out of bounds?
-				assert(errno != ERANGE);
+		timer.SetBytes(size);
+		out_document.buffer = buffer;
+		out_document.buffer_size = size;
+		out_document.mapped = false;
+		return out_document.Parse();
+	}
 
-				if (errno != 0)
-					return default_value;
+	// Memory-maps the file copy-on-write and parses it in-situ, which saves the read() copy.
+	// ParseInsitu() writes a '\0' after every string and key, so every page holding one gets
+	// copied: string-heavy files end up almost entirely private, and only pages of pure numbers
+	// or whitespace stay shared with the page cache. ParseInsitu() also needs a terminating
+	// '\0', which the mapping only has when the file doesn't end exactly on a page boundary; the
+	// (rare) other files, and files that can't be mapped, fall back to ParseFileInsitu().
+	inline bool ParseFileMapped(const char* file_name, InsituDocument& out_document)
+	{
+		ScopedParseTimer timer;
+		out_document.Release();
 
-				return value;
-			}
-			else if constexpr (std::is_same<DataType, int64_t>::value)
-			{
-				const int64_t value = strtoll(target_element[member].GetString(), nullptr, 10);
+	#ifdef _WIN32
+		HANDLE file = CreateFileA(file_name, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+			return ParseFileInsitu(file_name, out_document);
 
-				// Out of bounds?
-				assert(errno != ERANGE);
+		LARGE_INTEGER fileSize;
+		SYSTEM_INFO systemInfo;
+		GetSystemInfo(&systemInfo);
+		if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0 || fileSize.QuadPart % systemInfo.dwPageSize == 0)
+		{
+			CloseHandle(file);
+			return ParseFileInsitu(file_name, out_document);
+		}
 
-				if (errno != 0)
-					return default_value;
+		HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+		CloseHandle(file);
+		if (!mapping)
+			return ParseFileInsitu(file_name, out_document);
 
-				return value;
-			}
-			else if constexpr (std::is_same<DataType, uint64_t>::value)
-			{
-				const uint64_t value = strtoull(target_element[member].GetString(), nullptr, 10);
+		void* view = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+		CloseHandle(mapping);	// The view keeps the mapping alive
+		if (!view)
+			return ParseFileInsitu(file_name, out_document);
 
-				// Out of bounds?
-				assert(errno != ERANGE);
+		out_document.buffer = static_cast<char*>(view);
+		out_document.buffer_size = static_cast<size_t>(fileSize.QuadPart);
+	#else
+		const int fd = open(file_name, O_RDONLY);
+		if (fd < 0)
+			return ParseFileInsitu(file_name, out_document);
 
-				if (errno != 0)
-					return default_value;
+		struct stat fileStat;
+		const long pageSize = sysconf(_SC_PAGESIZE);
+		if (fstat(fd, &fileStat) != 0 || fileStat.st_size == 0 || pageSize <= 0 || fileStat.st_size % pageSize == 0)
+		{
+			close(fd);
+			return ParseFileInsitu(file_name, out_document);
+		}
 
-				return value;
-			}
-			else if constexpr (std::is_same<DataType, float>::value)
-			{
-				const float value = strtof(target_element[member].GetString(), nullptr);
+		const size_t size = static_cast<size_t>(fileStat.st_size);
+		void* view = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+		close(fd);	// The mapping keeps the file alive
+		if (view == MAP_FAILED)
+			return ParseFileInsitu(file_name, out_document);
 
-				// Out of bounds?
-				assert(errno != ERANGE);
+		madvise(view, size, MADV_SEQUENTIAL);
+		out_document.buffer = static_cast<char*>(view);
+		out_document.buffer_size = size;
+	#endif
+		out_document.mapped = true;
+		timer.SetBytes(out_document.buffer_size);
+		return out_document.Parse();
+	}
 
-				if (errno != 0)
-					return default_value;
+	//
+	// Binary snapshots
+	//
+	// ParseFileCached() parses a file once and saves the resulting Document next to it, as
+	// "<file_name>.rjsnap": a compact, position-independent binary encoding (no pointers, just a
+	// pre-order stream of tagged values). Later calls memory-map the snapshot read-only and
+	// rebuild the Document from it in a single linear pass, with no tokenizing, number conversion
+	// or string unescaping, and with every string pointing straight into the mapping.
+	//
+	// The snapshot is keyed by the source's size, modification time (in nanoseconds) and content
+	// hash: when only the time changed (e.g. the file was copied over unchanged), the hash is
+	// compared and the snapshot restamped; otherwise the source is parsed again and the snapshot
+	// rewritten. Filesystem timestamps are coarser than they look (kernel ticks, 2 s on FAT), so a
+	// source modified within RACY_STAMP_WINDOW of the snapshot being written is always compared
+	// by hash too: a same-size rewrite right after saving can keep the exact time it was saved
+	// with. Not being able to write the snapshot (e.g. a read-only directory) isn't an error.
+	//
+	// Strings in a Document loaded from a snapshot are read-only: setting new values is fine, but
+	// don't write through GetString().
+	//
 
-				return value;
-			}
-			else if constexpr (std::is_floating_point<DataType>::value)
-			{
-				const double value = strtod(target_element[member].GetString(), nullptr);
+	struct SnapshotHeader
+	{
+		static constexpr char MAGIC[8] = { 'R', 'J', 'S', 'N', 'A', 'P', '\0', '\0' };
+		static constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+		static constexpr uint32_t VERSION = 2;
+		static constexpr int64_t RACY_STAMP_WINDOW = 2000000000;	// Nanoseconds
 
-				// Out of bounds?
-				assert(errno != ERANGE);
+		char magic[8];
+		uint32_t byte_order;			// Snapshots are native-endian; rejected on mismatch
+		uint32_t version;
+		uint64_t source_size;
+		int64_t source_mtime;			// Nanoseconds since the Unix epoch
+		uint64_t source_hash;
+		uint64_t body_size;
+	};
 
-				if (errno != 0)
-					return default_value;
+	enum class SnapshotTag : uint8_t { Null, False, True, Int64, Uint64, Double, String, Array, Object };
 
-				return value;
-			}
+	// 64-bit FNV-1a
+	inline uint64_t HashBytes(const char* data, size_t size)
+	{
+		uint64_t hash = 0xCBF29CE484222325ULL;
+		for (size_t i = 0; i < size; ++i)
+		{
+			hash ^= static_cast<unsigned char>(data[i]);
+			hash *= 0x100000001B3ULL;
 		}
+		return hash;
+	}
 
-		return default_value;
+	// Modification times in nanoseconds since the Unix epoch
+#ifdef _WIN32
+	inline int64_t FileTimeToNanoseconds(const FILETIME& file_time)
+	{
+		// 100 ns intervals since 1601
+		const int64_t ticks = static_cast<int64_t>((static_cast<uint64_t>(file_time.dwHighDateTime) << 32) | file_time.dwLowDateTime);
+		return (ticks - 116444736000000000LL) * 100;
+	}
+#else
+	inline int64_t GetModificationTime(const struct stat& file_stat)
+	{
+	#ifdef __APPLE__
+		const timespec& mtime = file_stat.st_mtimespec;
+	#else
+		const timespec& mtime = file_stat.st_mtim;
+	#endif
+		return static_cast<int64_t>(mtime.tv_sec) * 1000000000 + mtime.tv_nsec;
+	}
+#endif
+
+	inline bool GetFileStamp(const char* file_name, uint64_t& out_size, int64_t& out_mtime)
+	{
+	#ifdef _WIN32
+		WIN32_FILE_ATTRIBUTE_DATA attributes;
+		if (!GetFileAttributesExA(file_name, GetFileExInfoStandard, &attributes))
+			return false;
+		out_size = (static_cast<uint64_t>(attributes.nFileSizeHigh) << 32) | attributes.nFileSizeLow;
+		out_mtime = FileTimeToNanoseconds(attributes.ftLastWriteTime);
+	#else
+		struct stat fileStat;
+		if (stat(file_name, &fileStat) != 0)
+			return false;
+		out_size = static_cast<uint64_t>(fileStat.st_size);
+		out_mtime = GetModificationTime(fileStat);
+	#endif
+		return true;
+	}
+
+	inline void WriteSnapshotString(const char* str, rapidjson::SizeType length, std::vector<char>& out)
+	{
+		const uint32_t length32 = length;
+		out.insert(out.end(), reinterpret_cast<const char*>(&length32), reinterpret_cast<const char*>(&length32) + sizeof(length32));
+		out.insert(out.end(), str, str + length);
+		out.push_back('\0');	// Lets the loaded strings point into the mapping
+	}
+
+	inline void WriteSnapshotValue(const rapidjson::Value& value, std::vector<char>& out)
+	{
+		auto writeTag = [&](SnapshotTag tag) { out.push_back(static_cast<char>(tag)); };
+		auto writeRaw = [&](const auto& raw) { out.insert(out.end(), reinterpret_cast<const char*>(&raw), reinterpret_cast<const char*>(&raw) + sizeof(raw)); };
+
+		if (value.IsNull())
+			writeTag(SnapshotTag::Null);
+		else if (value.IsBool())
+			writeTag(value.GetBool() ? SnapshotTag::True : SnapshotTag::False);
+		else if (value.IsInt64())
+		{
+			writeTag(SnapshotTag::Int64);
+			writeRaw(value.GetInt64());
+		}
+		else if (value.IsUint64())
+		{
+			writeTag(SnapshotTag::Uint64);
+			writeRaw(value.GetUint64());
+		}
+		else if (value.IsNumber())
+		{
+			writeTag(SnapshotTag::Double);
+			writeRaw(value.GetDouble());
+		}
+		else if (value.IsString())
+		{
+			writeTag(SnapshotTag::String);
+			WriteSnapshotString(value.GetString(), value.GetStringLength(), out);
+		}
+		else if (value.IsArray())
+		{
+			writeTag(SnapshotTag::Array);
+			writeRaw(static_cast<uint32_t>(value.Size()));
+			for (const rapidjson::Value& element : value.GetArray())
+				WriteSnapshotValue(element, out);
+		}
+		else
+		{
+			writeTag(SnapshotTag::Object);
+			writeRaw(static_cast<uint32_t>(value.MemberCount()));
+			for (rapidjson::Value::ConstMemberIterator member = value.MemberBegin(); member != value.MemberEnd(); ++member)
+			{
+				WriteSnapshotString(member->name.GetString(), member->name.GetStringLength(), out);
+				WriteSnapshotValue(member->value, out);
+			}
+		}
+	}
+
+	// Rebuilds values from a snapshot body, checking every read against its end
+	class SnapshotReader
+	{
+	public:
+		SnapshotReader(const char* body, size_t body_size, rapidjson::Document::AllocatorType& allocator_)
+			: cursor(body)
+			, end(body + body_size)
+			, allocator(allocator_)
+		{
+		}
+
+		bool ReadValue(rapidjson::Value& out_value)
+		{
+			uint8_t tag = 0;
+			if (!ReadRaw(tag))
+				return false;
+
+			switch (static_cast<SnapshotTag>(tag))
+			{
+			case SnapshotTag::Null: out_value.SetNull(); return true;
+			case SnapshotTag::False: out_value.SetBool(false); return true;
+			case SnapshotTag::True: out_value.SetBool(true); return true;
+			case SnapshotTag::Int64: { int64_t i = 0; if (!ReadRaw(i)) return false; out_value.SetInt64(i); return true; }
+			case SnapshotTag::Uint64: { uint64_t u = 0; if (!ReadRaw(u)) return false; out_value.SetUint64(u); return true; }
+			case SnapshotTag::Double: { double d = 0.0; if (!ReadRaw(d)) return false; out_value.SetDouble(d); return true; }
+			case SnapshotTag::String: return ReadString(out_value);
+			case SnapshotTag::Array:
+			{
+				uint32_t count = 0;
+				if (!ReadRaw(count) || count > static_cast<size_t>(end - cursor))	// Every element takes 1+ byte
+					return false;
+				out_value.SetArray();
+				out_value.Reserve(count, allocator);
+				for (uint32_t i = 0; i < count; ++i)
+				{
+					rapidjson::Value element;
+					if (!ReadValue(element))
+						return false;
+					out_value.PushBack(element, allocator);
+				}
+				return true;
+			}
+			case SnapshotTag::Object:
+			{
+				uint32_t count = 0;
+				if (!ReadRaw(count))
+					return false;
+				out_value.SetObject();
+				for (uint32_t i = 0; i < count; ++i)
+				{
+					rapidjson::Value name;
+					rapidjson::Value value;
+					if (!ReadString(name) || !ReadValue(value))
+						return false;
+					out_value.AddMember(name, value, allocator);
+				}
+				return true;
+			}
+			default:
+				return false;
+			}
+		}
+
+		bool IsAtEnd() const { return cursor == end; }
+
+	private:
+		template<typename T>
+		bool ReadRaw(T& out_raw)
+		{
+			if (static_cast<size_t>(end - cursor) < sizeof(T))
+				return false;
+			memcpy(&out_raw, cursor, sizeof(T));
+			cursor += sizeof(T);
+			return true;
+		}
+
+		bool ReadString(rapidjson::Value& out_value)
+		{
+			uint32_t length = 0;
+			if (!ReadRaw(length) || static_cast<size_t>(end - cursor) <= length || cursor[length] != '\0')
+				return false;
+			out_value.SetString(rapidjson::StringRef(cursor, length));
+			cursor += length + 1;
+			return true;
+		}
+
+		const char* cursor;
+		const char* end;
+		rapidjson::Document::AllocatorType& allocator;
+	};
+
+	// Writes `document` as the snapshot of a source with the given stamp. Goes through a
+	// temporary file, so readers never see a partial snapshot.
+	inline bool SaveSnapshot(const rapidjson::Value& document, const char* snapshot_name, uint64_t source_size, int64_t source_mtime, uint64_t source_hash)
+	{
+		std::vector<char> body;
+		WriteSnapshotValue(document, body);
+
+		SnapshotHeader header;
+		memcpy(header.magic, SnapshotHeader::MAGIC, sizeof(header.magic));
+		header.byte_order = SnapshotHeader::BYTE_ORDER_MARK;
+		header.version = SnapshotHeader::VERSION;
+		header.source_size = source_size;
+		header.source_mtime = source_mtime;
+		header.source_hash = source_hash;
+		header.body_size = body.size();
+
+		const std::string temporaryName = std::string(snapshot_name) + ".tmp";
+		FILE* fp = OpenFile(temporaryName.c_str(), "wb");
+		if (!fp)
+			return false;
+
+		const bool written = fwrite(&header, sizeof(header), 1, fp) == 1
+			&& fwrite(body.data(), 1, body.size(), fp) == body.size();
+		if (fclose(fp) != 0 || !written)
+		{
+			remove(temporaryName.c_str());
+			return false;
+		}
+
+	#ifdef _WIN32
+		if (!MoveFileExA(temporaryName.c_str(), snapshot_name, MOVEFILE_REPLACE_EXISTING))
+	#else
+		if (rename(temporaryName.c_str(), snapshot_name) != 0)
+	#endif
+		{
+			remove(temporaryName.c_str());
+			return false;
+		}
+		return true;
+	}
+
+	// Parses `file_name` from its snapshot when it's still valid, or parses it in-situ and saves a
+	// new snapshot otherwise.
+	inline bool ParseFileCached(const char* file_name, InsituDocument& out_document)
+	{
+		ScopedParseTimer timer;
+		out_document.Release();
+
+		uint64_t sourceSize = 0;
+		int64_t sourceMtime = 0;
+		if (!GetFileStamp(file_name, sourceSize, sourceMtime))
+			return ParseFileInsitu(file_name, out_document);
+
+		timer.SetBytes(static_cast<size_t>(sourceSize));
+		const std::string snapshotName = std::string(file_name) + ".rjsnap";
+
+		// Map the snapshot read-only
+		char* view = nullptr;
+		size_t viewSize = 0;
+		int64_t snapshotMtime = 0;
+	#ifdef _WIN32
+		HANDLE file = CreateFileA(snapshotName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file != INVALID_HANDLE_VALUE)
+		{
+			LARGE_INTEGER fileSize;
+			FILETIME lastWrite;
+			if (GetFileSizeEx(file, &fileSize) && static_cast<uint64_t>(fileSize.QuadPart) >= sizeof(SnapshotHeader)
+				&& GetFileTime(file, nullptr, nullptr, &lastWrite))
+			{
+				snapshotMtime = FileTimeToNanoseconds(lastWrite);
+				HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+				if (mapping)
+				{
+					view = static_cast<char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+					viewSize = static_cast<size_t>(fileSize.QuadPart);
+					CloseHandle(mapping);	// The view keeps the mapping alive
+				}
+			}
+			CloseHandle(file);
+		}
+	#else
+		const int fd = open(snapshotName.c_str(), O_RDONLY);
+		if (fd >= 0)
+		{
+			struct stat fileStat;
+			if (fstat(fd, &fileStat) == 0 && static_cast<uint64_t>(fileStat.st_size) >= sizeof(SnapshotHeader))
+			{
+				void* mapped = mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+				if (mapped != MAP_FAILED)
+				{
+					view = static_cast<char*>(mapped);
+					viewSize = static_cast<size_t>(fileStat.st_size);
+					snapshotMtime = GetModificationTime(fileStat);
+					madvise(view, viewSize, MADV_SEQUENTIAL);
+				}
+			}
+			close(fd);	// The mapping keeps the file alive
+		}
+	#endif
+
+		if (view)
+		{
+			// The InsituDocument owns the mapping from here on, and unmaps it on Release()
+			out_document.buffer = view;
+			out_document.buffer_size = viewSize;
+			out_document.mapped = true;
+
+			SnapshotHeader header;
+			memcpy(&header, view, sizeof(header));
+			bool valid = memcmp(header.magic, SnapshotHeader::MAGIC, sizeof(header.magic)) == 0
+				&& header.byte_order == SnapshotHeader::BYTE_ORDER_MARK
+				&& header.version == SnapshotHeader::VERSION
+				&& header.source_size == sourceSize
+				&& header.body_size == viewSize - sizeof(SnapshotHeader);
+
+			const bool racy = sourceMtime >= snapshotMtime - SnapshotHeader::RACY_STAMP_WINDOW;
+			if (valid && (header.source_mtime != sourceMtime || racy))
+			{
+				// Touched (or maybe rewritten without the time showing it), but maybe not changed:
+				// compare the contents, and restamp the snapshot
+				size_t size = 0;
+				char* source = ReadFileToBuffer(file_name, size);
+				valid = source && HashBytes(source, size) == header.source_hash;
+				free(source);
+
+				if (valid)
+				{
+					FILE* fp = OpenFile(snapshotName.c_str(), "r+b");
+					if (fp)
+					{
+						header.source_mtime = sourceMtime;
+						fwrite(&header, sizeof(header), 1, fp);
+						fclose(fp);
+					}
+				}
+			}
+
+			if (valid)
+			{
+				SnapshotReader reader(view + sizeof(SnapshotHeader), viewSize - sizeof(SnapshotHeader), out_document.document.GetAllocator());
+				if (reader.ReadValue(out_document.document) && reader.IsAtEnd())
+					return true;
+			}
+			out_document.Release();
+		}
+
+		// Stale or missing snapshot: parse the source, hashing it before it's modified in-situ
+		size_t size = 0;
+		char* buffer = ReadFileToBuffer(file_name, size);
+		if (!buffer)
+			return false;
+
+		const uint64_t sourceHash = HashBytes(buffer, size);
+		out_document.buffer = buffer;
+		out_document.buffer_size = size;
+		out_document.mapped = false;
+		if (!out_document.Parse())
+			return false;
+
+		SaveSnapshot(out_document.document, snapshotName.c_str(), sourceSize, sourceMtime, sourceHash);
+		return true;
+	}
+
+	// Reusable parsing context for high-rate parsing of many (usually small) documents.
+	//
+	// A plain Document mallocs its value pool, its parse stack and (in ParseFile) the read buffer
+	// again for every document. A Parser keeps all three alive between parses: values and the
+	// parse stack come from two arenas (memory pools over buffers that are merely rewound by
+	// Clear()), and the file read buffer is allocated once. When a document doesn't fit, the
+	// pools fall back to the heap for that parse and the owned arenas grow to fit on the next
+	// Clear(), so after warm-up parsing does no heap allocations at all.
+	//
+	// The parsed Document (and every value or string taken from it) is only valid until the
+	// next parse or Clear(). A Parser is not thread-safe; use one per thread, e.g.
+	// ThreadLocalParser():
+	//
+	//     rjutils::Parser& parser = rjutils::ThreadLocalParser();
+	//     for (const Message& message : messages)
+	//         if (parser.Parse(message.data, message.size))
+	//             Handle(rjutils::Extract<int64_t>(parser.GetDocument(), "id", 0));
+	//
+	class Parser
+	{
+	public:
+		typedef rapidjson::MemoryPoolAllocator<> AllocatorType;
+		typedef rapidjson::GenericDocument<rapidjson::UTF8<>, AllocatorType, AllocatorType> DocumentType;
+
+		static constexpr size_t DEFAULT_ARENA_SIZE = 64 * 1024;
+		static constexpr size_t DEFAULT_STACK_ARENA_SIZE = 16 * 1024;
+		static constexpr size_t READ_BUFFER_SIZE = 65536;
+
+		// Owned arenas, grown as needed
+		explicit Parser(size_t arena_size = DEFAULT_ARENA_SIZE, size_t stack_arena_size = DEFAULT_STACK_ARENA_SIZE)
+			: owned_arena(arena_size)
+			, owned_stack_arena(stack_arena_size)
+			, arena(owned_arena.data())
+			, arena_size(arena_size)
+			, stack_arena(owned_stack_arena.data())
+			, stack_arena_size(stack_arena_size)
+			, owns_arenas(true)
+		{
+			Reset();
+		}
+
+		// Caller-supplied arenas, which must outlive the Parser. When a document doesn't fit,
+		// the overflow comes from the heap (they can't grow).
+		Parser(void* arena_buffer, size_t arena_buffer_size, void* stack_arena_buffer, size_t stack_arena_buffer_size)
+			: arena(static_cast<char*>(arena_buffer))
+			, arena_size(arena_buffer_size)
+			, stack_arena(static_cast<char*>(stack_arena_buffer))
+			, stack_arena_size(stack_arena_buffer_size)
+			, owns_arenas(false)
+		{
+			Reset();
+		}
+
+		// The Document points into the arenas
+		Parser(const Parser&) = delete;
+		Parser& operator=(const Parser&) = delete;
+
+		bool ParseFile(const char* file_name)
+		{
+			ScopedParseTimer timer;
+			Clear();
+
+			FILE* fp = OpenFile(file_name, "rb");
+			assert(fp);
+			if (!fp)
+				return false;
+
+			if (read_buffer.empty())
+				read_buffer.resize(READ_BUFFER_SIZE);
+
+			rapidjson::FileReadStream is(fp, read_buffer.data(), read_buffer.size());
+			document->ParseStream(is);
+			timer.SetBytes(is.Tell());
+			fclose(fp);
+
+			return !document->HasParseError();
+		}
+
+		// `json` must be null-terminated
+		bool Parse(const char* json)
+		{
+			Clear();
+			document->Parse(json);
+			return !document->HasParseError();
+		}
+
+		bool Parse(const char* json, size_t length)
+		{
+			Clear();
+			document->Parse(json, length);
+			return !document->HasParseError();
+		}
+
+		// Parses in place, modifying `json`; strings point into it, so it must outlive the Document
+		bool ParseInsitu(char* json)
+		{
+			Clear();
+			document->ParseInsitu(json);
+			return !document->HasParseError();
+		}
+
+		DocumentType& GetDocument() { return *document; }
+		const DocumentType& GetDocument() const { return *document; }
+		AllocatorType& GetAllocator() { return *allocator; }
+
+		// Releases the current Document, keeping the arenas (growing owned ones to fit the largest
+		// document seen so far)
+		void Clear()
+		{
+			const size_t capacity = allocator->Capacity();
+			const size_t stackCapacity = stack_allocator->Capacity();
+
+			// The pools write into their buffers when destroyed, so they must go before the buffers do
+			document.reset();
+			allocator.reset();
+			stack_allocator.reset();
+			if (owns_arenas)
+			{
+				if (capacity > arena_size)
+					GrowArena(owned_arena, arena, arena_size, capacity);
+				if (stackCapacity > stack_arena_size)
+					GrowArena(owned_stack_arena, stack_arena, stack_arena_size, stackCapacity);
+			}
+			Reset();
+		}
+
+		size_t GetArenaSize() const { return arena_size; }
+		size_t GetStackArenaSize() const { return stack_arena_size; }
+
+	private:
+		static void GrowArena(std::vector<char>& owned, char*& buffer, size_t& size, size_t required)
+		{
+			while (size < required)
+				size *= 2;
+			owned = std::vector<char>(size);
+			buffer = owned.data();
+		}
+
+		// A pool over a user buffer is rewound (not freed) by recreating it, which never allocates
+		void Reset()
+		{
+			document.reset();
+			stack_allocator.reset();
+			allocator.reset();
+			allocator.emplace(arena, arena_size);
+			stack_allocator.emplace(stack_arena, stack_arena_size);
+			document.emplace(&*allocator, stack_arena_size / 2, &*stack_allocator);
+		}
+
+		std::vector<char> owned_arena;
+		std::vector<char> owned_stack_arena;
+		std::vector<char> read_buffer;
+		char* arena;
+		size_t arena_size;
+		char* stack_arena;
+		size_t stack_arena_size;
+		bool owns_arenas;
+
+		// Declared after the arenas they point into, and the Document after its allocators
+		std::optional<AllocatorType> allocator;
+		std::optional<AllocatorType> stack_allocator;
+		std::optional<DocumentType> document;
+	};
+
+	// One Parser per thread, created on first use
+	inline Parser& ThreadLocalParser()
+	{
+		thread_local Parser parser;
+		return parser;
+	}
+
+	//
+	// Parallel multi-file loading
+	//
+	// Loads a batch of files into Documents on a small thread pool. Each worker reads whole files
+	// into its own reusable buffer and parses them from memory, so reads of some files overlap
+	// with the parsing of others, and every Document keeps its own allocator (no locking while
+	// parsing). Where the OS supports it, a read-ahead thread also asks the kernel to start
+	// reading the next files before any worker gets to them.
+	//
+	//     std::vector<rapidjson::Document> assets(file_names.size());
+	//     std::vector<rjutils::ParseFileStatus> status(file_names.size());
+	//     if (!rjutils::ParseFiles(file_names.data(), file_names.size(), assets.data(), status.data()))
+	//         ReportFailures(file_names, status);
+	//
+
+	struct ParseFileStatus
+	{
+		bool success = false;
+		int io_error = 0;												// errno of the failed open/read, 0 otherwise
+		rapidjson::ParseErrorCode parse_error = rapidjson::kParseErrorNone;
+		size_t error_offset = 0;
+	};
+
+	// Reads the whole file into `out_buffer`, keeping its capacity for the next file
+	inline bool ReadFile(const char* file_name, std::vector<char>& out_buffer, int& out_error)
+	{
+		size_t size = 0;
+		auto allocate = [&](size_t file_size) { out_buffer.resize(file_size); return out_buffer.data(); };
+		if (ReadWholeFile(file_name, allocate, size, out_error))
+			return true;
+		out_buffer.clear();
+		return false;
+	}
+
+	// Parses file_names[i] into out_documents[i] (which must hold `file_count` Documents), and
+	// returns if every file was parsed. Per-file results go to `out_status` when it isn't null.
+	// thread_count includes the calling thread; 0 means std::thread::hardware_concurrency().
+	inline bool ParseFiles(const char* const* file_names, size_t file_count, rapidjson::Document* out_documents,
+		ParseFileStatus* out_status = nullptr, unsigned int thread_count = 0)
+	{
+		if (thread_count == 0)
+			thread_count = std::thread::hardware_concurrency();
+		if (thread_count == 0)
+			thread_count = 1;
+		if (thread_count > file_count)
+			thread_count = static_cast<unsigned int>(file_count > 0 ? file_count : 1);
+
+		std::atomic<size_t> nextFile(0);
+		std::atomic<size_t> failedFiles(0);
+
+		// Wakes the read-ahead thread up when the workers move on
+		std::mutex readAheadMutex;
+		std::condition_variable readAheadCondition;
+		bool readAheadWaiting = false;
+
+		auto worker = [&]()
+		{
+			std::vector<char> buffer;
+			for (size_t i = nextFile.fetch_add(1, std::memory_order_relaxed); i < file_count; i = nextFile.fetch_add(1, std::memory_order_relaxed))
+			{
+				{
+					std::lock_guard<std::mutex> lock(readAheadMutex);
+					if (readAheadWaiting)
+						readAheadCondition.notify_one();
+				}
+
+				ScopedParseTimer timer;
+				ParseFileStatus status;
+				if (ReadFile(file_names[i], buffer, status.io_error))
+				{
+					timer.SetBytes(buffer.size());
+					out_documents[i].Parse(buffer.data(), buffer.size());
+					status.parse_error = out_documents[i].GetParseError();
+					status.error_offset = out_documents[i].GetErrorOffset();
+					status.success = !out_documents[i].HasParseError();
+				}
+
+				if (!status.success)
+					failedFiles.fetch_add(1, std::memory_order_relaxed);
+				if (out_status)
+					out_status[i] = status;
+			}
+		};
+
+	#if defined(POSIX_FADV_WILLNEED)
+		// Stays up to READ_AHEAD_FILES files ahead of the workers; the hint only starts asynchronous
+		// reads into the page cache, so it never blocks on the data itself.
+		constexpr size_t READ_AHEAD_FILES = 16;
+		bool done = false;
+		std::thread readAhead;
+		if (file_count > thread_count)
+		{
+			readAhead = std::thread([&]()
+			{
+				for (size_t i = 0; i < file_count; ++i)
+				{
+					{
+						std::unique_lock<std::mutex> lock(readAheadMutex);
+						readAheadWaiting = true;
+						readAheadCondition.wait(lock, [&]() { return done || i < nextFile.load(std::memory_order_relaxed) + READ_AHEAD_FILES; });
+						readAheadWaiting = false;
+						if (done)
+							return;
+					}
+
+					const int fd = open(file_names[i], O_RDONLY);
+					if (fd < 0)
+						continue;
+					posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+					close(fd);
+				}
+			});
+		}
+	#endif
+
+		std::vector<std::thread> workers;
+		workers.reserve(thread_count - 1);
+		for (unsigned int i = 1; i < thread_count; ++i)
+			workers.emplace_back(worker);
+		worker();
+		for (std::thread& thread : workers)
+			thread.join();
+
+	#if defined(POSIX_FADV_WILLNEED)
+		{
+			std::lock_guard<std::mutex> lock(readAheadMutex);
+			done = true;
+			readAheadCondition.notify_one();
+		}
+		if (readAhead.joinable())
+			readAhead.join();
+	#endif
+
+		return failedFiles.load(std::memory_order_relaxed) == 0;
+	}
+
+#if defined(__cpp_lib_span)
+	inline bool ParseFiles(std::span<const char* const> file_names, std::span<rapidjson::Document> out_documents,
+		std::span<ParseFileStatus> out_status = {}, unsigned int thread_count = 0)
+	{
+		assert(out_documents.size() >= file_names.size());
+		assert(out_status.empty() || out_status.size() >= file_names.size());
+		return ParseFiles(file_names.data(), file_names.size(), out_documents.data(), out_status.empty() ? nullptr : out_status.data(), thread_count);
+	}
+#endif
+
+	//
+	// Streaming array extraction
+	//
+	// Calls `visitor(element)` for each element of one array, without building a Document for
+	// the rest of the file. Only the current element is materialized, as a regular
+	// `rapidjson::Value`, so every function in this header works on it, and memory stays bounded
+	// by the largest element. The element (and anything extracted from it by pointer) is only
+	// valid during the call.
+	//
+	//     rjutils::ParseFileArray("orders.json", "line_items", [&](const rapidjson::Value& item)
+	//     {
+	//         total += rjutils::ExtractFromNumericOrString<double>(item, "price", 0.0);
+	//     });
+	//
+	// `array_name` names a member of the root object; pass nullptr when the root itself is the
+	// array. Parsing stops right after the array, and the visitor can stop it earlier by
+	// returning false (a visitor returning void always runs to the end of the array).
+	//
+
+	template<typename Visitor>
+	class ArrayElementHandler : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, ArrayElementHandler<Visitor>>
+	{
+	public:
+		typedef char Ch;
+
+		// Elements up to about SCRATCH_SIZE bytes are built without any heap allocation; larger
+		// ones take CHUNK_SIZE chunks from the heap, released after their visit
+		static constexpr size_t SCRATCH_SIZE = 64 * 1024;
+		static constexpr size_t CHUNK_SIZE = 256 * 1024;
+
+		ArrayElementHandler(const Ch* array_name_, Visitor& visitor_)
+			: array_name(array_name_)
+			, array_name_length(array_name_ ? strlen(array_name_) : 0)
+			, visitor(visitor_)
+			, scratch(new char[SCRATCH_SIZE])
+			, allocator(scratch.get(), SCRATCH_SIZE, CHUNK_SIZE)
+		{
+		}
+
+		// The allocator points into `scratch`
+		ArrayElementHandler(const ArrayElementHandler&) = delete;
+		ArrayElementHandler& operator=(const ArrayElementHandler&) = delete;
+
+		// True once the whole target array was read, or the visitor stopped early
+		bool IsFinished() const { return finished; }
+		bool IsArrayFound() const { return array_found; }
+
+		bool Null() { return AddScalar(rapidjson::Value()); }
+		bool Bool(bool b) { return AddScalar(rapidjson::Value(b)); }
+		bool Int(int i) { return AddScalar(rapidjson::Value(i)); }
+		bool Uint(unsigned u) { return AddScalar(rapidjson::Value(u)); }
+		bool Int64(int64_t i) { return AddScalar(rapidjson::Value(i)); }
+		bool Uint64(uint64_t u) { return AddScalar(rapidjson::Value(u)); }
+		bool Double(double d) { return AddScalar(rapidjson::Value(d)); }
+
+		bool String(const Ch* str, rapidjson::SizeType length, bool copy)
+		{
+			if (!InElement() && !StartsElement())
+			{
+				pending_array = false;
+				return true;
+			}
+			return AddScalar(MakeString(str, length, copy));
+		}
+
+		bool Key(const Ch* str, rapidjson::SizeType length, bool copy)
+		{
+			if (InElement())
+			{
+				values.push_back(MakeString(str, length, copy));
+				return true;
+			}
+
+			// Only members of the root object can name the array
+			pending_array = (depth == 1 && array_name && length == array_name_length && memcmp(str, array_name, length) == 0);
+			return true;
+		}
+
+		bool StartObject()
+		{
+			if (InElement() || StartsElement())
+				containers.push_back(values.size());
+			pending_array = false;
+			++depth;
+			return true;
+		}
+
+		bool EndObject(rapidjson::SizeType member_count)
+		{
+			--depth;
+			if (!InElement())
+				return true;
+
+			const size_t start = containers.back();
+			containers.pop_back();
+
+			rapidjson::Value object(rapidjson::kObjectType);
+			for (size_t i = 0; i < member_count; ++i)
+				object.AddMember(values[start + 2 * i], values[start + 2 * i + 1], allocator);
+			values.resize(start);
+			return AddScalar(std::move(object));
+		}
+
+		bool StartArray()
+		{
+			if (InElement() || StartsElement())
+			{
+				containers.push_back(values.size());
+			}
+			else if (pending_array || (!array_name && depth == 0))
+			{
+				// This is the target array: its elements live one level below
+				element_depth = depth + 1;
+				array_found = true;
+			}
+			pending_array = false;
+			++depth;
+			return true;
+		}
+
+		bool EndArray(rapidjson::SizeType element_count)
+		{
+			--depth;
+			if (element_depth != 0 && depth + 1 == element_depth)
+			{
+				// End of the target array; nothing after it is needed
+				finished = true;
+				return false;
+			}
+			if (!InElement())
+				return true;
+
+			const size_t start = containers.back();
+			containers.pop_back();
+
+			rapidjson::Value array(rapidjson::kArrayType);
+			array.Reserve(element_count, allocator);
+			for (size_t i = 0; i < element_count; ++i)
+				array.PushBack(values[start + i], allocator);
+			values.resize(start);
+			return AddScalar(std::move(array));
+		}
+
+	private:
+		// Inside an element of the target array (building it)
+		bool InElement() const { return !containers.empty(); }
+
+		// The next value is an element of the target array
+		bool StartsElement() const { return element_depth != 0 && depth == element_depth; }
+
+		rapidjson::Value MakeString(const Ch* str, rapidjson::SizeType length, bool copy)
+		{
+			if (copy)
+				return rapidjson::Value(str, length, allocator);
+			return rapidjson::Value(rapidjson::StringRef(str, length));
+		}
+
+		bool AddScalar(rapidjson::Value&& value)
+		{
+			if (InElement())
+			{
+				values.push_back(std::move(value));
+				return true;
+			}
+
+			pending_array = false;
+			if (!StartsElement())
+				return true;
+
+			// A complete element: hand it over, then rewind the pool to the start of the scratch
+			// buffer (freeing only the chunks an unusually large element needed)
+			const rapidjson::Value element(std::move(value));
+			bool keepGoing = true;
+			if constexpr (std::is_same<decltype(visitor(element)), bool>::value)
+				keepGoing = visitor(element);
+			else
+				visitor(element);
+
+			values.clear();
+			allocator.Clear();
+			if (!keepGoing)
+				finished = true;
+			return keepGoing;
+		}
+
+		const Ch* array_name;
+		size_t array_name_length;
+		Visitor& visitor;
+
+		std::unique_ptr<char[]> scratch;
+		rapidjson::MemoryPoolAllocator<> allocator;	// Over `scratch`, so declared after it
+		std::vector<rapidjson::Value> values;		// Values (and member names) of the element being built
+		std::vector<size_t> containers;				// Start of each open container in `values`
+
+		size_t depth = 0;
+		size_t element_depth = 0;					// 0 until the target array is found
+		bool pending_array = false;					// The last key was the array name
+		bool array_found = false;
+		bool finished = false;
+	};
+
+	// Streams the elements of an array from any RapidJSON input stream. Returns false on parse
+	// errors, or if there is no such array.
+	template<unsigned parseFlags = rapidjson::kParseDefaultFlags, typename InputStream, typename Visitor>
+	inline bool ParseStreamArray(InputStream& stream, const char* array_name, Visitor&& visitor)
+	{
+		ArrayElementHandler<std::remove_reference_t<Visitor>> handler(array_name, visitor);
+		rapidjson::Reader reader;
+		const rapidjson::ParseResult result = reader.Parse<parseFlags>(stream, handler);
+		if (handler.IsFinished())
+			return true;
+
+		return !result.IsError() && handler.IsArrayFound();
+	}
+
+	template<typename Visitor>
+	inline bool ParseFileArray(const char* file_name, const char* array_name, Visitor&& visitor)
+	{
+		ScopedParseTimer timer;
+
+		FILE* fp = OpenFile(file_name, "rb");
+		assert(fp);
+		if (!fp)
+			return false;
+
+		constexpr int BUFFER_SIZE = 65536;
+		char* readBuffer = static_cast<char*>(malloc(BUFFER_SIZE));
+		if (!readBuffer)
+		{
+			fclose(fp);
+			return false;
+		}
+
+		rapidjson::FileReadStream is(fp, readBuffer, BUFFER_SIZE);
+		const bool parsed = ParseStreamArray(is, array_name, std::forward<Visitor>(visitor));
+		timer.SetBytes(is.Tell());
+		fclose(fp);
+		free(readBuffer);
+
+		return parsed;
+	}
+
+	//
+	// JSON pointers
+	//
+	// Reference token of a JSON pointer (RFC 6901), unescaped. Tokens that look like array
+	// indices (digits without leading zeros) also keep their numeric value, since whether they
+	// name a member or an element depends on the document.
+	//
+
+	struct PointerToken
+	{
+		static constexpr uint32_t NO_INDEX = 0xFFFFFFFF;
+
+		std::string name;
+		uint32_t index = NO_INDEX;
+	};
+
+	// Splits e.g. "/scene/nodes/3" into its tokens; "" is the whole document. False if malformed.
+	inline bool ParseJsonPointer(const char* pointer, std::vector<PointerToken>& out_tokens)
+	{
+		out_tokens.clear();
+		const size_t length = strlen(pointer);
+		if (length != 0 && pointer[0] != '/')
+			return false;
+
+		for (size_t i = 0; i < length; ++i)
+		{
+			if (pointer[i] == '/')
+			{
+				out_tokens.emplace_back();
+				continue;
+			}
+
+			char c = pointer[i];
+			if (c == '~')
+			{
+				const char escaped = i + 1 < length ? pointer[++i] : '\0';
+				if (escaped != '0' && escaped != '1')
+					return false;
+				c = escaped == '0' ? '~' : '/';
+			}
+			out_tokens.back().name.push_back(c);
+		}
+
+		for (PointerToken& token : out_tokens)
+		{
+			const std::string& name = token.name;
+			if (name.empty() || name.size() > 9 || (name.size() > 1 && name[0] == '0'))
+				continue;
+			uint32_t index = 0;
+			bool isIndex = true;
+			for (const char c : name)
+			{
+				isIndex &= (c >= '0' && c <= '9');
+				index = index * 10 + static_cast<uint32_t>(c - '0');
+			}
+			if (isIndex)
+				token.index = index;
+		}
+		return true;
+	}
+
+	//
+	// Selective parsing
+	//
+	// Parses a document keeping only the subtrees named by a few JSON pointers (RFC 6901, e.g.
+	// "/header/version" or "/assets/0"), and skips everything else with a plain SAX scan that
+	// builds nothing. The requested values are placed at the same paths in `out_document`, so
+	// Extract<>(), IsValid<>() and friends work on it unchanged:
+	//
+	//     rapidjson::Document document;
+	//     if (rjutils::ParseFileSelective("level.json", { "/header/version", "/assets" }, document))
+	//         version = rjutils::Extract<int64_t>(document["header"], "version", 0);
+	//
+	// Parsing stops as soon as every requested value was read, so the rest of the file isn't even
+	// validated. Paths that don't exist are simply missing from the result. Array elements keep
+	// their index: the earlier elements of the array are filled with nulls.
+	//
+
+	class SelectiveHandler : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, SelectiveHandler>
+	{
+	public:
+		typedef char Ch;
+
+		SelectiveHandler(rapidjson::Document& out_document_)
+			: out_document(out_document_)
+			, allocator(out_document_.GetAllocator())
+		{
+		}
+
+		// False if `pointer` is malformed
+		bool AddPointer(const char* pointer)
+		{
+			Request request;
+			if (!ParseJsonPointer(pointer, request.tokens))
+				return false;
+
+			requests.push_back(std::move(request));
+			++remaining;
+			return true;
+		}
+
+		// True once every requested value was read
+		bool IsFinished() const { return remaining == 0; }
+
+		bool Null() { return AddScalar(rapidjson::Value()); }
+		bool Bool(bool b) { return AddScalar(rapidjson::Value(b)); }
+		bool Int(int i) { return AddScalar(rapidjson::Value(i)); }
+		bool Uint(unsigned u) { return AddScalar(rapidjson::Value(u)); }
+		bool Int64(int64_t i) { return AddScalar(rapidjson::Value(i)); }
+		bool Uint64(uint64_t u) { return AddScalar(rapidjson::Value(u)); }
+		bool Double(double d) { return AddScalar(rapidjson::Value(d)); }
+
+		bool String(const Ch* str, rapidjson::SizeType length, bool copy)
+		{
+			if (InCapture())
+			{
+				values.push_back(MakeString(str, length, copy));
+				return true;
+			}
+			if (!BeginValue())
+				return true;
+			return AddValue(MakeString(str, length, copy));
+		}
+
+		bool Key(const Ch* str, rapidjson::SizeType length, bool copy)
+		{
+			if (InCapture())
+			{
+				values.push_back(MakeString(str, length, copy));
+				return true;
+			}
+
+			SetToken([&](const Token& token) { return token.name.size() == length && memcmp(token.name.data(), str, length) == 0; });
+			return true;
+		}
+
+		bool StartObject()
+		{
+			if (InCapture() || BeginValue())
+			{
+				containers.push_back(values.size());
+				return true;
+			}
+			frames.push_back(Frame{ false, 0 });
+			return true;
+		}
+
+		bool EndObject(rapidjson::SizeType member_count)
+		{
+			if (!InCapture())
+				return EndFrame();
+
+			const size_t start = containers.back();
+			containers.pop_back();
+
+			rapidjson::Value object(rapidjson::kObjectType);
+			for (size_t i = 0; i < member_count; ++i)
+				object.AddMember(values[start + 2 * i], values[start + 2 * i + 1], allocator);
+			values.resize(start);
+			return AddValue(std::move(object));
+		}
+
+		bool StartArray()
+		{
+			if (InCapture() || BeginValue())
+			{
+				containers.push_back(values.size());
+				return true;
+			}
+			frames.push_back(Frame{ true, 0 });
+			return true;
+		}
+
+		bool EndArray(rapidjson::SizeType element_count)
+		{
+			if (!InCapture())
+				return EndFrame();
+
+			const size_t start = containers.back();
+			containers.pop_back();
+
+			rapidjson::Value array(rapidjson::kArrayType);
+			array.Reserve(element_count, allocator);
+			for (size_t i = 0; i < element_count; ++i)
+				array.PushBack(values[start + i], allocator);
+			values.resize(start);
+			return AddValue(std::move(array));
+		}
+
+	private:
+		typedef PointerToken Token;
+
+		struct Request
+		{
+			std::vector<Token> tokens;
+			size_t matched = 0;			// Leading tokens matched by the current path
+			bool done = false;
+		};
+
+		// An open object or array outside of the captured values
+		struct Frame
+		{
+			bool is_array;
+			uint32_t next_index;
+		};
+
+		bool InCapture() const { return !containers.empty(); }
+
+		// The current path moved on to a new member / element at the innermost frame
+		template<typename Matches>
+		void SetToken(Matches&& matches)
+		{
+			const size_t depth = frames.size();
+			for (Request& request : requests)
+			{
+				if (!request.done && request.matched + 1 >= depth)
+					request.matched = (request.tokens.size() >= depth && matches(request.tokens[depth - 1])) ? depth : depth - 1;
+			}
+		}
+
+		// Called before every value outside of a capture; true if it starts a requested one
+		bool BeginValue()
+		{
+			if (!frames.empty() && frames.back().is_array)
+			{
+				const uint32_t index = frames.back().next_index++;
+				SetToken([&](const Token& token) { return token.index == index; });
+			}
+
+			const size_t depth = frames.size();
+			for (size_t i = 0; i < requests.size(); ++i)
+			{
+				if (!requests[i].done && requests[i].matched == depth && requests[i].tokens.size() == depth)
+				{
+					capture = i;
+					return true;
+				}
+			}
+			return false;
+		}
+
+		bool EndFrame()
+		{
+			frames.pop_back();
+			for (Request& request : requests)
+			{
+				if (request.matched > frames.size())
+					request.matched = frames.size();
+			}
+			return true;
+		}
+
+		rapidjson::Value MakeString(const Ch* str, rapidjson::SizeType length, bool copy)
+		{
+			if (copy)
+				return rapidjson::Value(str, length, allocator);
+			return rapidjson::Value(rapidjson::StringRef(str, length));
+		}
+
+		bool AddScalar(rapidjson::Value&& value)
+		{
+			if (InCapture())
+			{
+				values.push_back(std::move(value));
+				return true;
+			}
+			if (!BeginValue())
+				return true;
+			return AddValue(std::move(value));
+		}
+
+		// Adds a completed value: to its parent while capturing, or to the document
+		bool AddValue(rapidjson::Value&& value)
+		{
+			if (InCapture())
+			{
+				values.push_back(std::move(value));
+				return true;
+			}
+
+			// The captured value's path is the request's, with the frames telling arrays apart
+			const std::vector<Token>& tokens = requests[capture].tokens;
+			rapidjson::Value* node = &out_document;
+			for (size_t i = 0; i < tokens.size(); ++i)
+			{
+				if (frames[i].is_array)
+				{
+					if (!node->IsArray())
+						node->SetArray();
+					while (node->Size() <= tokens[i].index)
+						node->PushBack(rapidjson::Value(), allocator);
+					node = &(*node)[tokens[i].index];
+				}
+				else
+				{
+					if (!node->IsObject())
+						node->SetObject();
+					const rapidjson::Value name(rapidjson::StringRef(tokens[i].name.data(), static_cast<rapidjson::SizeType>(tokens[i].name.size())));
+					rapidjson::Value::MemberIterator member = node->FindMember(name);
+					if (member == node->MemberEnd())
+					{
+						node->AddMember(rapidjson::Value(tokens[i].name.data(), static_cast<rapidjson::SizeType>(tokens[i].name.size()), allocator), rapidjson::Value(), allocator);
+						member = node->MemberEnd() - 1;
+					}
+					node = &member->value;
+				}
+			}
+			*node = std::move(value);
+
+			// This request, and any requested path inside of it, is done
+			for (Request& request : requests)
+			{
+				if (!request.done && request.tokens.size() >= tokens.size()
+					&& std::equal(tokens.begin(), tokens.end(), request.tokens.begin(), [](const Token& a, const Token& b) { return a.name == b.name; }))
+				{
+					request.done = true;
+					--remaining;
+				}
+			}
+
+			// Returning false stops the parser
+			return remaining != 0;
+		}
+
+		rapidjson::Document& out_document;
+		rapidjson::Document::AllocatorType& allocator;
+
+		std::vector<Request> requests;
+		size_t remaining = 0;
+		size_t capture = 0;							// Request being materialized
+		std::vector<Frame> frames;					// Path of the current value, outside of captures
+		std::vector<rapidjson::Value> values;		// Values (and member names) of the capture being built
+		std::vector<size_t> containers;				// Start of each open container in `values`
+	};
+
+	// Parses `pointer_count` JSON pointers' worth of any RapidJSON input stream into
+	// `out_document`. Returns false on malformed pointers or parse errors before every requested
+	// value was read.
+	template<unsigned parseFlags = rapidjson::kParseDefaultFlags, typename InputStream>
+	inline bool ParseStreamSelective(InputStream& stream, const char* const* pointers, size_t pointer_count, rapidjson::Document& out_document)
+	{
+		out_document.SetObject();
+
+		SelectiveHandler handler(out_document);
+		for (size_t i = 0; i < pointer_count; ++i)
+		{
+			const bool valid = handler.AddPointer(pointers[i]);
+			assert(valid && "rjutils::ParseStreamSelective(): malformed JSON pointer");
+			if (!valid)
+				return false;
+		}
+		if (handler.IsFinished())
+			return true;
+
+		rapidjson::Reader reader;
+		const rapidjson::ParseResult result = reader.Parse<parseFlags>(stream, handler);
+		return handler.IsFinished() || !result.IsError();
+	}
+
+	inline bool ParseFileSelective(const char* file_name, const char* const* pointers, size_t pointer_count, rapidjson::Document& out_document)
+	{
+		ScopedParseTimer timer;
+
+		FILE* fp = OpenFile(file_name, "rb");
+		assert(fp);
+		if (!fp)
+			return false;
+
+		constexpr int BUFFER_SIZE = 65536;
+		char* readBuffer = static_cast<char*>(malloc(BUFFER_SIZE));
+		if (!readBuffer)
+		{
+			fclose(fp);
+			return false;
+		}
+
+		rapidjson::FileReadStream is(fp, readBuffer, BUFFER_SIZE);
+		const bool parsed = ParseStreamSelective(is, pointers, pointer_count, out_document);
+		timer.SetBytes(is.Tell());
+		fclose(fp);
+		free(readBuffer);
+
+		return parsed;
+	}
+
+	inline bool ParseFileSelective(const char* file_name, std::initializer_list<const char*> pointers, rapidjson::Document& out_document)
+	{
+		return ParseFileSelective(file_name, pointers.begin(), pointers.size(), out_document);
+	}
+
+	//
+	// Member lookup
+	//
+	// Every member-level function below does exactly one FindMember scan through these and then
+	// works on the returned value. The GenericStringRef / Value overloads reuse the key length
+	// instead of recomputing it with strlen() on every call, so prebuilt keys are cheaper when
+	// the same member is looked up many times:
+	//
+	//     static const rapidjson::Value kDistance("distance");    // or rapidjson::StringRef("distance")
+	//     for (const auto& item : document["items"].GetArray())
+	//         total += rjutils::Extract<uint64_t>(item, kDistance, 0);
+	//
+
+	// Returns the value of `member` inside `target_element`, or nullptr if there is no such member
+	template<typename Ch = char, typename RapidJsonTarget>
+	inline const rapidjson::Value* FindMemberValue(const RapidJsonTarget& target_element, const Ch* member)
+	{
+		static_assert (std::is_base_of<rapidjson::Value, RapidJsonTarget>::value, "rjutils only supports rapidjson::Value and Documents derived from it as the target element");
+		const auto it = target_element.FindMember(member);
+		const rapidjson::Value* value = it != target_element.MemberEnd() ? &it->value : nullptr;
+		if constexpr (INSTRUMENTATION_ENABLED)
+			InstrumentLookup(InstrumentationKey(member), value != nullptr);
+		return value;
+	}
+
+	template<typename Ch = char, typename RapidJsonTarget>
+	inline const rapidjson::Value* FindMemberValue(const RapidJsonTarget& target_element, const rapidjson::GenericStringRef<Ch>& member)
+	{
+		static_assert (std::is_base_of<rapidjson::Value, RapidJsonTarget>::value, "rjutils only supports rapidjson::Value and Documents derived from it as the target element");
+
+		// A constant string Value only wraps the pointer and keeps the length - nothing is copied
+		const rapidjson::Value key(member);
+		const auto it = target_element.FindMember(key);
+		const rapidjson::Value* value = it != target_element.MemberEnd() ? &it->value : nullptr;
+		if constexpr (INSTRUMENTATION_ENABLED)
+			InstrumentLookup(InstrumentationKey(member), value != nullptr);
+		return value;
+	}
+
+	template<typename RapidJsonTarget>
+	inline const rapidjson::Value* FindMemberValue(const RapidJsonTarget& target_element, const rapidjson::Value& member)
+	{
+		static_assert (std::is_base_of<rapidjson::Value, RapidJsonTarget>::value, "rjutils only supports rapidjson::Value and Documents derived from it as the target element");
+		assert(member.IsString());
+		const auto it = target_element.FindMember(member);
+		const rapidjson::Value* value = it != target_element.MemberEnd() ? &it->value : nullptr;
+		if constexpr (INSTRUMENTATION_ENABLED)
+			InstrumentLookup(InstrumentationKey(member), value != nullptr);
+		return value;
+	}
+
+	// Opt-in hashed index over the members of an object, for wide objects that get queried many
+	// times. Build it once and pass it to any member-level function in place of the Value:
+	//
+	//     const rjutils::IndexedObject settings(document["settings"]);
+	//     const int64_t width = rjutils::Extract<int64_t>(settings, "width", 0);
+	//
+	// The table is open-addressing with linear probing; each slot is just the key hash next to the
+	// member index (8 bytes), so a probe sequence usually stays inside one cache line and the key
+	// is only compared once the hash matches. Objects up to LINEAR_SCAN_MAX_MEMBERS members skip
+	// the table entirely, since scanning a handful of keys is faster than hashing.
+	//
+	// Lookups match FindMember(): with duplicated keys, the first one wins. The index points into
+	// the object, so it is invalidated by anything that adds, removes or moves its members.
+	class IndexedObject
+	{
+	public:
+		static constexpr rapidjson::SizeType LINEAR_SCAN_MAX_MEMBERS = 12;
+
+		explicit IndexedObject(const rapidjson::Value& object_value)
+			: object(&object_value)
+		{
+			assert(object_value.IsObject());
+			const rapidjson::SizeType memberCount = object_value.MemberCount();
+			if (memberCount <= LINEAR_SCAN_MAX_MEMBERS)
+				return;
+
+			// Keep the load factor at or below 50%
+			size_t capacity = 1;
+			while (capacity < static_cast<size_t>(memberCount) * 2)
+				capacity <<= 1;
+
+			slots.assign(capacity, Slot{ 0, EMPTY_SLOT });
+			mask = static_cast<uint32_t>(capacity - 1);
+
+			const auto members = object_value.MemberBegin();
+			for (rapidjson::SizeType i = 0; i < memberCount; ++i)
+			{
+				const rapidjson::Value& name = members[i].name;
+				const uint32_t hash = HashKey(name.GetString(), name.GetStringLength());
+				uint32_t slot = hash & mask;
+				bool duplicate = false;
+				while (slots[slot].member_index != EMPTY_SLOT)
+				{
+					if (slots[slot].hash == hash && KeyEquals(members[slots[slot].member_index].name, name.GetString(), name.GetStringLength()))
+					{
+						duplicate = true;
+						break;
+					}
+					slot = (slot + 1) & mask;
+				}
+
+				if (!duplicate)
+					slots[slot] = Slot{ hash, i };
+			}
+		}
+
+		const rapidjson::Value& GetValue() const { return *object; }
+
+		// False when the object is small enough to be scanned linearly
+		bool IsHashed() const { return !slots.empty(); }
+
+		// Returns the value of the member named `key`, or nullptr if there is no such member
+		const rapidjson::Value* Find(const char* key, size_t length) const
+		{
+			const auto members = object->MemberBegin();
+			if (slots.empty())
+			{
+				const rapidjson::SizeType memberCount = object->MemberCount();
+				for (rapidjson::SizeType i = 0; i < memberCount; ++i)
+					if (KeyEquals(members[i].name, key, length))
+						return &members[i].value;
+				return nullptr;
+			}
+
+			const uint32_t hash = HashKey(key, length);
+			for (uint32_t slot = hash & mask; slots[slot].member_index != EMPTY_SLOT; slot = (slot + 1) & mask)
+			{
+				if (slots[slot].hash == hash && KeyEquals(members[slots[slot].member_index].name, key, length))
+					return &members[slots[slot].member_index].value;
+			}
+			return nullptr;
+		}
+
+	private:
+		static constexpr uint32_t EMPTY_SLOT = UINT32_MAX;
+
+		struct Slot
+		{
+			uint32_t hash;
+			uint32_t member_index;
+		};
+
+		static bool KeyEquals(const rapidjson::Value& name, const char* key, size_t length)
+		{
+			return name.GetStringLength() == length && memcmp(name.GetString(), key, length) == 0;
+		}
+
+		// Word-at-a-time multiply / xor-shift hash; keys are short, so this is mostly the final mix
+		static uint32_t HashKey(const char* key, size_t length)
+		{
+			constexpr uint64_t MULTIPLIER = 0xBF58476D1CE4E5B9ull;
+			uint64_t hash = 0x9E3779B97F4A7C15ull ^ length;
+			for (; length >= 8; key += 8, length -= 8)
+			{
+				uint64_t chunk;
+				memcpy(&chunk, key, 8);
+				hash = (hash ^ chunk) * MULTIPLIER;
+				hash ^= hash >> 31;
+			}
+			if (length > 0)
+			{
+				uint64_t chunk = 0;
+				memcpy(&chunk, key, length);
+				hash = (hash ^ chunk) * MULTIPLIER;
+				hash ^= hash >> 31;
+			}
+			hash *= 0x94D049BB133111EBull;
+			hash ^= hash >> 32;
+			return static_cast<uint32_t>(hash);
+		}
+
+		const rapidjson::Value* object;
+		std::vector<Slot> slots;
+		uint32_t mask = 0;
+	};
+
+	template<typename Ch = char>
+	inline const rapidjson::Value* FindMemberValue(const IndexedObject& target_element, const Ch* member)
+	{
+		const rapidjson::Value* value = target_element.Find(member, strlen(member));
+		if constexpr (INSTRUMENTATION_ENABLED)
+			InstrumentLookup(InstrumentationKey(member), value != nullptr);
+		return value;
+	}
+
+	template<typename Ch = char>
+	inline const rapidjson::Value* FindMemberValue(const IndexedObject& target_element, const rapidjson::GenericStringRef<Ch>& member)
+	{
+		const rapidjson::Value* value = target_element.Find(member.s, member.length);
+		if constexpr (INSTRUMENTATION_ENABLED)
+			InstrumentLookup(InstrumentationKey(member), value != nullptr);
+		return value;
+	}
+
+	inline const rapidjson::Value* FindMemberValue(const IndexedObject& target_element, const rapidjson::Value& member)
+	{
+		assert(member.IsString());
+		const rapidjson::Value* value = target_element.Find(member.GetString(), member.GetStringLength());
+		if constexpr (INSTRUMENTATION_ENABLED)
+			InstrumentLookup(InstrumentationKey(member), value != nullptr);
+		return value;
+	}
+
+	//
+	// Value-level checks and extraction
+	//
+	// These work on a value that was already looked up (member values, array elements...) and
+	// are what the member-level functions are built on.
+	//
+
+	template<typename DataType>
+	inline bool IsValidValue(const rapidjson::Value& value)
+	{
+		if constexpr (std::is_same<DataType, int32_t>::value)
+			return value.IsInt();
+		else if constexpr (std::is_same<DataType, uint32_t>::value)
+			return value.IsUint();
+		else if constexpr (std::is_same<DataType, int64_t>::value)
+			return value.IsInt64();
+		else if constexpr (std::is_same<DataType, uint64_t>::value)
+			return value.IsUint64();
+		else if constexpr (std::is_same<DataType, bool>::value)
+			return value.IsBool();
+		else if constexpr (std::is_floating_point<DataType>::value)
+			return value.IsDouble();
+		else if constexpr (std::is_same<DataType, char>::value
+			|| std::is_same<DataType, const char>::value
+			|| std::is_same<DataType, char*>::value
+			|| std::is_same<DataType, const char*>::value
+			|| std::is_same<DataType, std::string>::value
+			|| std::is_same<DataType, const std::string>::value
+			|| std::is_same<DataType, std::string_view>::value
+			|| std::is_same<DataType, const std::string_view>::value)
+			return value.IsString();
+		else if constexpr (std::is_integral<DataType>::value && std::is_signed<DataType>::value)
+			return value.IsInt64();
+		else if constexpr (std::is_integral<DataType>::value && std::is_unsigned<DataType>::value)
+			return value.IsUint64();
+		else
+			static_assert(dependent_false<DataType>::value, "Attempting to invoke rjutil::IsValid<>() with invalid data type");
+
+		return false;
+	}
+
+	// The value as DataType, for a value IsValidValue<DataType>() accepted
+	template<typename DataType>
+	inline DataType GetValidValue(const rapidjson::Value& value)
+	{
+		assert(IsValidValue<DataType>(value));
+		if constexpr (std::is_same<DataType, int32_t>::value)
+			return value.GetInt();
+		else if constexpr (std::is_same<DataType, uint32_t>::value)
+			return value.GetUint();
+		else if constexpr (std::is_same<DataType, int64_t>::value)
+			return value.GetInt64();
+		else if constexpr (std::is_same<DataType, uint64_t>::value)
+			return value.GetUint64();
+		else if constexpr (std::is_same<DataType, bool>::value)
+			return value.GetBool();
+		else if constexpr (std::is_floating_point<DataType>::value)
+			return static_cast<DataType>(value.GetDouble());
+		else if constexpr (std::is_same<DataType, char>::value
+			|| std::is_same<DataType, const char>::value
+			|| std::is_same<DataType, char*>::value
+			|| std::is_same<DataType, const char*>::value)
+			return value.GetString();
+		else if constexpr (std::is_same<DataType, std::string>::value
+			|| std::is_same<DataType, const std::string>::value
+			|| std::is_same<DataType, std::string_view>::value
+			|| std::is_same<DataType, const std::string_view>::value)
+			// The length is already known, no need to scan for the terminator. A string_view points
+			// into the Document (or the in-situ buffer) and allocates nothing.
+			return DataType(value.GetString(), value.GetStringLength());
+		else if constexpr (std::is_integral<DataType>::value && std::is_signed<DataType>::value)
+			return static_cast<DataType>(value.GetInt64());
+		else if constexpr (std::is_integral<DataType>::value && std::is_unsigned<DataType>::value)
+			return static_cast<DataType>(value.GetUint64());
+		else
+			static_assert(dependent_false<DataType>::value, "Attempting to invoke rjutil::Extract<>() with invalid data type");
+	}
+
+	template<typename DataType>
+	inline DataType ExtractValue(const rapidjson::Value& value, DataType default_value)
+	{
+		if (IsValidValue<DataType>(value))
+			return GetValidValue<DataType>(value);
+
+		if constexpr (std::is_same<DataType, int32_t>::value)
+		{
+			// If you hit this assert, there's a good chance you're not specializing the function
+			// call (e.g. `Extract<int32_t>`) and the compiler is relying in detecting the type of
+			// DataType parameter. If you're specializing it, you probably selected the wrong type
+			// for the specialization.
+			assert(!value.IsNumber());
+		}
+
+		return default_value;
+	}
+
+	//
+	// Locale-free number parsing
+	//
+	// Parses the whole of [str, str + length) as a base 10 number, without relying on a null
+	// terminator, the current locale or errno. Returns std::errc() on success,
+	// std::errc::invalid_argument when the text isn't a number (or has trailing characters) and
+	// std::errc::result_out_of_range when it doesn't fit in DataType; `out_value` is only written
+	// on success. A leading '+' is accepted, as strtol()/strtod() did.
+	//
+	// Integers of up to 19 digits are parsed 8 digits at a time (SWAR) on little-endian targets;
+	// everything else goes through std::from_chars, which standard libraries implement with
+	// Eisel-Lemire / fast_float style algorithms for floating point.
+	//
+
+	// True if the 8 bytes packed (little-endian) in `chunk` are all ASCII digits
+	constexpr bool IsEightDigits(uint64_t chunk)
+	{
+		return (((chunk + 0x4646464646464646ULL) | (chunk - 0x3030303030303030ULL)) & 0x8080808080808080ULL) == 0;
+	}
+
+	// Converts 8 ASCII digits packed (little-endian, so the first digit in the low byte) to their value
+	constexpr uint32_t ParseEightDigits(uint64_t chunk)
+	{
+		chunk -= 0x3030303030303030ULL;
+		chunk = (chunk * 10) + (chunk >> 8);
+		chunk = (((chunk & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32)))
+			+ (((chunk >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32)))) >> 32;
+		return static_cast<uint32_t>(chunk);
+	}
+
+	// Parses 1 to 19 digits (which always fit in 64 bits); false if any character isn't a digit
+	inline bool ParseDigits(const char* first, const char* last, uint64_t& out_value)
+	{
+		uint64_t result = 0;
+	#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__ || defined(_M_X64) || defined(_M_IX86) || defined(_M_ARM64)
+		while (last - first >= 8)
+		{
+			uint64_t chunk;
+			memcpy(&chunk, first, sizeof(chunk));
+			if (!IsEightDigits(chunk))
+				return false;
+			result = result * 100000000 + ParseEightDigits(chunk);
+			first += 8;
+		}
+	#endif
+		for (; first != last; ++first)
+		{
+			const unsigned int digit = static_cast<unsigned char>(*first) - '0';
+			if (digit > 9)
+				return false;
+			result = result * 10 + digit;
+		}
+		out_value = result;
+		return true;
+	}
+
+	template<typename DataType>
+	inline std::errc ParseNumber(const char* str, size_t length, DataType& out_value)
+	{
+		const char* first = str;
+		const char* last = str + length;
+		if (first != last && *first == '+')
+		{
+			// Only one sign: from_chars and the digit parser below would take "+-5" as -5
+			++first;
+			if (first != last && *first == '-')
+				return std::errc::invalid_argument;
+		}
+
+		if constexpr (std::is_integral<DataType>::value)
+		{
+			static_assert(!std::is_same<DataType, bool>::value, "rjutils::ParseNumber<>() doesn't parse booleans");
+
+			const bool negative = std::is_signed<DataType>::value && first != last && *first == '-';
+			const char* digits = negative ? first + 1 : first;
+			uint64_t magnitude = 0;
+			if (digits != last && last - digits <= 19 && ParseDigits(digits, last, magnitude))
+			{
+				typedef typename std::make_unsigned<DataType>::type UnsignedType;
+				const uint64_t limit = static_cast<uint64_t>(std::numeric_limits<DataType>::max()) + (negative ? 1 : 0);
+				if (magnitude > limit)
+					return std::errc::result_out_of_range;
+
+				out_value = static_cast<DataType>(negative ? static_cast<UnsignedType>(0 - static_cast<UnsignedType>(magnitude)) : static_cast<UnsignedType>(magnitude));
+				return std::errc();
+			}
+		}
+
+	#if !defined(__cpp_lib_to_chars)
+		if constexpr (std::is_floating_point<DataType>::value)
+		{
+			// No floating point from_chars in this standard library: strtod() needs a terminated
+			// copy, and errno must be cleared first, since it's only ever set on errors
+			const std::string terminated(first, last);
+			char* end = nullptr;
+			errno = 0;
+			DataType result;
+			if constexpr (std::is_same<DataType, float>::value)
+				result = strtof(terminated.c_str(), &end);
+			else if constexpr (std::is_same<DataType, double>::value)
+				result = strtod(terminated.c_str(), &end);
+			else
+				result = strtold(terminated.c_str(), &end);
+			// strtod() also takes leading whitespace and hexadecimal, which from_chars() doesn't
+			if (terminated.empty() || end != terminated.c_str() + terminated.size() || terminated.find_first_of(" \t\n\v\f\rxX") != std::string::npos)
+				return std::errc::invalid_argument;
+			if (errno == ERANGE)
+				return std::errc::result_out_of_range;
+			out_value = result;
+			return std::errc();
+		}
+		else
+	#endif
+		{
+			DataType result;
+			// Trailing text first: "99999px" isn't a number, whether or not 99999 fits
+			const std::from_chars_result parsed = std::from_chars(first, last, result);
+			if (parsed.ptr != last)
+				return std::errc::invalid_argument;
+			if (parsed.ec != std::errc())
+				return parsed.ec;
+			out_value = result;
+			return std::errc();
+		}
+	}
+
+	template<typename DataType>
+	inline DataType ExtractValueFromNumericOrString(const rapidjson::Value& value, DataType default_value)
+	{
+		if (value.IsNumber())
+			return ExtractValue<DataType>(value, default_value);
+
+		if constexpr (std::is_same<DataType, std::string_view>::value || std::is_same<DataType, const std::string_view>::value)
+		{
+			if (value.IsString())
+				return DataType(value.GetString(), value.GetStringLength());
+		}
+		else if constexpr ((std::is_integral<DataType>::value && !std::is_same<DataType, bool>::value && !std::is_same<DataType, char>::value)
+			|| std::is_floating_point<DataType>::value)
+		{
+			if (value.IsString())
+			{
+				DataType result;
+				const std::errc error = ParseNumber<DataType>(value.GetString(), value.GetStringLength(), result);
+				if constexpr (INSTRUMENTATION_ENABLED)
+					InstrumentNumericString(error == std::errc());
+
+				// If you hit this assert, there's a good chance you're not specializing the function
+				// call (e.g. `ExtractFromNumericOrString<int32_t>`) and the compiler is relying in
+				// detecting the type of DataType parameter. If you're specializing it, you probably
+				// selected the wrong type for the specialization.
+				//
+				// Please notice: If you ARE specializing it and still getting this error, use a
+				// larger variable type (e.g. int64_t). You're getting results out of the type bounds.
+				assert(error != std::errc::result_out_of_range);
+
+				if (error != std::errc())
+					return default_value;
+
+				return result;
+			}
+		}
+
+		return default_value;
+	}
+
+	//
+	// Member-level checks and extraction
+	//
+	// `target_element` can be a `rapidjson::Document`, a `rapidjson::Value` or an `IndexedObject`,
+	// and `member` a `const Ch*`, a `rapidjson::GenericStringRef` or a string `rapidjson::Value`.
+	//
+
+	template<typename DataType, typename Ch = char, typename RapidJsonTarget>
+	inline bool IsValid(const RapidJsonTarget& target_element, const Ch* member)
+	{
+		const rapidjson::Value* value = FindMemberValue(target_element, member);
+		return value && IsValidValue<DataType>(*value);
+	}
+
+	template<typename DataType, typename Ch = char, typename RapidJsonTarget>
+	inline bool IsValid(const RapidJsonTarget& target_element, const rapidjson::GenericStringRef<Ch>& member)
+	{
+		const rapidjson::Value* value = FindMemberValue(target_element, member);
+		return value && IsValidValue<DataType>(*value);
+	}
+
+	template<typename DataType, typename RapidJsonTarget>
+	inline bool IsValid(const RapidJsonTarget& target_element, const rapidjson::Value& member)
+	{
+		const rapidjson::Value* value = FindMemberValue(target_element, member);
+		return value && IsValidValue<DataType>(*value);
+	}
+
+	template<typename Ch = char, typename RapidJsonTarget>
+	inline bool IsValidArray(const RapidJsonTarget& target_element, const Ch* member)
+	{
+		const rapidjson::Value* value = FindMemberValue(target_element, member);
+		return value && value->IsArray();
+	}
+
+	template<typename Ch = char, typename RapidJsonTarget>
+	inline bool IsValidArray(const RapidJsonTarget& target_element, const rapidjson::GenericStringRef<Ch>& member)
+	{
+		const rapidjson::Value* value = FindMemberValue(target_element, member);
+		return value && value->IsArray();
+	}
+
+	template<typename RapidJsonTarget>
+	inline bool IsValidArray(const RapidJsonTarget& target_element, const rapidjson::Value& member)
+	{
+		const rapidjson::Value* value = FindMemberValue(target_element, member);
+		return value && value->IsArray();
+	}
+
+	template<typename Ch = char, typename RapidJsonTarget>
+	inline bool IsValidObject(const RapidJsonTarget& target_element, const Ch* member)
+	{
+		const rapidjson::Value* value = FindMemberValue(target_element, member);
+		return value && value->IsObject();
+	}
+
+	template<typename Ch = char, typename RapidJsonTarget>
+	inline bool IsValidObject(const RapidJsonTarget& target_element, const rapidjson::GenericStringRef<Ch>& member)
+	{
+		const rapidjson::Value* value = FindMemberValue(target_element, member);
+		return value && value->IsObject();
+	}
+
+	template<typename RapidJsonTarget>
+	inline bool IsValidObject(const RapidJsonTarget& target_element, const rapidjson::Value& member)
+	{
+		const rapidjson::Value* value = FindMemberValue(target_element, member);
+		return value && value->IsObject();
+	}
+
+	template<typename DataType, typename Ch = char, typename RapidJsonTarget>
+	inline DataType Extract(const RapidJsonTarget& target_element, const Ch* member, DataType default_value)
+	{
+		const rapidjson::Value* value = FindMemberValue(target_element, member);
+		if constexpr (INSTRUMENTATION_ENABLED)
+		{
+			if (value && !IsValidValue<DataType>(*value))
+				InstrumentTypeMismatch(InstrumentationKey(member));
+		}
+		return value ? ExtractValue<DataType>(*value, default_value) : default_value;
+	}
+
+	template<typename DataType, typename Ch = char, typename RapidJsonTarget>
+	inline DataType Extract(const RapidJsonTarget& target_element, const rapidjson::GenericStringRef<Ch>& member, DataType default_value)
+	{
+		const rapidjson::Value* value = FindMemberValue(target_element, member);
+		if constexpr (INSTRUMENTATION_ENABLED)
+		{
+			if (value && !IsValidValue<DataType>(*value))
+				InstrumentTypeMismatch(InstrumentationKey(member));
+		}
+		return value ? ExtractValue<DataType>(*value, default_value) : default_value;
+	}
+
+	template<typename DataType, typename RapidJsonTarget>
+	inline DataType Extract(const RapidJsonTarget& target_element, const rapidjson::Value& member, DataType default_value)
+	{
+		const rapidjson::Value* value = FindMemberValue(target_element, member);
+		if constexpr (INSTRUMENTATION_ENABLED)
+		{
+			if (value && !IsValidValue<DataType>(*value))
+				InstrumentTypeMismatch(InstrumentationKey(member));
+		}
+		return value ? ExtractValue<DataType>(*value, default_value) : default_value;
+	}
+
+	template<typename DataType, typename Ch = char, typename RapidJsonTarget>
+	inline DataType ExtractFromNumericOrString(const RapidJsonTarget& target_element, const Ch* member, DataType default_value)
+	{
+		const rapidjson::Value* value = FindMemberValue(target_element, member);
+		if constexpr (INSTRUMENTATION_ENABLED)
+		{
+			if (value && value->IsString())
+				InstrumentNumericStringKey(InstrumentationKey(member));
+			else if (value && !IsValidValue<DataType>(*value))
+				InstrumentTypeMismatch(InstrumentationKey(member));
+		}
+		return value ? ExtractValueFromNumericOrString<DataType>(*value, default_value) : default_value;
+	}
+
+	template<typename DataType, typename Ch = char, typename RapidJsonTarget>
+	inline DataType ExtractFromNumericOrString(const RapidJsonTarget& target_element, const rapidjson::GenericStringRef<Ch>& member, DataType default_value)
+	{
+		const rapidjson::Value* value = FindMemberValue(target_element, member);
+		if constexpr (INSTRUMENTATION_ENABLED)
+		{
+			if (value && value->IsString())
+				InstrumentNumericStringKey(InstrumentationKey(member));
+			else if (value && !IsValidValue<DataType>(*value))
+				InstrumentTypeMismatch(InstrumentationKey(member));
+		}
+		return value ? ExtractValueFromNumericOrString<DataType>(*value, default_value) : default_value;
+	}
+
+	template<typename DataType, typename RapidJsonTarget>
+	inline DataType ExtractFromNumericOrString(const RapidJsonTarget& target_element, const rapidjson::Value& member, DataType default_value)
+	{
+		const rapidjson::Value* value = FindMemberValue(target_element, member);
+		if constexpr (INSTRUMENTATION_ENABLED)
+		{
+			if (value && value->IsString())
+				InstrumentNumericStringKey(InstrumentationKey(member));
+			else if (value && !IsValidValue<DataType>(*value))
+				InstrumentTypeMismatch(InstrumentationKey(member));
+		}
+		return value ? ExtractValueFromNumericOrString<DataType>(*value, default_value) : default_value;
+	}
+
+	//
+	// Array extraction
+	//
+	// Extracts a whole array of numbers (or of anything Extract<>() handles) into contiguous
+	// memory: a std::vector (resized once), a std::array or (with C++20) a std::span, whose size
+	// must then match exactly. Elements follow the same type rules as Extract<>(), and the
+	// FromNumericOrString versions also accept numbers encoded as strings.
+	//
+	//     std::vector<float> weights;
+	//     if (rjutils::ExtractArray(document, "weights", weights))
+	//         ...
+	//
+	// Arrays of fixed-size arrays (e.g. [[x,y,z], ...]) are flattened by passing `row_size`, the
+	// size every inner array must have; `row_stride` leaves room for padding between rows (e.g.
+	// 3 components into a 4-float aligned vertex buffer). Padding is left untouched.
+	//
+	//     std::vector<float> positions;
+	//     rjutils::ExtractArray(mesh, "positions", positions, 3);
+	//
+	// Returns false when the member isn't an array or any element has the wrong type or size;
+	// a std::vector is then cleared, other buffers are left partially written.
+	//
+
+	template<typename Output>
+	struct ArrayOutput;
+
+	template<typename DataType, typename Allocator>
+	struct ArrayOutput<std::vector<DataType, Allocator>>
+	{
+		typedef DataType ValueType;
+		static DataType* Prepare(std::vector<DataType, Allocator>& output, size_t count) { output.resize(count); return output.data(); }
+		static void Discard(std::vector<DataType, Allocator>& output) { output.clear(); }
+	};
+
+	template<typename DataType, size_t N>
+	struct ArrayOutput<std::array<DataType, N>>
+	{
+		typedef DataType ValueType;
+		static DataType* Prepare(std::array<DataType, N>& output, size_t count) { return count == N ? output.data() : nullptr; }
+		static void Discard(std::array<DataType, N>&) {}
+	};
+
+#if defined(__cpp_lib_span)
+	template<typename DataType, size_t EXTENT>
+	struct ArrayOutput<std::span<DataType, EXTENT>>
+	{
+		typedef DataType ValueType;
+		static DataType* Prepare(std::span<DataType, EXTENT>& output, size_t count) { return count == output.size() ? output.data() : nullptr; }
+		static void Discard(std::span<DataType, EXTENT>&) {}
+	};
+#endif
+
+	template<typename DataType, bool FROM_NUMERIC_OR_STRING>
+	inline bool ExtractArrayElement(const rapidjson::Value& element, DataType& out_value)
+	{
+		if constexpr (FROM_NUMERIC_OR_STRING && std::is_arithmetic<DataType>::value && !std::is_same<DataType, bool>::value)
+		{
+			if (element.IsString())
+				return ParseNumber<DataType>(element.GetString(), element.GetStringLength(), out_value) == std::errc();
+		}
+
+		if (!IsValidValue<DataType>(element))
+			return false;
+		out_value = GetValidValue<DataType>(element);
+		return true;
+	}
+
+	template<bool FROM_NUMERIC_OR_STRING, typename Output>
+	inline bool ExtractArrayElements(const rapidjson::Value& array_value, Output& out_values, size_t row_size, size_t row_stride)
+	{
+		typedef typename ArrayOutput<Output>::ValueType DataType;
+
+		if (!array_value.IsArray())
+		{
+			ArrayOutput<Output>::Discard(out_values);
+			return false;
+		}
+
+		if (row_stride < row_size)
+			row_stride = row_size;
+
+		const rapidjson::Value* elements = array_value.Begin();
+		const size_t count = array_value.Size();
+		DataType* out = ArrayOutput<Output>::Prepare(out_values, row_size ? count * row_stride : count);
+		if (!out)
+			return false;
+
+		bool valid = true;
+		if (row_size == 0)
+		{
+			for (size_t i = 0; i < count; ++i)
+				valid &= ExtractArrayElement<DataType, FROM_NUMERIC_OR_STRING>(elements[i], out[i]);
+		}
+		else
+		{
+			for (size_t row = 0; row < count && valid; ++row, out += row_stride)
+			{
+				const rapidjson::Value& inner = elements[row];
+				if (!inner.IsArray() || inner.Size() != row_size)
+				{
+					valid = false;
+					break;
+				}
+
+				const rapidjson::Value* innerElements = inner.Begin();
+				for (size_t i = 0; i < row_size; ++i)
+					valid &= ExtractArrayElement<DataType, FROM_NUMERIC_OR_STRING>(innerElements[i], out[i]);
+			}
+		}
+
+		if (!valid)
+			ArrayOutput<Output>::Discard(out_values);
+		return valid;
+	}
+
+	template<typename Output>
+	inline bool ExtractArrayValue(const rapidjson::Value& array_value, Output&& out_values, size_t row_size = 0, size_t row_stride = 0)
+	{
+		return ExtractArrayElements<false>(array_value, out_values, row_size, row_stride);
+	}
+
+	template<typename Output>
+	inline bool ExtractArrayValueFromNumericOrString(const rapidjson::Value& array_value, Output&& out_values, size_t row_size = 0, size_t row_stride = 0)
+	{
+		return ExtractArrayElements<true>(array_value, out_values, row_size, row_stride);
+	}
+
+	// DataType is deduced from the output, and only checked against it when given explicitly
+	template<typename DataType, typename Output>
+	constexpr bool IsArrayOutputOf()
+	{
+		return std::is_void<DataType>::value || std::is_same<DataType, typename ArrayOutput<typename std::remove_reference<Output>::type>::ValueType>::value;
+	}
+
+	template<typename DataType = void, typename Ch = char, typename RapidJsonTarget, typename Output>
+	inline bool ExtractArray(const RapidJsonTarget& target_element, const Ch* member, Output&& out_values, size_t row_size = 0, size_t row_stride = 0)
+	{
+		static_assert(IsArrayOutputOf<DataType, Output>(), "rjutils::ExtractArray<>() output element type doesn't match DataType");
+		const rapidjson::Value* value = FindMemberValue(target_element, member);
+		if (!value)
+		{
+			ArrayOutput<typename std::remove_reference<Output>::type>::Discard(out_values);
+			return false;
+		}
+		return ExtractArrayElements<false>(*value, out_values, row_size, row_stride);
+	}
+
+	template<typename DataType = void, typename Ch = char, typename RapidJsonTarget, typename Output>
+	inline bool ExtractArray(const RapidJsonTarget& target_element, const rapidjson::GenericStringRef<Ch>& member, Output&& out_values, size_t row_size = 0, size_t row_stride = 0)
+	{
+		static_assert(IsArrayOutputOf<DataType, Output>(), "rjutils::ExtractArray<>() output element type doesn't match DataType");
+		const rapidjson::Value* value = FindMemberValue(target_element, member);
+		if (!value)
+		{
+			ArrayOutput<typename std::remove_reference<Output>::type>::Discard(out_values);
+			return false;
+		}
+		return ExtractArrayElements<false>(*value, out_values, row_size, row_stride);
+	}
+
+	template<typename DataType = void, typename RapidJsonTarget, typename Output>
+	inline bool ExtractArray(const RapidJsonTarget& target_element, const rapidjson::Value& member, Output&& out_values, size_t row_size = 0, size_t row_stride = 0)
+	{
+		static_assert(IsArrayOutputOf<DataType, Output>(), "rjutils::ExtractArray<>() output element type doesn't match DataType");
+		const rapidjson::Value* value = FindMemberValue(target_element, member);
+		if (!value)
+		{
+			ArrayOutput<typename std::remove_reference<Output>::type>::Discard(out_values);
+			return false;
+		}
+		return ExtractArrayElements<false>(*value, out_values, row_size, row_stride);
+	}
+
+	template<typename DataType = void, typename Ch = char, typename RapidJsonTarget, typename Output>
+	inline bool ExtractArrayFromNumericOrString(const RapidJsonTarget& target_element, const Ch* member, Output&& out_values, size_t row_size = 0, size_t row_stride = 0)
+	{
+		static_assert(IsArrayOutputOf<DataType, Output>(), "rjutils::ExtractArrayFromNumericOrString<>() output element type doesn't match DataType");
+		const rapidjson::Value* value = FindMemberValue(target_element, member);
+		if (!value)
+		{
+			ArrayOutput<typename std::remove_reference<Output>::type>::Discard(out_values);
+			return false;
+		}
+		return ExtractArrayElements<true>(*value, out_values, row_size, row_stride);
+	}
+
+	template<typename DataType = void, typename Ch = char, typename RapidJsonTarget, typename Output>
+	inline bool ExtractArrayFromNumericOrString(const RapidJsonTarget& target_element, const rapidjson::GenericStringRef<Ch>& member, Output&& out_values, size_t row_size = 0, size_t row_stride = 0)
+	{
+		static_assert(IsArrayOutputOf<DataType, Output>(), "rjutils::ExtractArrayFromNumericOrString<>() output element type doesn't match DataType");
+		const rapidjson::Value* value = FindMemberValue(target_element, member);
+		if (!value)
+		{
+			ArrayOutput<typename std::remove_reference<Output>::type>::Discard(out_values);
+			return false;
+		}
+		return ExtractArrayElements<true>(*value, out_values, row_size, row_stride);
+	}
+
+	template<typename DataType = void, typename RapidJsonTarget, typename Output>
+	inline bool ExtractArrayFromNumericOrString(const RapidJsonTarget& target_element, const rapidjson::Value& member, Output&& out_values, size_t row_size = 0, size_t row_stride = 0)
+	{
+		static_assert(IsArrayOutputOf<DataType, Output>(), "rjutils::ExtractArrayFromNumericOrString<>() output element type doesn't match DataType");
+		const rapidjson::Value* value = FindMemberValue(target_element, member);
+		if (!value)
+		{
+			ArrayOutput<typename std::remove_reference<Output>::type>::Discard(out_values);
+			return false;
+		}
+		return ExtractArrayElements<true>(*value, out_values, row_size, row_stride);
+	}
+
+	//
+	// Compiled paths
+	//
+	// A JSON pointer parsed once, for extracting nested values without chaining lookups by hand:
+	//
+	//     thread_local const rjutils::CompiledPath SCALE("/scene/nodes/3/transform/scale");
+	//     for (const rapidjson::Document& scene : scenes)
+	//         total += rjutils::ExtractPath<double>(scene, SCALE, 1.0);
+	//
+	// Each level remembers the position of the member it matched last time and checks it first,
+	// so documents with the same shape skip the member searches altogether. Resolving updates
+	// those hints even through a const CompiledPath, so sharing one between threads (e.g. a plain
+	// `static`) is a data race: use one per thread, as above, or a local (copies are cheap).
+	//
+
+	class CompiledPath
+	{
+	public:
+		explicit CompiledPath(const char* pointer)
+		{
+			const bool valid = ParseJsonPointer(pointer, tokens);
+			assert(valid && "rjutils::CompiledPath: malformed JSON pointer");
+			if (!valid)
+			{
+				tokens.clear();
+				is_valid = false;
+			}
+			member_hints.assign(tokens.size(), 0);
+		}
+
+		bool IsValid() const { return is_valid; }
+		size_t GetTokenCount() const { return tokens.size(); }
+
+		// Returns the value at the path, or nullptr if it doesn't exist
+		const rapidjson::Value* Resolve(const rapidjson::Value& root) const
+		{
+			if (!is_valid)
+				return nullptr;
+
+			const rapidjson::Value* node = &root;
+			for (size_t i = 0; i < tokens.size(); ++i)
+			{
+				const PointerToken& token = tokens[i];
+				if (node->IsObject())
+				{
+					const rapidjson::SizeType memberCount = node->MemberCount();
+					const rapidjson::Value::ConstMemberIterator members = node->MemberBegin();
+					const size_t hint = member_hints[i];
+					if (hint < memberCount && NameEquals(members[hint].name, token))
+					{
+						node = &members[hint].value;
+						continue;
+					}
+
+					rapidjson::SizeType found = 0;
+					while (found < memberCount && !NameEquals(members[found].name, token))
+						++found;
+					if (found == memberCount)
+						return nullptr;
+
+					member_hints[i] = found;
+					node = &members[found].value;
+				}
+				else if (node->IsArray() && token.index < node->Size())
+				{
+					node = &(*node)[token.index];
+				}
+				else
+				{
+					return nullptr;
+				}
+			}
+			return node;
+		}
+
+	private:
+		static bool NameEquals(const rapidjson::Value& name, const PointerToken& token)
+		{
+			return name.GetStringLength() == token.name.size() && memcmp(name.GetString(), token.name.data(), token.name.size()) == 0;
+		}
+
+		std::vector<PointerToken> tokens;
+		mutable std::vector<uint32_t> member_hints;	// Member position matched last time, per token (written by const Resolve(): not thread-safe)
+		bool is_valid = true;
+	};
+
+	template<typename RapidJsonTarget>
+	inline const rapidjson::Value* FindPathValue(const RapidJsonTarget& target_element, const CompiledPath& path)
+	{
+		static_assert(std::is_base_of<rapidjson::Value, RapidJsonTarget>::value, "rjutils::FindPathValue() requires a rapidjson::Value or Document");
+		return path.Resolve(target_element);
+	}
+
+	template<typename DataType, typename RapidJsonTarget>
+	inline bool IsValidPath(const RapidJsonTarget& target_element, const CompiledPath& path)
+	{
+		const rapidjson::Value* value = FindPathValue(target_element, path);
+		return value && IsValidValue<DataType>(*value);
+	}
+
+	template<typename DataType, typename RapidJsonTarget>
+	inline DataType ExtractPath(const RapidJsonTarget& target_element, const CompiledPath& path, DataType default_value)
+	{
+		const rapidjson::Value* value = FindPathValue(target_element, path);
+		return value ? ExtractValue<DataType>(*value, default_value) : default_value;
+	}
+
+	template<typename DataType, typename RapidJsonTarget>
+	inline DataType ExtractPathFromNumericOrString(const RapidJsonTarget& target_element, const CompiledPath& path, DataType default_value)
+	{
+		const rapidjson::Value* value = FindPathValue(target_element, path);
+		return value ? ExtractValueFromNumericOrString<DataType>(*value, default_value) : default_value;
+	}
+
+	//
+	// Struct binding
+	//
+	// Declares how a struct maps to an object once, then extracts all of its fields with a single
+	// pass over the object's members, instead of one FindMember scan per field:
+	//
+	//     struct Window { int32_t width = 1280; int32_t height = 720; std::string title; bool vsync = true; };
+	//     RJUTILS_BIND(Window,
+	//         RJUTILS_FIELD(width, "width"),
+	//         RJUTILS_FIELD(height, "height"),
+	//         RJUTILS_FIELD(title, "title"),
+	//         RJUTILS_FIELD(vsync, "vsync"))
+	//
+	//     Window window;
+	//     rjutils::ExtractStruct(document, "window", window);
+	//
+	// Each member name is hashed once and dispatched through a small hash table that is built at
+	// compile time (with a seed picked to avoid collisions between the bound keys), so the cost is
+	// one hash and one key compare per member, whatever the number of fields.
+	//
+	// A field is only written when its key is present and of the right type (same rules as
+	// Extract<>()); otherwise it keeps its current value, so default member initializers act as
+	// defaults. Fields whose type has a binding of its own are extracted recursively. With
+	// duplicated keys, the first one wins.
+	//
+	// RJUTILS_BIND must be used at namespace scope, in the namespace of the struct (it declares a
+	// function found through argument-dependent lookup).
+	//
+	// EmitStruct() (see Writing, below) uses the same binding to write the struct back out.
+	//
+
+	template<typename Struct, typename DataType>
+	struct BoundField
+	{
+		const char* key;
+		rapidjson::SizeType length;
+		DataType Struct::* member;
+	};
+
+	template<typename Struct, typename DataType, size_t N>
+	constexpr BoundField<Struct, DataType> MakeBoundField(const char (&key)[N], DataType Struct::* member)
+	{
+		return BoundField<Struct, DataType>{ key, static_cast<rapidjson::SizeType>(N - 1), member };
+	}
+
+	template<typename T, typename = void>
+	struct HasStructBinding : std::false_type {};
+
+	template<typename T>
+	struct HasStructBinding<T, std::void_t<decltype(RjutilsBindingFor(static_cast<const T*>(nullptr)))>> : std::true_type {};
+
+	template<typename Struct>
+	inline bool ExtractStruct(const rapidjson::Value& object_value, Struct& out_struct);
+
+	template<typename DataType, typename Writer>
+	inline bool EmitValue(Writer& writer, const DataType& value);
+
+	template<typename Struct, typename Writer>
+	inline bool EmitStruct(Writer& writer, const Struct& in_struct);
+
+	template<typename Struct, typename... DataTypes>
+	class StructBinding
+	{
+	public:
+		static constexpr size_t FIELD_COUNT = sizeof...(DataTypes);
+		static_assert(FIELD_COUNT > 0, "RJUTILS_BIND needs at least one field");
+		static_assert(FIELD_COUNT < 0xFFFF, "Too many fields in RJUTILS_BIND");
+
+		constexpr explicit StructBinding(BoundField<Struct, DataTypes>... bound_fields)
+			: fields(bound_fields...)
+			, keys{ bound_fields.key... }
+			, lengths{ bound_fields.length... }
+		{
+			// Pick the seed with the fewest bucket collisions among the first few; at 4 buckets
+			// per key there usually are none.
+			size_t fewestCollisions = FIELD_COUNT + 1;
+			for (uint32_t candidate = 0; candidate < 32 && fewestCollisions > 0; ++candidate)
+			{
+				std::array<bool, TABLE_SIZE> used{};
+				size_t collisions = 0;
+				for (size_t i = 0; i < FIELD_COUNT; ++i)
+				{
+					const uint32_t bucket = HashKey(keys[i], lengths[i], candidate) & (TABLE_SIZE - 1);
+					collisions += used[bucket] ? 1 : 0;
+					used[bucket] = true;
+				}
+				if (collisions < fewestCollisions)
+				{
+					fewestCollisions = collisions;
+					seed = candidate;
+				}
+			}
+
+			for (size_t i = 0; i < TABLE_SIZE; ++i)
+				buckets[i] = NO_FIELD;
+
+			// Chain colliding keys; insert in reverse so each chain is in declaration order
+			for (size_t i = FIELD_COUNT; i-- > 0;)
+			{
+				const uint32_t bucket = HashKey(keys[i], lengths[i], seed) & (TABLE_SIZE - 1);
+				next[i] = buckets[bucket];
+				buckets[bucket] = static_cast<uint16_t>(i);
+			}
+		}
+
+		void Extract(const rapidjson::Value& object_value, Struct& out_struct) const
+		{
+			assert(object_value.IsObject());
+			bool assigned[FIELD_COUNT] = {};
+			for (auto it = object_value.MemberBegin(); it != object_value.MemberEnd(); ++it)
+			{
+				const size_t index = FindField(it->name.GetString(), it->name.GetStringLength());
+				if (index == NO_FIELD || assigned[index])
+					continue;
+
+				assigned[index] = true;
+				ASSIGNERS[index](*this, it->value, out_struct);
+			}
+		}
+
+		// Writes every field, in declaration order
+		template<typename Writer>
+		bool Emit(Writer& writer, const Struct& in_struct) const
+		{
+			return writer.StartObject()
+				&& EmitFields(writer, in_struct, std::index_sequence_for<DataTypes...>{})
+				&& writer.EndObject(static_cast<rapidjson::SizeType>(FIELD_COUNT));
+		}
+
+		// Index of the field bound to `key`, or NO_FIELD
+		size_t FindField(const char* key, size_t length) const
+		{
+			for (uint16_t index = buckets[HashKey(key, length, seed) & (TABLE_SIZE - 1)]; index != NO_FIELD; index = next[index])
+				if (lengths[index] == length && memcmp(keys[index], key, length) == 0)
+					return index;
+			return NO_FIELD;
+		}
+
+		static constexpr uint16_t NO_FIELD = 0xFFFF;
+
+	private:
+		static constexpr size_t TableSizeFor(size_t field_count)
+		{
+			size_t size = 8;
+			while (size < field_count * 4)
+				size <<= 1;
+			return size;
+		}
+
+		static constexpr size_t TABLE_SIZE = TableSizeFor(FIELD_COUNT);
+
+		static constexpr uint32_t HashKey(const char* key, size_t length, uint32_t seed)
+		{
+			uint32_t hash = (seed * 0x9E3779B9u) ^ static_cast<uint32_t>(length);
+			for (size_t i = 0; i < length; ++i)
+				hash = (hash ^ static_cast<unsigned char>(key[i])) * 0x01000193u;
+			return hash ^ (hash >> 15);
+		}
+
+		template<typename DataType>
+		static void AssignValue(const rapidjson::Value& value, DataType& out_value)
+		{
+			if constexpr (HasStructBinding<DataType>::value)
+			{
+				if (value.IsObject())
+					ExtractStruct(value, out_value);
+			}
+			else
+			{
+				// Fields of the wrong type keep their value (without reading it: it may be uninitialized)
+				if (IsValidValue<DataType>(value))
+					out_value = GetValidValue<DataType>(value);
+			}
+		}
+
+		template<size_t I>
+		static void AssignField(const StructBinding& binding, const rapidjson::Value& value, Struct& out_struct)
+		{
+			AssignValue(value, out_struct.*(std::get<I>(binding.fields).member));
+		}
+
+		template<typename Writer, size_t... I>
+		bool EmitFields(Writer& writer, const Struct& in_struct, std::index_sequence<I...>) const
+		{
+			return ((writer.Key(keys[I], lengths[I]) && EmitValue(writer, in_struct.*(std::get<I>(fields).member))) && ...);
+		}
+
+		typedef void (*Assigner)(const StructBinding&, const rapidjson::Value&, Struct&);
+
+		template<size_t... I>
+		static constexpr std::array<Assigner, FIELD_COUNT> MakeAssigners(std::index_sequence<I...>)
+		{
+			return { { &AssignField<I>... } };
+		}
+
+		static constexpr std::array<Assigner, FIELD_COUNT> ASSIGNERS = MakeAssigners(std::index_sequence_for<DataTypes...>{});
+
+		std::tuple<BoundField<Struct, DataTypes>...> fields;
+		std::array<const char*, FIELD_COUNT> keys{};
+		std::array<rapidjson::SizeType, FIELD_COUNT> lengths{};
+		std::array<uint16_t, TABLE_SIZE> buckets{};
+		std::array<uint16_t, FIELD_COUNT> next{};
+		uint32_t seed = 0;
+	};
+
+	template<typename Struct, typename... DataTypes>
+	constexpr StructBinding<Struct, DataTypes...> MakeStructBinding(BoundField<Struct, DataTypes>... bound_fields)
+	{
+		return StructBinding<Struct, DataTypes...>(bound_fields...);
+	}
+
+	// Extracts every bound field of `out_struct` from `object_value`; returns false if it isn't an object
+	template<typename Struct>
+	inline bool ExtractStruct(const rapidjson::Value& object_value, Struct& out_struct)
+	{
+		static_assert(HasStructBinding<Struct>::value, "rjutils::ExtractStruct() needs an RJUTILS_BIND() for this type");
+		static constexpr auto binding = RjutilsBindingFor(static_cast<const Struct*>(nullptr));
+
+		if (!object_value.IsObject())
+			return false;
+
+		binding.Extract(object_value, out_struct);
+		return true;
+	}
+
+	template<typename Struct, typename Ch = char, typename RapidJsonTarget>
+	inline bool ExtractStruct(const RapidJsonTarget& target_element, const Ch* member, Struct& out_struct)
+	{
+		const rapidjson::Value* value = FindMemberValue(target_element, member);
+		return value && ExtractStruct(*value, out_struct);
+	}
+
+	template<typename Struct, typename Ch = char, typename RapidJsonTarget>
+	inline bool ExtractStruct(const RapidJsonTarget& target_element, const rapidjson::GenericStringRef<Ch>& member, Struct& out_struct)
+	{
+		const rapidjson::Value* value = FindMemberValue(target_element, member);
+		return value && ExtractStruct(*value, out_struct);
+	}
+
+	template<typename Struct, typename RapidJsonTarget>
+	inline bool ExtractStruct(const RapidJsonTarget& target_element, const rapidjson::Value& member, Struct& out_struct)
+	{
+		const rapidjson::Value* value = FindMemberValue(target_element, member);
+		return value && ExtractStruct(*value, out_struct);
+	}
+
+	//
+	// Writing
+	//
+	// The write side of Extract<>(): Emit() writes a key and a value straight into a rapidjson
+	// Writer, with the same type dispatch as Extract<>(), so responses are serialized without
+	// building a Value tree first:
+	//
+	//     rjutils::Emitter& emitter = rjutils::ThreadLocalEmitter();
+	//     auto& writer = emitter.Start();
+	//     writer.StartObject();
+	//     rjutils::Emit(writer, "id", request_id);
+	//     rjutils::Emit(writer, "name", name);
+	//     rjutils::EmitArray(writer, "scores", scores);
+	//     rjutils::EmitStruct(writer, "window", window);
+	//     writer.EndObject();
+	//     emitter.WriteTo(socket_fd);
+	//
+	// Integers go to Int/Uint/Int64/Uint64 by type (other integer types to Int64/Uint64),
+	// floating point to Double, strings (char pointers and arrays, std::string, std::string_view,
+	// a single char) to String with their known length, and structs with an RJUTILS_BIND() to an
+	// object with every bound field in declaration order. A null char pointer is written as null.
+	// Everything returns false as soon as the Writer does (e.g. for a NaN without
+	// kWriteNanAndInfFlag).
+	//
+	// OutputBuffer is a growable output stream that is rewound, not freed, between documents;
+	// an Emitter pairs one with a Writer (whose level stack is kept too), so after warm-up
+	// writing does no heap allocations at all. The output is then handed to the OS as is, with
+	// WriteAll() on a file descriptor or as an iovec for writev() (e.g. behind HTTP headers).
+	// FdWriteStream is the bounded-memory alternative for large documents: it writes through a
+	// fixed buffer, flushing it to the descriptor whenever it fills up.
+	//
+
+	// Writes all of `data` to `fd`, retrying short writes and interrupted calls. `fd` should be
+	// blocking: on a non-blocking one that is full this fails with errno == EAGAIN. On Windows it
+	// is a CRT file descriptor (_open, _fileno), which excludes sockets.
+	inline bool WriteAll(int fd, const void* data, size_t size)
+	{
+		const char* remaining = static_cast<const char*>(data);
+		while (size > 0)
+		{
+		#ifdef _WIN32
+			const int written = _write(fd, remaining, static_cast<unsigned int>(std::min<size_t>(size, INT_MAX)));
+		#else
+			const ssize_t written = write(fd, remaining, size);
+		#endif
+			if (written < 0)
+			{
+				if (errno == EINTR)
+					continue;
+				return false;
+			}
+			remaining += written;
+			size -= static_cast<size_t>(written);
+		}
+		return true;
+	}
+
+#ifndef _WIN32
+	// Writes all of the `count` buffers in `parts` to `fd`, in as few writev() calls as possible.
+	// `parts` is updated as the data goes out, so it can't be reused afterwards.
+	inline bool WriteAll(int fd, iovec* parts, size_t count)
+	{
+	#ifdef IOV_MAX
+		constexpr size_t MAX_PARTS = IOV_MAX;
+	#else
+		constexpr size_t MAX_PARTS = 1024;
+	#endif
+		while (count > 0)
+		{
+			if (parts->iov_len == 0)
+			{
+				++parts;
+				--count;
+				continue;
+			}
+
+			ssize_t written = writev(fd, parts, static_cast<int>(std::min(count, MAX_PARTS)));
+			if (written < 0)
+			{
+				if (errno == EINTR)
+					continue;
+				return false;
+			}
+
+			// Skip what was written, which may end in the middle of a part
+			while (count > 0 && static_cast<size_t>(written) >= parts->iov_len)
+			{
+				written -= static_cast<ssize_t>(parts->iov_len);
+				++parts;
+				--count;
+			}
+			if (written > 0)
+			{
+				parts->iov_base = static_cast<char*>(parts->iov_base) + written;
+				parts->iov_len -= static_cast<size_t>(written);
+			}
+		}
+		return true;
+	}
+#endif
+
+	// Growable output stream for rapidjson::Writer. Clear() rewinds it and keeps the memory, so a
+	// reused buffer only allocates when a document is larger than every one before it. The
+	// output isn't null-terminated.
+	class OutputBuffer
+	{
+	public:
+		typedef char Ch;
+
+		static constexpr size_t MIN_CAPACITY = 256;
+
+		OutputBuffer() = default;
+		explicit OutputBuffer(size_t initial_capacity) { Reserve(initial_capacity); }
+
+		OutputBuffer(const OutputBuffer&) = delete;
+		OutputBuffer& operator=(const OutputBuffer&) = delete;
+		OutputBuffer(OutputBuffer&&) = default;
+		OutputBuffer& operator=(OutputBuffer&&) = default;
+
+		void Put(char c)
+		{
+			if (size == capacity)
+				Grow(1);
+			data[size++] = c;
+		}
+
+		// Only after Reserve() made room for it
+		void PutUnsafe(char c)
+		{
+			assert(size < capacity);
+			data[size++] = c;
+		}
+
+		// Makes room for `count` more characters
+		void Reserve(size_t count)
+		{
+			if (capacity - size < count)
+				Grow(count);
+		}
+
+		void Flush() {}
+		void Clear() { size = 0; }
+
+		const char* GetData() const { return data.get(); }
+		size_t GetSize() const { return size; }
+		size_t GetCapacity() const { return capacity; }
+		std::string_view GetView() const { return std::string_view(data.get(), size); }
+
+	#ifndef _WIN32
+		iovec GetIovec() const { return iovec{ const_cast<char*>(data.get()), size }; }
+	#endif
+
+	private:
+		void Grow(size_t count)
+		{
+			size_t newCapacity = std::max(capacity, MIN_CAPACITY);
+			while (newCapacity - size < count)
+				newCapacity *= 2;
+
+			std::unique_ptr<char[]> newData(new char[newCapacity]);
+			if (size > 0)
+				memcpy(newData.get(), data.get(), size);
+			data = std::move(newData);
+			capacity = newCapacity;
+		}
+
+		std::unique_ptr<char[]> data;
+		size_t size = 0;
+		size_t capacity = 0;
+	};
+
+	// Found by argument-dependent lookup from rapidjson::Writer, which then reserves once per
+	// value and copies characters without checking the capacity each time (like StringBuffer)
+	inline void PutReserve(OutputBuffer& stream, size_t count) { stream.Reserve(count); }
+	inline void PutUnsafe(OutputBuffer& stream, char c) { stream.PutUnsafe(c); }
+
+	// Output stream that writes to a file descriptor through `buffer`, like rapidjson's
+	// FileWriteStream does to a FILE*. The Writer flushes it when the document is complete; if any
+	// write fails, the rest of the output is dropped and HasFailed() returns true.
+	class FdWriteStream
+	{
+	public:
+		typedef char Ch;
+
+		FdWriteStream(int fd, char* buffer, size_t buffer_size)
+			: fd(fd)
+			, buffer(buffer)
+			, buffer_end(buffer + buffer_size)
+			, current(buffer)
+		{
+			assert(buffer_size > 0);
+		}
+
+		FdWriteStream(const FdWriteStream&) = delete;
+		FdWriteStream& operator=(const FdWriteStream&) = delete;
+
+		void Put(char c)
+		{
+			if (current == buffer_end)
+				Flush();
+			*current++ = c;
+		}
+
+		void Flush()
+		{
+			if (current != buffer)
+			{
+				if (!failed)
+				{
+					failed = !WriteAll(fd, buffer, static_cast<size_t>(current - buffer));
+					written += static_cast<size_t>(current - buffer);
+				}
+				current = buffer;
+			}
+		}
+
+		bool HasFailed() const { return failed; }
+		size_t GetBytesWritten() const { return written; }
+
+		// Not implemented, this is an output-only stream
+		char Peek() const { assert(false); return 0; }
+		char Take() { assert(false); return 0; }
+		size_t Tell() const { assert(false); return 0; }
+		char* PutBegin() { assert(false); return nullptr; }
+		size_t PutEnd(char*) { assert(false); return 0; }
+
+	private:
+		int fd;
+		char* buffer;
+		char* buffer_end;
+		char* current;
+		size_t written = 0;
+		bool failed = false;
+	};
+
+	// Reusable writing context for high-rate writing of many (usually small) documents: an
+	// OutputBuffer and the Writer over it, both reset (not freed) by Start(). The output is only
+	// valid until the next Start(). Not thread-safe; use one per thread, e.g. ThreadLocalEmitter().
+	class Emitter
+	{
+	public:
+		typedef rapidjson::Writer<OutputBuffer> WriterType;
+
+		static constexpr size_t DEFAULT_BUFFER_SIZE = 16 * 1024;
+
+		explicit Emitter(size_t buffer_size = DEFAULT_BUFFER_SIZE)
+			: buffer(buffer_size)
+			, writer(buffer)
+		{
+		}
+
+		// The Writer points into the buffer
+		Emitter(const Emitter&) = delete;
+		Emitter& operator=(const Emitter&) = delete;
+
+		// Drops the previous output and returns the Writer, ready for a new document
+		WriterType& Start()
+		{
+			buffer.Clear();
+			writer.Reset(buffer);
+			return writer;
+		}
+
+		WriterType& GetWriter() { return writer; }
+		const OutputBuffer& GetOutput() const { return buffer; }
+		bool IsComplete() const { return writer.IsComplete(); }
+
+		bool WriteTo(int fd) const
+		{
+			assert(writer.IsComplete());
+			return WriteAll(fd, buffer.GetData(), buffer.GetSize());
+		}
+
+	private:
+		OutputBuffer buffer;
+		WriterType writer;
+	};
+
+	// One Emitter per thread, created on first use
+	inline Emitter& ThreadLocalEmitter()
+	{
+		thread_local Emitter emitter;
+		return emitter;
+	}
+
+	template<typename DataType, typename Writer>
+	inline bool EmitValue(Writer& writer, const DataType& value)
+	{
+		if constexpr (std::is_same<DataType, int32_t>::value)
+			return writer.Int(value);
+		else if constexpr (std::is_same<DataType, uint32_t>::value)
+			return writer.Uint(value);
+		else if constexpr (std::is_same<DataType, int64_t>::value)
+			return writer.Int64(value);
+		else if constexpr (std::is_same<DataType, uint64_t>::value)
+			return writer.Uint64(value);
+		else if constexpr (std::is_same<DataType, bool>::value)
+			return writer.Bool(value);
+		else if constexpr (std::is_floating_point<DataType>::value)
+			return writer.Double(static_cast<double>(value));
+		else if constexpr (std::is_same<DataType, char>::value)
+			return writer.String(&value, 1);
+		else if constexpr (std::is_same<DataType, char*>::value
+			|| std::is_same<DataType, const char*>::value)
+		{
+			if (!value)
+				return writer.Null();
+			const size_t length = strlen(value);
+			assert(length <= std::numeric_limits<rapidjson::SizeType>::max());
+			return writer.String(value, static_cast<rapidjson::SizeType>(length));
+		}
+		else if constexpr (std::is_array<DataType>::value && std::is_same<typename std::remove_extent<DataType>::type, char>::value)
+		{
+			// String literals and char buffers, up to the terminator if there is one
+			const size_t length = static_cast<size_t>(std::find(value, value + std::extent<DataType>::value, '\0') - value);
+			return writer.String(value, static_cast<rapidjson::SizeType>(length));
+		}
+		else if constexpr (std::is_same<DataType, std::string>::value
+			|| std::is_same<DataType, std::string_view>::value)
+		{
+			assert(value.size() <= std::numeric_limits<rapidjson::SizeType>::max());
+			return writer.String(value.data(), static_cast<rapidjson::SizeType>(value.size()));
+		}
+		else if constexpr (HasStructBinding<DataType>::value)
+			return EmitStruct(writer, value);
+		else if constexpr (std::is_integral<DataType>::value && std::is_signed<DataType>::value)
+			return writer.Int64(static_cast<int64_t>(value));
+		else if constexpr (std::is_integral<DataType>::value && std::is_unsigned<DataType>::value)
+			return writer.Uint64(static_cast<uint64_t>(value));
+		else
+			static_assert(dependent_false<DataType>::value, "Attempting to invoke rjutil::Emit<>() with invalid data type");
+
+		return false;
+	}
+
+	template<typename DataType, typename Ch = char, typename Writer>
+	inline bool Emit(Writer& writer, const Ch* member, const DataType& value)
+	{
+		return writer.Key(member, static_cast<rapidjson::SizeType>(strlen(member))) && EmitValue(writer, value);
+	}
+
+	template<typename DataType, typename Ch = char, typename Writer>
+	inline bool Emit(Writer& writer, const rapidjson::GenericStringRef<Ch>& member, const DataType& value)
+	{
+		return writer.Key(member.s, member.length) && EmitValue(writer, value);
+	}
+
+	template<typename DataType, typename Writer>
+	inline bool Emit(Writer& writer, const rapidjson::Value& member, const DataType& value)
+	{
+		assert(member.IsString());
+		return writer.Key(member.GetString(), member.GetStringLength()) && EmitValue(writer, value);
+	}
+
+	// Writes anything with std::data() and std::size() (a std::vector, std::array, std::span,
+	// C array...) as an array of EmitValue()s. With `row_size`, writes it as an array of arrays of
+	// that size instead, skipping `row_stride - row_size` padding elements after every row: the
+	// inverse of ExtractArray() with the same arguments.
+	template<typename Writer, typename Input>
+	inline bool EmitArrayValue(Writer& writer, const Input& values, size_t row_size = 0, size_t row_stride = 0)
+	{
+		const auto* elements = std::data(values);
+		const size_t count = std::size(values);
+		if (!writer.StartArray())
+			return false;
+
+		if (row_size == 0)
+		{
+			for (size_t i = 0; i < count; ++i)
+				if (!EmitValue(writer, elements[i]))
+					return false;
+			return writer.EndArray(static_cast<rapidjson::SizeType>(count));
+		}
+
+		if (row_stride < row_size)
+			row_stride = row_size;
+		assert(count % row_stride == 0);
+
+		const size_t rowCount = count / row_stride;
+		for (size_t row = 0; row < rowCount; ++row, elements += row_stride)
+		{
+			if (!writer.StartArray())
+				return false;
+			for (size_t i = 0; i < row_size; ++i)
+				if (!EmitValue(writer, elements[i]))
+					return false;
+			if (!writer.EndArray(static_cast<rapidjson::SizeType>(row_size)))
+				return false;
+		}
+		return writer.EndArray(static_cast<rapidjson::SizeType>(rowCount));
+	}
+
+	template<typename Ch = char, typename Writer, typename Input>
+	inline bool EmitArray(Writer& writer, const Ch* member, const Input& values, size_t row_size = 0, size_t row_stride = 0)
+	{
+		return writer.Key(member, static_cast<rapidjson::SizeType>(strlen(member))) && EmitArrayValue(writer, values, row_size, row_stride);
+	}
+
+	template<typename Ch = char, typename Writer, typename Input>
+	inline bool EmitArray(Writer& writer, const rapidjson::GenericStringRef<Ch>& member, const Input& values, size_t row_size = 0, size_t row_stride = 0)
+	{
+		return writer.Key(member.s, member.length) && EmitArrayValue(writer, values, row_size, row_stride);
+	}
+
+	template<typename Writer, typename Input>
+	inline bool EmitArray(Writer& writer, const rapidjson::Value& member, const Input& values, size_t row_size = 0, size_t row_stride = 0)
+	{
+		assert(member.IsString());
+		return writer.Key(member.GetString(), member.GetStringLength()) && EmitArrayValue(writer, values, row_size, row_stride);
+	}
+
+	// Writes every bound field of `in_struct` as an object, in declaration order
+	template<typename Struct, typename Writer>
+	inline bool EmitStruct(Writer& writer, const Struct& in_struct)
+	{
+		static_assert(HasStructBinding<Struct>::value, "rjutils::EmitStruct() needs an RJUTILS_BIND() for this type");
+		static constexpr auto binding = RjutilsBindingFor(static_cast<const Struct*>(nullptr));
+		return binding.Emit(writer, in_struct);
+	}
+
+	template<typename Struct, typename Ch = char, typename Writer>
+	inline bool EmitStruct(Writer& writer, const Ch* member, const Struct& in_struct)
+	{
+		return writer.Key(member, static_cast<rapidjson::SizeType>(strlen(member))) && EmitStruct(writer, in_struct);
+	}
+
+	template<typename Struct, typename Ch = char, typename Writer>
+	inline bool EmitStruct(Writer& writer, const rapidjson::GenericStringRef<Ch>& member, const Struct& in_struct)
+	{
+		return writer.Key(member.s, member.length) && EmitStruct(writer, in_struct);
+	}
+
+	template<typename Struct, typename Writer>
+	inline bool EmitStruct(Writer& writer, const rapidjson::Value& member, const Struct& in_struct)
+	{
+		assert(member.IsString());
+		return writer.Key(member.GetString(), member.GetStringLength()) && EmitStruct(writer, in_struct);
+	}
+}
+
+// Binds `member_name` of the struct being bound to the JSON key `key` (a string literal)
+#define RJUTILS_FIELD(member_name, key) ::rjutils::MakeBoundField<RjutilsBoundStruct>(key, &RjutilsBoundStruct::member_name)
+
+// Declares the binding of `Struct` as a list of RJUTILS_FIELD()s
+#define RJUTILS_BIND(Struct, ...) \
+	constexpr auto RjutilsBindingFor(const Struct*) \
+	{ \
+		using RjutilsBoundStruct = Struct; \
+		return ::rjutils::MakeStructBinding<Struct>(__VA_ARGS__); \
 	}
-}
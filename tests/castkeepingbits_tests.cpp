@@ -0,0 +1,133 @@
+//
+// CastKeepingBits tests. Built as C++17 and, where the compiler has it, as C++20 for the span
+// overloads.
+//
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include "CastKeepingBits.hpp"
+#include "test_utils.hpp"
+
+namespace
+{
+	static_assert(CanCastKeepingBitsInPlace<uint32_t, int32_t>::value, "");
+	static_assert(CanCastKeepingBitsInPlace<const int64_t, uint64_t>::value, "");
+	static_assert(CanCastKeepingBitsInPlace<float, float>::value, "");
+	static_assert(!CanCastKeepingBitsInPlace<uint32_t, float>::value, "");
+	static_assert(!CanCastKeepingBitsInPlace<int32_t, int64_t>::value, "");
+	static_assert(!CanCastKeepingBitsInPlace<bool, unsigned char>::value, "");
+
+#if defined(CASTKEEPINGBITS_BIT_CAST)
+	// CASTKEEPINGBITS_CONSTEXPR is constexpr here: the casts work in constant expressions
+	static_assert(CastKeepingBits<uint32_t>(-1) == 0xFFFFFFFFu, "");
+	static_assert(CastKeepingBits<int32_t>(0x80000000u) == std::numeric_limits<int32_t>::min(), "");
+	static_assert(CastKeepingBits<uint32_t>(1.0f) == 0x3F800000u, "");
+	static_assert(CastKeepingBits<double>(CastKeepingBits<uint64_t>(-2.5)) == -2.5, "");
+	constexpr uint32_t CONSTANT_SEED = CastKeepingBits<uint32_t>(-123456789);
+	static_assert(CastKeepingBits<int32_t>(CONSTANT_SEED) == -123456789, "");
+#endif
+
+	TEST(CastKeepingBitsRoundTrips)
+	{
+		const int32_t ints[] = { 0, 1, -1, std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::max(), -123456789 };
+		for (const int32_t value : ints)
+		{
+			const uint32_t bits = CastKeepingBits<uint32_t>(value);
+			CHECK(bits == static_cast<uint32_t>(value));
+			CHECK(CastKeepingBits<int32_t>(bits) == value);
+		}
+
+		const float floats[] = { 0.f, -0.f, 1.f, -2.5f, std::numeric_limits<float>::denorm_min(), std::numeric_limits<float>::infinity() };
+		for (const float value : floats)
+		{
+			const uint32_t bits = CastKeepingBits<uint32_t>(value);
+			CHECK(CastKeepingBits<float>(bits) == value);
+			CHECK(CastKeepingBits<uint32_t>(CastKeepingBits<float>(bits)) == bits);
+		}
+		CHECK(CastKeepingBits<uint32_t>(-0.f) == 0x80000000u);
+
+		// NaN payloads survive
+		const uint64_t nanBits = 0x7FF4000000C0FFEEull;
+		CHECK(CastKeepingBits<uint64_t>(CastKeepingBits<double>(nanBits)) == nanBits);
+	}
+
+	TEST(CastKeepingBitsBulkRoundTrips)
+	{
+		std::vector<float> floats;
+		for (int i = 0; i < 1000; ++i)
+			floats.push_back(static_cast<float>(i) * -0.37f);
+		floats.push_back(CastKeepingBits<float>(0x7FC00123u));	// A NaN with a payload
+
+		std::vector<uint32_t> bits(floats.size(), 0xDEADBEEFu);
+		CastKeepingBitsBulk(floats.data(), bits.data(), floats.size());
+		for (size_t i = 0; i < floats.size(); ++i)
+			CHECK(bits[i] == CastKeepingBits<uint32_t>(floats[i]));
+
+		std::vector<float> back(floats.size());
+		CastKeepingBitsBulk(bits.data(), back.data(), bits.size());
+		for (size_t i = 0; i < floats.size(); ++i)
+			CHECK(CastKeepingBits<uint32_t>(back[i]) == bits[i]);
+
+		// Zero elements: touches nothing, null pointers included
+		uint32_t untouched = 7;
+		CastKeepingBitsBulk(floats.data(), &untouched, 0);
+		CastKeepingBitsBulk<uint32_t, float>(nullptr, nullptr, 0);
+		CHECK(untouched == 7);
+	}
+
+#if defined(__cpp_lib_span)
+	TEST(CastKeepingBitsSpanViews)
+	{
+		int32_t values[] = { -1, 0, 1, std::numeric_limits<int32_t>::min() };
+
+		// Mutable view, same memory
+		std::span<uint32_t, 4> view = CastKeepingBitsSpan<uint32_t>(std::span<int32_t, 4>(values));
+		CHECK(static_cast<const void*>(view.data()) == static_cast<const void*>(values));
+		CHECK(view[0] == 0xFFFFFFFFu && view[3] == 0x80000000u);
+		view[1] = 0xFFFFFFFEu;
+		CHECK(values[1] == -2);
+
+		// Constness and dynamic extents are kept
+		const std::vector<int64_t> constValues = { -5, 5 };
+		auto constView = CastKeepingBitsSpan<uint64_t>(std::span<const int64_t>(constValues));
+		static_assert(std::is_same<decltype(constView), std::span<const uint64_t>>::value, "");
+		CHECK(constView.size() == 2 && constView[0] == static_cast<uint64_t>(-5));
+
+		// Back again
+		auto roundTrip = CastKeepingBitsSpan<int64_t>(constView);
+		CHECK(roundTrip[0] == -5 && roundTrip[1] == 5);
+	}
+
+	TEST(CastKeepingBitsSpanCopies)
+	{
+		const float floats[] = { 1.f, -2.f, 0.5f };
+		uint32_t bits[3] = {};
+		const std::span<uint32_t> written = CastKeepingBitsSpan(std::span<const float>(floats), std::span<uint32_t, 3>(bits));
+		CHECK(written.size() == 3 && written.data() == bits);
+		CHECK(bits[0] == 0x3F800000u && bits[1] == 0xC0000000u && bits[2] == 0x3F000000u);
+
+		float back[3] = {};
+		CastKeepingBitsSpan(std::span<const uint32_t>(bits), std::span<float>(back));
+		CHECK(back[0] == 1.f && back[1] == -2.f && back[2] == 0.5f);
+
+		// A larger destination: only the start is written, and returned
+		std::vector<uint32_t> larger(8, 0xAAAAAAAAu);
+		const std::span<uint32_t> prefix = CastKeepingBitsSpan(std::span<const float>(floats), std::span<uint32_t>(larger));
+		CHECK(prefix.size() == 3 && prefix.data() == larger.data());
+		CHECK(larger[2] == 0x3F000000u);
+		for (size_t i = 3; i < larger.size(); ++i)
+			CHECK(larger[i] == 0xAAAAAAAAu);
+
+		// Nothing to copy
+		const std::span<uint32_t> none = CastKeepingBitsSpan(std::span<const float>(), std::span<uint32_t>(larger));
+		CHECK(none.empty());
+		CHECK(larger[0] == 0x3F800000u);
+	}
+#endif
+}
+
+int main()
+{
+	return tests::RunTests();
+}
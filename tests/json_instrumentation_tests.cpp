@@ -0,0 +1,85 @@
+//
+// rapidjson_utils with RJUTILS_INSTRUMENTATION, which has to be its own executable: the header
+// must see the same definition everywhere. Files are written to the working directory.
+//
+
+#define RJUTILS_INSTRUMENTATION
+
+#include <cstdio>
+#include <string>
+#include "rapidjson_utils.hpp"
+#include "test_utils.hpp"
+
+namespace
+{
+	// A valid document of exactly `size` bytes
+	std::string MakeDocument(size_t size)
+	{
+		std::string json = "{\"padding\":\"";
+		json.append(size - json.size() - 2, 'x');
+		json += "\"}";
+		return json;
+	}
+
+	void WriteTextFile(const char* file_name, const std::string& contents)
+	{
+		FILE* fp = fopen(file_name, "wb");
+		CHECK(fp != nullptr);
+		if (!fp)
+			return;
+		CHECK(fwrite(contents.data(), 1, contents.size(), fp) == contents.size());
+		fclose(fp);
+	}
+
+	template<typename ParseFunction>
+	void CheckCountedOnce(const char* file_name, size_t size, ParseFunction parse)
+	{
+		WriteTextFile(file_name, MakeDocument(size));
+		rjutils::ResetInstrumentationStats();
+		CHECK(parse(file_name));
+		const rjutils::InstrumentationStats stats = rjutils::GetInstrumentationStats();
+		CHECK(stats.files_parsed == 1);
+		CHECK(stats.file_bytes == size);
+		remove(file_name);
+	}
+
+	TEST(ParseFileMappedIsCountedOnce)
+	{
+		auto parse = [](const char* file_name)
+		{
+			rjutils::InsituDocument document;
+			return rjutils::ParseFileMapped(file_name, document);
+		};
+		CheckCountedOnce("mapped.json", 1000, parse);
+
+		// A whole number of pages falls back to ParseFileInsitu(), which gets the bytes
+		CheckCountedOnce("mapped.json", 4096, parse);
+		CheckCountedOnce("mapped.json", 65536, parse);
+	}
+
+	TEST(ParseFileCachedIsCountedOnce)
+	{
+		remove("cached.json.rjsnap");
+		auto parse = [](const char* file_name)
+		{
+			rjutils::InsituDocument document;
+			return rjutils::ParseFileCached(file_name, document);
+		};
+		CheckCountedOnce("cached.json", 1000, parse);
+		remove("cached.json.rjsnap");
+	}
+
+	TEST(ParseFileIsCountedOnce)
+	{
+		CheckCountedOnce("plain.json", 1000, [](const char* file_name)
+		{
+			rapidjson::Document document;
+			return rjutils::ParseFile(file_name, document);
+		});
+	}
+}
+
+int main()
+{
+	return tests::RunTests();
+}
@@ -0,0 +1,938 @@
+//
+// Behavior tests for rapidjson_utils. Files are written to the working directory.
+//
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstdio>
+#include <filesystem>
+#include <limits>
+#include <string>
+#include <typeinfo>
+#include <vector>
+#include "rapidjson_utils.hpp"
+#include "test_utils.hpp"
+
+namespace
+{
+	void WriteTextFile(const char* file_name, const std::string& contents)
+	{
+		FILE* fp = fopen(file_name, "wb");
+		CHECK(fp != nullptr);
+		if (!fp)
+			return;
+		CHECK(fwrite(contents.data(), 1, contents.size(), fp) == contents.size());
+		fclose(fp);
+	}
+
+	std::string ReadTextFile(const char* file_name)
+	{
+		std::string contents;
+		FILE* fp = fopen(file_name, "rb");
+		if (!fp)
+			return contents;
+		char buffer[4096];
+		size_t read = 0;
+		while ((read = fread(buffer, 1, sizeof(buffer), fp)) > 0)
+			contents.append(buffer, read);
+		fclose(fp);
+		return contents;
+	}
+
+	//-----------------------------------------------------------------------------------------
+	// Parser arenas
+
+	std::string MakeLargeDocument(int count)
+	{
+		std::string json = "{\"items\":[";
+		for (int i = 0; i < count; ++i)
+		{
+			json += (i ? ",{\"id\":" : "{\"id\":") + std::to_string(i);
+			json += ",\"name\":\"item number " + std::to_string(i) + " with a name longer than the small string\"}";
+		}
+		json += "]}";
+		return json;
+	}
+
+	bool HoldsLargeDocument(const rapidjson::Value& document, int count)
+	{
+		if (!document.IsObject() || !document.HasMember("items") || document["items"].Size() != static_cast<rapidjson::SizeType>(count))
+			return false;
+		const rapidjson::Value& last = document["items"][count - 1];
+		return rjutils::Extract<int64_t>(last, "id", -1) == count - 1
+			&& rjutils::Extract<std::string>(last, "name", std::string()) == "item number " + std::to_string(count - 1) + " with a name longer than the small string";
+	}
+
+	TEST(ParserGrowsOwnedArenas)
+	{
+		// Both documents overflow both arenas: the second parse grows them (freeing the buffers
+		// the first parse's pools were built over) and must not touch the old ones
+		const std::string large = MakeLargeDocument(2000);
+		rjutils::Parser parser(1024, 256);
+		CHECK(parser.Parse(large.c_str()));
+		CHECK(HoldsLargeDocument(parser.GetDocument(), 2000));
+		CHECK(parser.Parse(large.data(), large.size()));
+		CHECK(HoldsLargeDocument(parser.GetDocument(), 2000));
+		CHECK(parser.GetArenaSize() > 1024);
+
+		// Grown arenas are kept for smaller documents
+		const char* const small = "{\"items\":[{\"id\":0,\"name\":\"item\"}]}";
+		CHECK(parser.Parse(small));
+		const size_t arenaSize = parser.GetArenaSize();
+		CHECK(parser.Parse(small));
+		CHECK(rjutils::Extract<int64_t>(parser.GetDocument()["items"][0], "id", -1) == 0);
+		CHECK(parser.GetArenaSize() == arenaSize);
+		CHECK(parser.Parse(large.c_str()));
+		CHECK(HoldsLargeDocument(parser.GetDocument(), 2000));
+	}
+
+	TEST(ParserWithCallerArenas)
+	{
+		const std::string large = MakeLargeDocument(500);
+		std::vector<char> arena(512);
+		std::vector<char> stackArena(256);
+		{
+			rjutils::Parser parser(arena.data(), arena.size(), stackArena.data(), stackArena.size());
+			for (int i = 0; i < 3; ++i)
+			{
+				CHECK(parser.Parse(large.c_str()));
+				CHECK(HoldsLargeDocument(parser.GetDocument(), 500));
+			}
+			CHECK(parser.GetArenaSize() == arena.size());
+		}
+	}
+
+	TEST(ParserParsesFiles)
+	{
+		const std::string large = MakeLargeDocument(3000);
+		WriteTextFile("parser.json", large);
+		rjutils::Parser parser(1024, 256);
+		CHECK(parser.ParseFile("parser.json"));
+		CHECK(parser.ParseFile("parser.json"));
+		CHECK(HoldsLargeDocument(parser.GetDocument(), 3000));
+
+		std::string insitu = large;
+		CHECK(parser.ParseInsitu(&insitu[0]));
+		CHECK(HoldsLargeDocument(parser.GetDocument(), 3000));
+		remove("parser.json");
+	}
+
+	//-----------------------------------------------------------------------------------------
+	// Numeric strings
+
+	const char* const NUMBER_INPUTS[] = {
+		"", "+", "-", "+-5", "-+5", "--5", "++5", " 42", "42 ", "42px", "abc", "0x1A",
+		"0", "-0", "+0", "7", "-7", "+7", "00012", "-00012",
+		"2147483647", "2147483648", "-2147483648", "-2147483649", "4294967295", "4294967296",
+		"1234567890123456789", "-1234567890123456789", "+1234567890123456789",
+		"9223372036854775807", "9223372036854775808", "-9223372036854775808", "-9223372036854775809",
+		"18446744073709551615", "18446744073709551616", "-18446744073709551615",
+		"99999999999999999999", "00000000000000000001", "12345678a", "1234567a9012345678",
+		"0.25", "-1.5e3", "+1e-5", ".5", "5.", "1e", "1e+", "3.4028235e38", "1e39", "1e309", "-1e309",
+		"inf", "-inf", "nan", "1.7976931348623157e308", "2.2250738585072014e-308",
+	};
+
+	// What ParseNumber should give, from the strto* functions: the whole text must be consumed,
+	// with none of the extras strto* accept (leading whitespace, hexadecimal, negative unsigned)
+	template<typename DataType>
+	std::errc ReferenceNumber(const std::string& text, DataType& out_value)
+	{
+		if (text.empty() || text.find_first_of(" \t\n\v\f\rxX") != std::string::npos)
+			return std::errc::invalid_argument;
+		if (std::is_unsigned<DataType>::value && text.find('-') != std::string::npos)
+			return std::errc::invalid_argument;
+
+		char* end = nullptr;
+		errno = 0;
+		if constexpr (std::is_floating_point<DataType>::value)
+		{
+			// Mirrors from_chars(), which has no inf/nan/hex in JSON strings either way
+			const DataType result = std::is_same<DataType, float>::value ? strtof(text.c_str(), &end) : static_cast<DataType>(strtod(text.c_str(), &end));
+			if (end != text.c_str() + text.size())
+				return std::errc::invalid_argument;
+			if (errno == ERANGE)
+				return std::errc::result_out_of_range;
+			out_value = result;
+		}
+		else if constexpr (std::is_signed<DataType>::value)
+		{
+			const long long result = strtoll(text.c_str(), &end, 10);
+			if (end != text.c_str() + text.size())
+				return std::errc::invalid_argument;
+			if (errno == ERANGE || result < std::numeric_limits<DataType>::min() || result > std::numeric_limits<DataType>::max())
+				return std::errc::result_out_of_range;
+			out_value = static_cast<DataType>(result);
+		}
+		else
+		{
+			const unsigned long long result = strtoull(text.c_str(), &end, 10);
+			if (end != text.c_str() + text.size())
+				return std::errc::invalid_argument;
+			if (errno == ERANGE || result > std::numeric_limits<DataType>::max())
+				return std::errc::result_out_of_range;
+			out_value = static_cast<DataType>(result);
+		}
+		return std::errc();
+	}
+
+	template<typename DataType>
+	void CheckParseNumberMatchesReference()
+	{
+		for (const char* const input : NUMBER_INPUTS)
+		{
+			const std::string text(input);
+			DataType expected = DataType(17);
+			DataType parsed = DataType(17);
+			const std::errc expectedError = ReferenceNumber(text, expected);
+
+			// Not null-terminated, to catch reads past `length`
+			std::string padded = text + "9";
+			const std::errc error = rjutils::ParseNumber<DataType>(padded.data(), text.size(), parsed);
+			if (error != expectedError || (error == std::errc() && !(parsed == expected || (parsed != parsed && expected != expected))))
+			{
+				std::printf("ParseNumber<%s>(\"%s\") disagrees with strto*\n", typeid(DataType).name(), input);
+				CHECK(false);
+			}
+			if (error != std::errc())
+				CHECK(parsed == DataType(17));
+		}
+	}
+
+	TEST(ParseNumberMatchesStrto)
+	{
+		CheckParseNumberMatchesReference<int32_t>();
+		CheckParseNumberMatchesReference<uint32_t>();
+		CheckParseNumberMatchesReference<int64_t>();
+		CheckParseNumberMatchesReference<uint64_t>();
+		CheckParseNumberMatchesReference<int16_t>();
+		CheckParseNumberMatchesReference<uint8_t>();
+		CheckParseNumberMatchesReference<float>();
+		CheckParseNumberMatchesReference<double>();
+	}
+
+	TEST(ParseNumberBoundaries)
+	{
+		int64_t signedValue = 0;
+		CHECK(rjutils::ParseNumber<int64_t>("-9223372036854775808", 20, signedValue) == std::errc());
+		CHECK(signedValue == std::numeric_limits<int64_t>::min());
+		CHECK(rjutils::ParseNumber<int64_t>("+-5", 3, signedValue) == std::errc::invalid_argument);
+
+		uint64_t unsignedValue = 0;
+		CHECK(rjutils::ParseNumber<uint64_t>("18446744073709551615", 20, unsignedValue) == std::errc());
+		CHECK(unsignedValue == std::numeric_limits<uint64_t>::max());
+		CHECK(rjutils::ParseNumber<uint64_t>("-1", 2, unsignedValue) == std::errc::invalid_argument);
+
+		double doubleValue = 0.0;
+		CHECK(rjutils::ParseNumber<double>("+-5", 3, doubleValue) == std::errc::invalid_argument);
+		CHECK(rjutils::ParseNumber<double>("+-5.5", 5, doubleValue) == std::errc::invalid_argument);
+		CHECK(doubleValue == 0.0);
+
+		// Through the extraction functions, invalid strings give the default
+		rapidjson::Document document;
+		document.Parse("{\"space\":\" 42\",\"negative\":\"-1\",\"signs\":\"+-5\",\"ok\":\"+42\"}");
+		CHECK(rjutils::ExtractFromNumericOrString<int32_t>(document, "space", 7) == 7);
+		CHECK(rjutils::ExtractFromNumericOrString<uint32_t>(document, "negative", 7) == 7);
+		CHECK(rjutils::ExtractFromNumericOrString<int32_t>(document, "signs", 7) == 7);
+		CHECK(rjutils::ExtractFromNumericOrString<float>(document, "signs", 7.f) == 7.f);
+		CHECK(rjutils::ExtractFromNumericOrString<int32_t>(document, "ok", 7) == 42);
+	}
+
+	//-----------------------------------------------------------------------------------------
+	// Indexed objects
+
+	// An object with `count` members "k0".."k<count-1>" (value i), plus keys that only differ
+	// in length or by an embedded NUL, and a duplicated key
+	std::string MakeWideObject(int count)
+	{
+		std::string json = "{";
+		for (int i = 0; i < count; ++i)
+			json += "\"k" + std::to_string(i) + "\":" + std::to_string(i) + ",";
+		json += "\"ab\":1,\"abc\":2,\"ab\\u0000\":3,\"ab\\u0000c\":4,\"dup\":\"first\",\"dup\":\"second\"}";
+		return json;
+	}
+
+	void CheckIndexedLookups(const rapidjson::Value& object, int count)
+	{
+		const rjutils::IndexedObject indexed(object);
+		CHECK(indexed.IsHashed() == (object.MemberCount() > rjutils::IndexedObject::LINEAR_SCAN_MAX_MEMBERS));
+		CHECK(&indexed.GetValue() == &object);
+
+		for (int i = 0; i < count; ++i)
+			CHECK(rjutils::Extract<int64_t>(indexed, ("k" + std::to_string(i)).c_str(), -1) == i);
+
+		CHECK(rjutils::Extract<int64_t>(indexed, "ab", 0) == 1);
+		CHECK(rjutils::Extract<int64_t>(indexed, "abc", 0) == 2);
+		CHECK(rjutils::Extract<int64_t>(indexed, rapidjson::StringRef("ab\0", 3), 0) == 3);
+		CHECK(rjutils::Extract<int64_t>(indexed, rapidjson::StringRef("ab\0c", 4), 0) == 4);
+		CHECK(indexed.Find("a", 1) == nullptr);
+		CHECK(indexed.Find("abcd", 4) == nullptr);
+		CHECK(indexed.Find("ab\0d", 4) == nullptr);
+
+		// Same as FindMember(): the first duplicate wins
+		CHECK(rjutils::Extract<std::string>(indexed, "dup", std::string()) == "first");
+		CHECK(rjutils::Extract<std::string>(object, "dup", std::string()) == "first");
+
+		CHECK(indexed.Find("missing", 7) == nullptr);
+		CHECK(!rjutils::IsValid<int64_t>(indexed, "missing"));
+		CHECK(rjutils::Extract<int64_t>(indexed, ("k" + std::to_string(count)).c_str(), -1) == -1);
+		CHECK(indexed.Find("", 0) == nullptr);
+	}
+
+	TEST(IndexedObjectMatchesFindMember)
+	{
+		// Linear scan (just the special keys), and hashed tables of several load factors
+		const int counts[] = { 0, 6, 7, 100, 1000 };
+		for (const int count : counts)
+		{
+			rapidjson::Document document;
+			document.Parse(MakeWideObject(count).c_str());
+			CHECK(!document.HasParseError());
+			CheckIndexedLookups(document, count);
+		}
+	}
+
+	TEST(IndexedObjectAfterRebuild)
+	{
+		rapidjson::Document document;
+		document.Parse(MakeWideObject(100).c_str());
+		{
+			// Values changed in place keep the members where they are
+			const rjutils::IndexedObject indexed(document);
+			document["k50"].SetInt(-50);
+			CHECK(rjutils::Extract<int64_t>(indexed, "k50", 0) == -50);
+		}
+
+		// Rebuilt with other members: a new index over it sees only those
+		document.SetObject();
+		for (int i = 0; i < 40; ++i)
+		{
+			const std::string name = "n" + std::to_string(i);
+			document.AddMember(rapidjson::Value(name.c_str(), static_cast<rapidjson::SizeType>(name.size()), document.GetAllocator()), rapidjson::Value(i * 2), document.GetAllocator());
+		}
+		const rjutils::IndexedObject indexed(document);
+		CHECK(indexed.IsHashed());
+		CHECK(indexed.Find("k50", 3) == nullptr);
+		for (int i = 0; i < 40; ++i)
+			CHECK(rjutils::Extract<int64_t>(indexed, ("n" + std::to_string(i)).c_str(), -1) == i * 2);
+
+		// ... and down to a linear scan
+		document.SetObject();
+		document.AddMember("only", 1, document.GetAllocator());
+		const rjutils::IndexedObject small(document);
+		CHECK(!small.IsHashed());
+		CHECK(rjutils::Extract<int64_t>(small, "only", 0) == 1);
+		CHECK(small.Find("n0", 2) == nullptr);
+	}
+
+	//-----------------------------------------------------------------------------------------
+	// Selective parsing and compiled paths
+
+	const char* const NESTED_JSON =
+		"{\"header\":{\"version\":3,\"name\":\"level\"},"
+		"\"assets\":[{\"id\":10},{\"id\":11},{\"id\":12,\"tags\":[\"a\",\"b\"]}],"
+		"\"a/b\":{\"m~n\":7},"
+		"\"skipped\":{\"deep\":[1,2,3]}}";
+
+	TEST(SelectiveKeepsOnlyRequestedPaths)
+	{
+		rapidjson::StringStream stream(NESTED_JSON);
+		const char* const pointers[] = { "/header/version", "/assets/2/tags/1", "/a~1b/m~0n", "/missing/value" };
+		rapidjson::Document document;
+		CHECK(rjutils::ParseStreamSelective(stream, pointers, 4, document));
+
+		CHECK(rjutils::Extract<int64_t>(document["header"], "version", 0) == 3);
+		CHECK(!document["header"].HasMember("name"));
+		CHECK(!document.HasMember("skipped"));
+		CHECK(!document.HasMember("missing"));
+		CHECK(rjutils::Extract<int64_t>(document["a/b"], "m~n", 0) == 7);
+
+		// Array elements keep their index, with nulls before them
+		const rapidjson::Value& assets = document["assets"];
+		CHECK(assets.IsArray() && assets.Size() == 3);
+		CHECK(assets[0].IsNull() && assets[1].IsNull());
+		const rapidjson::Value& tags = assets[2]["tags"];
+		CHECK(tags.IsArray() && tags.Size() == 2 && tags[0].IsNull());
+		CHECK(std::string(tags[1].GetString()) == "b");
+	}
+
+	TEST(SelectiveKeepsWholeSubtrees)
+	{
+		rapidjson::StringStream stream(NESTED_JSON);
+		const char* const pointers[] = { "/assets" };
+		rapidjson::Document document;
+		CHECK(rjutils::ParseStreamSelective(stream, pointers, 1, document));
+		CHECK(document["assets"].Size() == 3);
+		CHECK(rjutils::Extract<int64_t>(document["assets"][1], "id", 0) == 11);
+		CHECK(document["assets"][2]["tags"].Size() == 2);
+	}
+
+	TEST(SelectiveFromFile)
+	{
+		WriteTextFile("selective.json", NESTED_JSON);
+		rapidjson::Document document;
+		CHECK(rjutils::ParseFileSelective("selective.json", { "/header/name" }, document));
+		CHECK(rjutils::Extract<std::string>(document["header"], "name", std::string()) == "level");
+		remove("selective.json");
+	}
+
+	TEST(CompiledPathResolves)
+	{
+		rapidjson::Document document;
+		document.Parse(NESTED_JSON);
+		CHECK(!document.HasParseError());
+
+		const rjutils::CompiledPath id("/assets/2/id");
+		const rjutils::CompiledPath escaped("/a~1b/m~0n");
+		const rjutils::CompiledPath outOfRange("/assets/3/id");
+		const rjutils::CompiledPath throughScalar("/header/version/x");
+		const rjutils::CompiledPath root("");
+		CHECK(id.IsValid() && id.GetTokenCount() == 3);
+		CHECK(rjutils::ExtractPath<int64_t>(document, id, 0) == 12);
+		CHECK(rjutils::ExtractPath<int64_t>(document, escaped, 0) == 7);
+		CHECK(rjutils::FindPathValue(document, outOfRange) == nullptr);
+		CHECK(rjutils::FindPathValue(document, throughScalar) == nullptr);
+		CHECK(rjutils::FindPathValue(document, root) == &document);
+		CHECK(!rjutils::IsValidPath<std::string>(document, id));
+	}
+
+	TEST(CompiledPathHintsFollowTheDocument)
+	{
+		// Same path over documents whose members are in different orders: the hint from the
+		// previous document must never return the wrong member
+		const rjutils::CompiledPath path("/b/value");
+		const char* const documents[] = {
+			"{\"a\":1,\"b\":{\"value\":1}}",
+			"{\"b\":{\"x\":0,\"value\":2},\"a\":1}",
+			"{\"c\":0,\"a\":1,\"b\":{\"value\":3}}",
+			"{\"a\":{\"value\":-1}}",
+			"{\"a\":1,\"b\":{\"value\":5}}",
+		};
+		const int64_t expected[] = { 1, 2, 3, 0, 5 };
+		for (size_t i = 0; i < 5; ++i)
+		{
+			rapidjson::Document document;
+			document.Parse(documents[i]);
+			CHECK(rjutils::ExtractPath<int64_t>(document, path, 0) == expected[i]);
+		}
+	}
+
+	//-----------------------------------------------------------------------------------------
+	// Mapped files
+
+	size_t GetPageSize()
+	{
+	#ifdef _WIN32
+		SYSTEM_INFO systemInfo;
+		GetSystemInfo(&systemInfo);
+		return systemInfo.dwPageSize;
+	#else
+		return static_cast<size_t>(sysconf(_SC_PAGESIZE));
+	#endif
+	}
+
+	// A valid document of exactly `size` bytes
+	std::string MakeDocumentOfSize(size_t size)
+	{
+		std::string json = "{\"padding\":\"";
+		json.append(size - json.size() - 2, 'p');
+		json += "\"}";
+		return json;
+	}
+
+	TEST(ParseFileMappedFallsBackOnPageSizes)
+	{
+		const size_t pageSize = GetPageSize();
+		CHECK(pageSize >= 64);
+
+		// Whole pages have no room for the terminating '\0' and go through ParseFileInsitu()
+		const size_t sizes[] = { 100, pageSize - 1, pageSize, pageSize + 1, 3 * pageSize };
+		for (const size_t size : sizes)
+		{
+			WriteTextFile("mapped.json", MakeDocumentOfSize(size));
+			rjutils::InsituDocument document;
+			CHECK(rjutils::ParseFileMapped("mapped.json", document));
+			CHECK(document.IsMapped() == (size % pageSize != 0));
+			CHECK(document.GetBufferSize() == size);
+			CHECK(rjutils::Extract<std::string_view>(document.GetDocument(), "padding", {}).size() == size - 14);
+
+			// Parsed in-situ in a private copy: the file itself is untouched
+			CHECK(ReadTextFile("mapped.json") == MakeDocumentOfSize(size));
+		}
+
+		// An empty file can't be mapped either; it fails like ParseFileInsitu() does
+		WriteTextFile("mapped.json", "");
+		rjutils::InsituDocument empty;
+		CHECK(!rjutils::ParseFileMapped("mapped.json", empty));
+		CHECK(!empty.IsMapped());
+		CHECK(empty.GetDocument().GetParseError() == rapidjson::kParseErrorDocumentEmpty);
+		rjutils::InsituDocument emptyInsitu;
+		CHECK(!rjutils::ParseFileInsitu("mapped.json", emptyInsitu));
+		CHECK(emptyInsitu.GetDocument().GetParseError() == rapidjson::kParseErrorDocumentEmpty);
+		remove("mapped.json");
+	}
+
+	//-----------------------------------------------------------------------------------------
+	// Parallel parsing
+
+	TEST(ParseFilesKeepsPerFileResults)
+	{
+		// More files than threads, so the read-ahead thread runs too
+		const int count = 40;
+		const int missing = 7;
+		const int malformed = 23;
+		std::vector<std::string> names;
+		for (int i = 0; i < count; ++i)
+		{
+			names.push_back("parse_files_" + std::to_string(i) + ".json");
+			remove(names.back().c_str());
+			if (i == malformed)
+				WriteTextFile(names.back().c_str(), "{\"index\":23,");
+			else if (i != missing)
+				WriteTextFile(names.back().c_str(), "{\"index\":" + std::to_string(i) + ",\"fill\":\"" + std::string(static_cast<size_t>(i) * 1000, 'f') + "\"}");
+		}
+		std::vector<const char*> fileNames;
+		for (const std::string& name : names)
+			fileNames.push_back(name.c_str());
+
+		const unsigned int threadCounts[] = { 1, 3, 8, 0 };
+		for (const unsigned int threads : threadCounts)
+		{
+			std::vector<rapidjson::Document> documents(count);
+			std::vector<rjutils::ParseFileStatus> status(count);
+			CHECK(!rjutils::ParseFiles(fileNames.data(), count, documents.data(), status.data(), threads));
+
+			for (int i = 0; i < count; ++i)
+			{
+				if (i == missing)
+				{
+					CHECK(!status[i].success && status[i].io_error == ENOENT);
+				}
+				else if (i == malformed)
+				{
+					CHECK(!status[i].success && status[i].io_error == 0);
+					CHECK(status[i].parse_error != rapidjson::kParseErrorNone);
+					CHECK(status[i].error_offset > 0);
+				}
+				else
+				{
+					CHECK(status[i].success && status[i].io_error == 0 && status[i].parse_error == rapidjson::kParseErrorNone);
+					CHECK(rjutils::Extract<int64_t>(documents[i], "index", -1) == i);
+					CHECK(rjutils::Extract<std::string_view>(documents[i], "fill", {}).size() == static_cast<size_t>(i) * 1000);
+				}
+			}
+		}
+
+		// An empty file reads fine, but isn't a document
+		WriteTextFile("parse_files_empty.json", "");
+		const char* const emptyName = "parse_files_empty.json";
+		rapidjson::Document emptyDocument;
+		rjutils::ParseFileStatus emptyStatus;
+		CHECK(!rjutils::ParseFiles(&emptyName, 1, &emptyDocument, &emptyStatus));
+		CHECK(emptyStatus.io_error == 0 && emptyStatus.parse_error == rapidjson::kParseErrorDocumentEmpty);
+		remove(emptyName);
+
+		// Without statuses, and with every file readable
+		std::vector<rapidjson::Document> documents(5);
+		CHECK(rjutils::ParseFiles(fileNames.data(), 5, documents.data()));
+		CHECK(rjutils::Extract<int64_t>(documents[4], "index", -1) == 4);
+		CHECK(rjutils::ParseFiles(fileNames.data(), 0, documents.data()));
+
+		for (const std::string& name : names)
+			remove(name.c_str());
+	}
+
+	//-----------------------------------------------------------------------------------------
+	// Array streaming
+
+	TEST(ParseStreamArrayVisitsEveryElement)
+	{
+		// Small elements, and a few larger than the handler's scratch buffer and chunks
+		std::string json = "{\"before\":[1,2],\"items\":[";
+		const std::string big(300 * 1024, 'b');
+		const int count = 5000;
+		for (int i = 0; i < count; ++i)
+		{
+			json += i ? "," : "";
+			if (i % 1000 == 999)
+				json += "{\"id\":" + std::to_string(i) + ",\"blob\":\"" + big + "\",\"list\":[\"" + big + "\"]}";
+			else
+				json += "{\"id\":" + std::to_string(i) + ",\"tags\":[\"t" + std::to_string(i) + "\",null,{\"x\":[]}]}";
+		}
+		json += "],\"after\":{}}";
+
+		int visited = 0;
+		bool matches = true;
+		rapidjson::StringStream stream(json.c_str());
+		CHECK(rjutils::ParseStreamArray(stream, "items", [&](const rapidjson::Value& item)
+		{
+			matches = matches && rjutils::Extract<int64_t>(item, "id", -1) == visited;
+			if (visited % 1000 == 999)
+				matches = matches && item["blob"].GetStringLength() == big.size() && item["list"][0].GetStringLength() == big.size();
+			else
+				matches = matches && item["tags"].Size() == 3 && std::string(item["tags"][0].GetString()) == "t" + std::to_string(visited) && item["tags"][2]["x"].IsArray();
+			++visited;
+		}));
+		CHECK(visited == count);
+		CHECK(matches);
+
+		// Stopped by the visitor
+		visited = 0;
+		rapidjson::StringStream again(json.c_str());
+		CHECK(rjutils::ParseStreamArray(again, "items", [&](const rapidjson::Value&) { return ++visited < 10; }));
+		CHECK(visited == 10);
+	}
+
+	//-----------------------------------------------------------------------------------------
+	// Snapshots
+
+	const char* const SNAPSHOT_SOURCE = "snapshot.json";
+	const char* const SNAPSHOT_FILE = "snapshot.json.rjsnap";
+	const char* const SNAPSHOT_JSON =
+		"{\"name\":\"config \\\"quoted\\\"\",\"count\":-42,\"big\":18446744073709551615,\"ratio\":0.25,"
+		"\"flags\":[true,false,null],\"nested\":{\"empty\":{},\"list\":[]}}";
+
+	bool HoldsSnapshotJson(const rjutils::InsituDocument& document)
+	{
+		const rapidjson::Document& d = document.GetDocument();
+		return d.IsObject()
+			&& rjutils::Extract<std::string>(d, "name", std::string()) == "config \"quoted\""
+			&& rjutils::Extract<int64_t>(d, "count", 0) == -42
+			&& rjutils::Extract<uint64_t>(d, "big", 0) == std::numeric_limits<uint64_t>::max()
+			&& rjutils::Extract<double>(d, "ratio", 0.0) == 0.25
+			&& d["flags"].Size() == 3 && d["flags"][0].IsTrue() && d["flags"][1].IsFalse() && d["flags"][2].IsNull()
+			&& d["nested"]["empty"].IsObject() && d["nested"]["empty"].MemberCount() == 0
+			&& d["nested"]["list"].IsArray() && d["nested"]["list"].Size() == 0;
+	}
+
+	TEST(SnapshotRoundTrip)
+	{
+		remove(SNAPSHOT_FILE);
+		WriteTextFile(SNAPSHOT_SOURCE, SNAPSHOT_JSON);
+
+		rjutils::InsituDocument parsed;
+		CHECK(rjutils::ParseFileCached(SNAPSHOT_SOURCE, parsed));
+		CHECK(!parsed.IsMapped());
+		CHECK(HoldsSnapshotJson(parsed));
+		CHECK(std::filesystem::exists(SNAPSHOT_FILE));
+
+		rjutils::InsituDocument loaded;
+		CHECK(rjutils::ParseFileCached(SNAPSHOT_SOURCE, loaded));
+		CHECK(loaded.IsMapped());
+		CHECK(HoldsSnapshotJson(loaded));
+	}
+
+	TEST(SameSizeRewriteIsReparsed)
+	{
+		const std::string before = "{\"value\":1111,\"name\":\"before\"}";
+		const std::string after = "{\"value\":2222,\"name\":\"after!\"}";
+		CHECK(before.size() == after.size());
+
+		for (int keepTime = 0; keepTime < 2; ++keepTime)
+		{
+			remove(SNAPSHOT_FILE);
+			WriteTextFile(SNAPSHOT_SOURCE, before);
+			const std::filesystem::file_time_type writeTime = std::filesystem::last_write_time(SNAPSHOT_SOURCE);
+			{
+				rjutils::InsituDocument document;
+				CHECK(rjutils::ParseFileCached(SNAPSHOT_SOURCE, document));
+				CHECK(rjutils::Extract<int64_t>(document.GetDocument(), "value", 0) == 1111);
+			}
+
+			// Rewritten right away; the second time with the exact same timestamp, like a
+			// filesystem with coarse times would give
+			WriteTextFile(SNAPSHOT_SOURCE, after);
+			if (keepTime)
+				std::filesystem::last_write_time(SNAPSHOT_SOURCE, writeTime);
+
+			rjutils::InsituDocument reloaded;
+			CHECK(rjutils::ParseFileCached(SNAPSHOT_SOURCE, reloaded));
+			CHECK(!reloaded.IsMapped());
+			CHECK(rjutils::Extract<int64_t>(reloaded.GetDocument(), "value", 0) == 2222);
+			CHECK(rjutils::Extract<std::string>(reloaded.GetDocument(), "name", std::string()) == "after!");
+
+			rjutils::InsituDocument loaded;
+			CHECK(rjutils::ParseFileCached(SNAPSHOT_SOURCE, loaded));
+			CHECK(loaded.IsMapped());
+			CHECK(rjutils::Extract<int64_t>(loaded.GetDocument(), "value", 0) == 2222);
+		}
+	}
+
+	TEST(CorruptSnapshotIsReparsed)
+	{
+		WriteTextFile(SNAPSHOT_SOURCE, SNAPSHOT_JSON);
+		{
+			rjutils::InsituDocument document;
+			CHECK(rjutils::ParseFileCached(SNAPSHOT_SOURCE, document));
+		}
+
+		// Invalid tag for the root value
+		std::string snapshot = ReadTextFile(SNAPSHOT_FILE);
+		CHECK(snapshot.size() > sizeof(rjutils::SnapshotHeader));
+		snapshot[sizeof(rjutils::SnapshotHeader)] = static_cast<char>(0x7F);
+		WriteTextFile(SNAPSHOT_FILE, snapshot);
+
+		rjutils::InsituDocument reparsed;
+		CHECK(rjutils::ParseFileCached(SNAPSHOT_SOURCE, reparsed));
+		CHECK(!reparsed.IsMapped());
+		CHECK(HoldsSnapshotJson(reparsed));
+
+		// ... which rewrote a good snapshot
+		rjutils::InsituDocument loaded;
+		CHECK(rjutils::ParseFileCached(SNAPSHOT_SOURCE, loaded));
+		CHECK(loaded.IsMapped());
+		CHECK(HoldsSnapshotJson(loaded));
+	}
+
+	TEST(TruncatedSnapshotIsReparsed)
+	{
+		WriteTextFile(SNAPSHOT_SOURCE, SNAPSHOT_JSON);
+		{
+			rjutils::InsituDocument document;
+			CHECK(rjutils::ParseFileCached(SNAPSHOT_SOURCE, document));
+		}
+
+		const std::string snapshot = ReadTextFile(SNAPSHOT_FILE);
+		const size_t cuts[] = { snapshot.size() - 1, snapshot.size() / 2, sizeof(rjutils::SnapshotHeader), sizeof(rjutils::SnapshotHeader) - 1, 0 };
+		for (const size_t cut : cuts)
+		{
+			WriteTextFile(SNAPSHOT_FILE, snapshot.substr(0, cut));
+			rjutils::InsituDocument reparsed;
+			CHECK(rjutils::ParseFileCached(SNAPSHOT_SOURCE, reparsed));
+			CHECK(!reparsed.IsMapped());
+			CHECK(HoldsSnapshotJson(reparsed));
+		}
+
+		// A body that lies about its own sizes, with a header that matches it
+		std::string lying = snapshot;
+		const size_t countOffset = sizeof(rjutils::SnapshotHeader) + 1;	// Member count of the root object
+		lying[countOffset] = static_cast<char>(0x7F);
+		WriteTextFile(SNAPSHOT_FILE, lying);
+		rjutils::InsituDocument reparsed;
+		CHECK(rjutils::ParseFileCached(SNAPSHOT_SOURCE, reparsed));
+		CHECK(!reparsed.IsMapped());
+		CHECK(HoldsSnapshotJson(reparsed));
+
+		remove(SNAPSHOT_FILE);
+		remove(SNAPSHOT_SOURCE);
+	}
+
+	//-----------------------------------------------------------------------------------------
+	// Emit / Extract round trips
+
+	struct Vector3
+	{
+		double x = 0.0;
+		double y = 0.0;
+		double z = 0.0;
+	};
+	RJUTILS_BIND(Vector3,
+		RJUTILS_FIELD(x, "x"),
+		RJUTILS_FIELD(y, "y"),
+		RJUTILS_FIELD(z, "z"))
+
+	struct Entity
+	{
+		int32_t id = 0;
+		uint32_t flags = 0;
+		int64_t created = 0;
+		uint64_t hash = 0;
+		bool active = false;
+		float scale = 0.f;
+		std::string name;
+		Vector3 position;
+	};
+	RJUTILS_BIND(Entity,
+		RJUTILS_FIELD(id, "id"),
+		RJUTILS_FIELD(flags, "flags"),
+		RJUTILS_FIELD(created, "created"),
+		RJUTILS_FIELD(hash, "hash"),
+		RJUTILS_FIELD(active, "active"),
+		RJUTILS_FIELD(scale, "scale"),
+		RJUTILS_FIELD(name, "name"),
+		RJUTILS_FIELD(position, "position"))
+
+	TEST(EmitStructRoundTrips)
+	{
+		Entity entity;
+		entity.id = std::numeric_limits<int32_t>::min();
+		entity.flags = std::numeric_limits<uint32_t>::max();
+		entity.created = std::numeric_limits<int64_t>::min();
+		entity.hash = std::numeric_limits<uint64_t>::max();
+		entity.active = true;
+		entity.scale = 0.1f;
+		entity.name = "tab\there \"quoted\" \\ / \xC3\xA9";
+		entity.position = { -1.5, 1e300, 5e-324 };
+
+		rjutils::Emitter emitter;
+		auto& writer = emitter.Start();
+		CHECK(rjutils::EmitStruct(writer, entity));
+		CHECK(emitter.IsComplete());
+
+		rapidjson::Document document;
+		document.Parse(emitter.GetOutput().GetData(), emitter.GetOutput().GetSize());
+		CHECK(!document.HasParseError());
+
+		Entity back;
+		CHECK(rjutils::ExtractStruct(document, back));
+		CHECK(back.id == entity.id);
+		CHECK(back.flags == entity.flags);
+		CHECK(back.created == entity.created);
+		CHECK(back.hash == entity.hash);
+		CHECK(back.active);
+		CHECK(back.scale == entity.scale);
+		CHECK(back.name == entity.name);
+		CHECK(back.position.x == entity.position.x && back.position.y == entity.position.y && back.position.z == entity.position.z);
+	}
+
+	TEST(EmitValuesAndArraysRoundTrip)
+	{
+		const std::vector<float> positions = { 1.f, 2.f, 3.f, 0.f, 4.f, 5.f, 6.f, 0.f };
+		const std::array<int64_t, 3> ids = { -1, 0, std::numeric_limits<int64_t>::max() };
+		const std::vector<Vector3> points = { { 1, 2, 3 }, { 4, 5, 6 } };
+		const char* nothing = nullptr;
+		char buffer[16] = "abc";
+
+		rjutils::Emitter emitter;
+		for (int round = 0; round < 2; ++round)	// The second document reuses the buffers
+		{
+			auto& writer = emitter.Start();
+			writer.StartObject();
+			CHECK(rjutils::Emit(writer, "literal", "text"));
+			CHECK(rjutils::Emit(writer, rapidjson::StringRef("view"), std::string_view("a\0b", 3)));
+			CHECK(rjutils::Emit(writer, "buffer", buffer));
+			CHECK(rjutils::Emit(writer, "nothing", nothing));
+			CHECK(rjutils::Emit<int64_t>(writer, "widened", 7));
+			CHECK(rjutils::Emit(writer, "small", static_cast<int16_t>(-3)));
+			CHECK(rjutils::EmitArray(writer, "positions", positions, 3, 4));
+			CHECK(rjutils::EmitArray(writer, "flat", positions));
+			CHECK(rjutils::EmitArray(writer, "ids", ids));
+			CHECK(rjutils::EmitArray(writer, "points", points));
+			CHECK(writer.EndObject());
+			CHECK(emitter.IsComplete());
+
+			rapidjson::Document document;
+			document.Parse(emitter.GetOutput().GetData(), emitter.GetOutput().GetSize());
+			CHECK(!document.HasParseError());
+
+			CHECK(rjutils::Extract<std::string>(document, "literal", std::string()) == "text");
+			CHECK(rjutils::Extract<std::string>(document, "view", std::string()) == std::string("a\0b", 3));
+			CHECK(rjutils::Extract<std::string>(document, "buffer", std::string()) == "abc");
+			CHECK(document["nothing"].IsNull());
+			CHECK(rjutils::Extract<int64_t>(document, "widened", 0) == 7);
+			CHECK(rjutils::Extract<int64_t>(document, "small", 0) == -3);
+
+			std::vector<float> rows(8, -1.f);
+			CHECK(rjutils::ExtractArray(document, "positions", rows, 3, 4));
+			CHECK(rows[0] == 1.f && rows[2] == 3.f && rows[4] == 4.f && rows[6] == 6.f);
+			std::vector<float> flat;
+			CHECK(rjutils::ExtractArray(document, "flat", flat));
+			CHECK(flat == positions);
+			std::array<int64_t, 3> idsBack = {};
+			CHECK(rjutils::ExtractArray(document, "ids", idsBack));
+			CHECK(idsBack == ids);
+
+			Vector3 second;
+			CHECK(rjutils::ExtractStruct(document["points"][1], second));
+			CHECK(second.x == 4 && second.y == 5 && second.z == 6);
+		}
+	}
+
+	TEST(ExtractArrayIntoUninitializedOutputs)
+	{
+		rapidjson::Document document;
+		document.Parse("{\"floats\":[1.5,-2.25,3.0],\"ints\":[1,-2,3],\"mixed\":[1,\"x\",3],\"numbers\":[\"1.5\",2.0,\"-3\"]}");
+
+		std::array<float, 3> floats;
+		CHECK(rjutils::ExtractArray(document, "floats", floats));
+		CHECK(floats[0] == 1.5f && floats[1] == -2.25f && floats[2] == 3.f);
+
+		std::array<int16_t, 3> ints;
+		CHECK(rjutils::ExtractArray(document, "ints", ints));
+		CHECK(ints[0] == 1 && ints[1] == -2 && ints[2] == 3);
+
+		std::array<double, 3> mixed;
+		CHECK(!rjutils::ExtractArray(document, "mixed", mixed));
+
+		std::vector<double> numbers;
+		CHECK(rjutils::ExtractArrayFromNumericOrString(document, "numbers", numbers));
+		CHECK(numbers.size() == 3 && numbers[0] == 1.5 && numbers[1] == 2.0 && numbers[2] == -3.0);
+	}
+
+	TEST(ExtractStructKeepsMismatchedFields)
+	{
+		rapidjson::Document document;
+		document.Parse("{\"x\":\"wrong\",\"y\":2.5}");
+		Vector3 point{ 7.0, 0.0, 9.0 };
+		rjutils::ExtractStruct(document, point);
+		CHECK(point.x == 7.0 && point.y == 2.5 && point.z == 9.0);
+	}
+
+	TEST(EmitFailsOnNaN)
+	{
+		rjutils::Emitter emitter;
+		auto& writer = emitter.Start();
+		writer.StartArray();
+		CHECK(!rjutils::EmitValue(writer, std::numeric_limits<double>::quiet_NaN()));
+	}
+
+	TEST(OutputBufferKeepsItsMemory)
+	{
+		rjutils::OutputBuffer buffer;
+		rapidjson::Writer<rjutils::OutputBuffer> writer(buffer);
+		const std::string text(100000, 'z');
+		writer.StartArray();
+		for (int i = 0; i < 10; ++i)
+			rjutils::EmitValue(writer, text);
+		writer.EndArray();
+		CHECK(buffer.GetSize() == 10 * (text.size() + 2) + 9 + 2);
+
+		const size_t capacity = buffer.GetCapacity();
+		buffer.Clear();
+		CHECK(buffer.GetSize() == 0);
+		CHECK(buffer.GetCapacity() == capacity);
+	}
+
+#ifndef _WIN32
+	TEST(WriteAllDeliversEverything)
+	{
+		int pipeFds[2];
+		CHECK(pipe(pipeFds) == 0);
+
+		rjutils::Emitter emitter;
+		auto& writer = emitter.Start();
+		writer.StartObject();
+		rjutils::Emit(writer, "k", std::string("v"));
+		writer.EndObject();
+
+		const char header[] = "HEADER:";
+		iovec parts[3] = { { const_cast<char*>(header), sizeof(header) - 1 }, emitter.GetOutput().GetIovec(), { nullptr, 0 } };
+		CHECK(rjutils::WriteAll(pipeFds[1], parts, 3));
+		CHECK(emitter.WriteTo(pipeFds[1]));
+
+		char stream[64];
+		rjutils::FdWriteStream fdStream(pipeFds[1], stream, 5);	// Smaller than the document
+		rapidjson::Writer<rjutils::FdWriteStream> fdWriter(fdStream);
+		Vector3 point{ 1, 2, 3 };
+		CHECK(rjutils::EmitStruct(fdWriter, point));
+		CHECK(!fdStream.HasFailed());
+		close(pipeFds[1]);
+
+		std::string received;
+		char chunk[256];
+		ssize_t read = 0;
+		while ((read = ::read(pipeFds[0], chunk, sizeof(chunk))) > 0)
+			received.append(chunk, static_cast<size_t>(read));
+		close(pipeFds[0]);
+
+		const std::string pointJson = "{\"x\":1.0,\"y\":2.0,\"z\":3.0}";
+		CHECK(received == "HEADER:{\"k\":\"v\"}{\"k\":\"v\"}" + pointJson);
+		CHECK(fdStream.GetBytesWritten() == pointJson.size());
+	}
+#endif
+}
+
+int main()
+{
+	return tests::RunTests();
+}
@@ -0,0 +1,225 @@
+//
+// Behavior tests for the SquirrelNoise5 utilities
+//
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+#include "SquirrelNoise5TileCache.hpp"
+#include "SquirrelPermutation.hpp"
+#include "test_utils.hpp"
+
+namespace
+{
+	//-----------------------------------------------------------------------------------------
+	// Permute / Unpermute
+
+	TEST(PermuteIsABijection)
+	{
+		const unsigned int sizes[] = { 1, 2, 3, 4, 5, 7, 8, 9, 31, 32, 33, 100, 1000, 4097, 65535, 65536, 65537, 1000003 };
+		for (const unsigned int size : sizes)
+		{
+			for (const unsigned int seed : { 0u, 1u, 0xDEADBEEFu })
+			{
+				std::vector<char> seen(size, 0);
+				bool bijective = true;
+				bool inverse = true;
+				for (unsigned int i = 0; i < size; ++i)
+				{
+					const unsigned int permuted = Permute(i, size, seed);
+					if (permuted >= size || seen[permuted])
+					{
+						bijective = false;
+						break;
+					}
+					seen[permuted] = 1;
+					inverse &= Unpermute(permuted, size, seed) == i;
+				}
+				CHECK(bijective);
+				CHECK(inverse);
+			}
+		}
+	}
+
+	TEST(PermuteDependsOnTheSeed)
+	{
+		const unsigned int size = 100000;
+		unsigned int same = 0;
+		for (unsigned int i = 0; i < size; ++i)
+			same += Permute(i, size, 1) == Permute(i, size, 2) ? 1 : 0;
+		CHECK(same < size / 100);
+	}
+
+	TEST(PermuteBatchAndRangeMatchScalar)
+	{
+		for (const unsigned int size : { 10u, 1000u, 65537u, 0xFFFFFFFFu })
+		{
+			const size_t count = size < 1000 ? size : 1000;
+			const unsigned int start = size - static_cast<unsigned int>(count);
+			std::vector<unsigned int> indices(count);
+			for (size_t i = 0; i < count; ++i)
+				indices[i] = start + static_cast<unsigned int>(count - 1 - i);
+
+			std::vector<unsigned int> batch(count);
+			std::vector<unsigned int> range(count);
+			PermuteBatch(indices.data(), batch.data(), count, size, 7);
+			PermuteRange(start, count, size, 7, range.data());
+
+			bool matches = true;
+			for (size_t i = 0; i < count; ++i)
+			{
+				matches &= batch[i] == Permute(indices[i], size, 7);
+				matches &= range[i] == Permute(start + static_cast<unsigned int>(i), size, 7);
+			}
+			CHECK(matches);
+		}
+	}
+
+	TEST(PermuteWorksInConstantExpressions)
+	{
+		static_assert(Permute(3, 10, 42) < 10, "Permute must be constexpr");
+		static_assert(Unpermute(Permute(7, 1000, 5), 1000, 5) == 7, "Unpermute must invert Permute");
+	}
+
+	//-----------------------------------------------------------------------------------------
+	// TileCache
+
+	constexpr size_t TILE_ELEMENTS = 64;
+	constexpr size_t TILE_BYTES = TILE_ELEMENTS * sizeof(float);
+
+	noise::TileKey MakeKey(int x, int y = 0, unsigned int seed = 0)
+	{
+		noise::TileKey key;
+		key.seed = seed;
+		key.tileX = x;
+		key.tileY = y;
+		return key;
+	}
+
+	struct CountingGenerator
+	{
+		std::atomic<int>* calls;
+
+		void operator()(const noise::TileKey& key, float* out, size_t count) const
+		{
+			++*calls;
+			for (size_t i = 0; i < count; ++i)
+				out[i] = static_cast<float>(key.tileX * 1000 + key.tileY) + static_cast<float>(i) * 0.5f;
+		}
+	};
+
+	bool HoldsTile(const noise::TileHandle& tile, int x, int y = 0)
+	{
+		return tile && tile.GetSize() == TILE_ELEMENTS
+			&& tile.GetData()[0] == static_cast<float>(x * 1000 + y)
+			&& tile.GetData()[TILE_ELEMENTS - 1] == static_cast<float>(x * 1000 + y) + static_cast<float>(TILE_ELEMENTS - 1) * 0.5f;
+	}
+
+	TEST(TileCacheGeneratesOnceAndHits)
+	{
+		std::atomic<int> calls{ 0 };
+		noise::TileCache cache(TILE_ELEMENTS, 64 * TILE_BYTES, CountingGenerator{ &calls }, 1, 0);
+
+		{
+			noise::TileHandle first = cache.Acquire(MakeKey(1, 2));
+			CHECK(HoldsTile(first, 1, 2));
+		}
+		noise::TileHandle second = cache.Acquire(MakeKey(1, 2));
+		CHECK(HoldsTile(second, 1, 2));
+		CHECK(calls == 1);
+		CHECK(cache.GetStats().hits == 1);
+		CHECK(cache.GetStats().misses == 1);
+		CHECK(!cache.TryAcquire(MakeKey(5, 5)));
+		CHECK(calls == 1);
+	}
+
+	TEST(TileCacheEvictsLeastRecentlyUsed)
+	{
+		std::atomic<int> calls{ 0 };
+		const size_t budgetTiles = noise::TileCache::SLAB_TILES;
+		noise::TileCache cache(TILE_ELEMENTS, budgetTiles * TILE_BYTES, CountingGenerator{ &calls }, 1, 0);
+
+		for (int x = 0; x < static_cast<int>(budgetTiles); ++x)
+			cache.Acquire(MakeKey(x));
+		cache.Acquire(MakeKey(0)); // Tile 0 is now the most recent, tile 1 the least
+
+		cache.Acquire(MakeKey(100));
+		CHECK(cache.GetStats().evictions == 1);
+		CHECK(cache.GetStats().tileCount == budgetTiles);
+		CHECK(!cache.TryAcquire(MakeKey(1)));
+		CHECK(HoldsTile(cache.TryAcquire(MakeKey(0)), 0));
+		CHECK(HoldsTile(cache.TryAcquire(MakeKey(100)), 100));
+	}
+
+	TEST(TileCacheNeverEvictsPinnedTiles)
+	{
+		std::atomic<int> calls{ 0 };
+		const size_t budgetTiles = noise::TileCache::SLAB_TILES;
+		noise::TileCache cache(TILE_ELEMENTS, budgetTiles * TILE_BYTES, CountingGenerator{ &calls }, 1, 0);
+
+		noise::TileHandle pinned = cache.Acquire(MakeKey(0));
+		for (int x = 1; x < static_cast<int>(4 * budgetTiles); ++x)
+			cache.Acquire(MakeKey(x));
+
+		CHECK(HoldsTile(pinned, 0));
+		CHECK(HoldsTile(cache.TryAcquire(MakeKey(0)), 0));
+		CHECK(cache.GetStats().tileCount <= budgetTiles);
+	}
+
+	TEST(TileCacheInvalidateRegion)
+	{
+		std::atomic<int> calls{ 0 };
+		noise::TileCache cache(TILE_ELEMENTS, 64 * TILE_BYTES, CountingGenerator{ &calls }, 2, 0);
+
+		for (int y = 0; y < 4; ++y)
+			for (int x = 0; x < 4; ++x)
+				cache.Acquire(MakeKey(x, y));
+		cache.Acquire(MakeKey(1, 1, 9)); // Same coordinates, another seed
+
+		noise::TileHandle held = cache.Acquire(MakeKey(1, 1));
+		cache.InvalidateRegion(0, 0, 0, 1, 1, 0, 2, 2, 0);
+
+		// Invalidated tiles keep their data while they are held...
+		CHECK(HoldsTile(held, 1, 1));
+		for (int y = 0; y < 4; ++y)
+			for (int x = 0; x < 4; ++x)
+			{
+				const bool inside = x >= 1 && x <= 2 && y >= 1 && y <= 2;
+				CHECK(static_cast<bool>(cache.TryAcquire(MakeKey(x, y))) == !inside);
+			}
+		CHECK(cache.TryAcquire(MakeKey(1, 1, 9)));
+
+		// ... and are generated again on the next Acquire()
+		const int callsBefore = calls;
+		CHECK(HoldsTile(cache.Acquire(MakeKey(2, 2)), 2, 2));
+		CHECK(calls == callsBefore + 1);
+
+		held.Reset();
+		cache.Clear();
+		CHECK(cache.GetStats().tileCount == 0);
+	}
+
+	TEST(TileCachePrefetch)
+	{
+		std::atomic<int> calls{ 0 };
+		noise::TileCache cache(TILE_ELEMENTS, 64 * TILE_BYTES, CountingGenerator{ &calls }, 0, 2);
+
+		std::vector<noise::TileKey> keys;
+		for (int x = 0; x < 20; ++x)
+			keys.push_back(MakeKey(x, 7));
+		cache.Prefetch(keys.data(), keys.size());
+		cache.WaitForPrefetches();
+
+		bool allReady = true;
+		for (const noise::TileKey& key : keys)
+			allReady &= HoldsTile(cache.TryAcquire(key), key.tileX, 7);
+		CHECK(allReady);
+		CHECK(calls == 20);
+		CHECK(cache.GetStats().prefetches == 20);
+	}
+}
+
+int main()
+{
+	return tests::RunTests();
+}
@@ -0,0 +1,70 @@
+//
+// Minimal test registry for the `tests` executables: every TEST() registers itself, CHECK()
+// reports a failure and keeps going, and RunTests() runs them all and returns the exit code
+// ctest looks at.
+//
+
+#pragma once
+
+#include <cstdio>
+#include <vector>
+
+namespace tests
+{
+	typedef void (*TestFunction)();
+
+	struct TestCase
+	{
+		const char* name;
+		TestFunction function;
+	};
+
+	inline std::vector<TestCase>& Registry()
+	{
+		static std::vector<TestCase> registry;
+		return registry;
+	}
+
+	inline int& FailureCount()
+	{
+		static int failures = 0;
+		return failures;
+	}
+
+	inline bool Register(const char* name, TestFunction function)
+	{
+		Registry().push_back({ name, function });
+		return true;
+	}
+
+	inline int RunTests()
+	{
+		int failedTests = 0;
+		for (const TestCase& test : Registry())
+		{
+			const int failuresBefore = FailureCount();
+			test.function();
+			const bool passed = FailureCount() == failuresBefore;
+			failedTests += passed ? 0 : 1;
+			std::printf("%s %s\n", passed ? "[ OK ]" : "[FAIL]", test.name);
+			std::fflush(stdout);	// Keep the log of the tests that ran if a later one crashes
+		}
+		std::printf("%zu tests, %d failed\n", Registry().size(), failedTests);
+		return failedTests == 0 ? 0 : 1;
+	}
+}
+
+#define TEST(name) \
+	static void name(); \
+	static const bool name##_registered = ::tests::Register(#name, &name); \
+	static void name()
+
+#define CHECK(condition) \
+	do \
+	{ \
+		if (!(condition)) \
+		{ \
+			std::printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+			++::tests::FailureCount(); \
+		} \
+	} while (false)
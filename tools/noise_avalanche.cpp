@@ -0,0 +1,227 @@
+//
+// Noise Avalanche
+//
+// Measures the bit-influence (avalanche) matrix of the SquirrelNoise5 functions: for every input
+// bit (index/coordinate bits and seed bits) and every output bit, the probability that flipping
+// the input bit flips the output bit. Ideal is 50% everywhere; sampling noise with N samples is
+// about 50% / sqrt(N).
+//
+//     noise_avalanche                            every variant, 1M samples, all cores
+//     noise_avalanche 3d --samples 16M           a single variant
+//     noise_avalanche 1d --matrix > 1d.csv       also dump the full matrix as CSV
+//     noise_avalanche all --max-bias 0.5         exit code 3 if any cell is off by > 0.5%
+//
+// Samples are split across threads, each accumulating its own counts, and merged at the end.
+//
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include "SquirrelNoise5.hpp"
+#include "SquirrelNoise5_64.hpp"
+
+namespace
+{
+	constexpr size_t MAX_FIELDS = 10;
+
+	// Inputs are passed as 32-bit fields (64-bit indices and seeds take two fields each)
+	typedef uint64_t (*Function)(const uint32_t* fields);
+
+	struct Variant
+	{
+		const char* name;
+		size_t field_count;
+		size_t output_bits;
+		Function evaluate;
+	};
+
+	int I(uint32_t field) { return static_cast<int>(field); }
+	int64_t I64(const uint32_t* fields) { return static_cast<int64_t>(static_cast<uint64_t>(fields[0]) | (static_cast<uint64_t>(fields[1]) << 32)); }
+	uint64_t U64(const uint32_t* fields) { return static_cast<uint64_t>(fields[0]) | (static_cast<uint64_t>(fields[1]) << 32); }
+
+	constexpr Variant VARIANTS[] =
+	{
+		{ "1d", 2, 32, [](const uint32_t* f) -> uint64_t { return Get1dNoiseUint(I(f[0]), f[1]); } },
+		{ "2d", 3, 32, [](const uint32_t* f) -> uint64_t { return Get2dNoiseUint(I(f[0]), I(f[1]), f[2]); } },
+		{ "3d", 4, 32, [](const uint32_t* f) -> uint64_t { return Get3dNoiseUint(I(f[0]), I(f[1]), I(f[2]), f[3]); } },
+		{ "4d", 5, 32, [](const uint32_t* f) -> uint64_t { return Get4dNoiseUint(I(f[0]), I(f[1]), I(f[2]), I(f[3]), f[4]); } },
+		{ "1d-fast24", 2, 24, [](const uint32_t* f) -> uint64_t { return static_cast<uint64_t>(Get1dNoiseZeroToOneFast(I(f[0]), f[1]) * 16777216.f); } },
+		{ "1d-64", 4, 64, [](const uint32_t* f) -> uint64_t { return Get1dNoiseUint64(I64(f), U64(f + 2)); } },
+		{ "2d-64", 6, 64, [](const uint32_t* f) -> uint64_t { return Get2dNoiseUint64(I64(f), I64(f + 2), U64(f + 4)); } },
+		{ "3d-64", 8, 64, [](const uint32_t* f) -> uint64_t { return Get3dNoiseUint64(I64(f), I64(f + 2), I64(f + 4), U64(f + 6)); } },
+		{ "4d-64", 10, 64, [](const uint32_t* f) -> uint64_t { return Get4dNoiseUint64(I64(f), I64(f + 2), I64(f + 4), I64(f + 6), U64(f + 8)); } },
+	};
+
+	// counts[input_bit * output_bits + output_bit] = number of samples where the output bit flipped
+	void Accumulate(const Variant& variant, uint64_t first_sample, uint64_t sample_count, uint64_t* counts)
+	{
+		const size_t input_bits = variant.field_count * 32;
+		uint32_t fields[MAX_FIELDS] = {};
+		for (uint64_t sample = first_sample; sample < first_sample + sample_count; ++sample)
+		{
+			// Random inputs drawn from the 64-bit hash, so they don't share structure with the function under test
+			for (size_t f = 0; f < variant.field_count; ++f)
+				fields[f] = static_cast<uint32_t>(Get1dNoiseUint64(static_cast<int64_t>(sample * MAX_FIELDS + f), 0xA5A5A5A5DEADBEEFull) >> 16);
+
+			const uint64_t base = variant.evaluate(fields);
+			for (size_t bit = 0; bit < input_bits; ++bit)
+			{
+				fields[bit / 32] ^= (1u << (bit % 32));
+				const uint64_t diff = base ^ variant.evaluate(fields);
+				fields[bit / 32] ^= (1u << (bit % 32));
+
+				uint64_t* row = counts + bit * variant.output_bits;
+				for (size_t output_bit = 0; output_bit < variant.output_bits; ++output_bit)
+					row[output_bit] += (diff >> output_bit) & 1;
+			}
+		}
+	}
+
+	struct Summary
+	{
+		double min_probability = 1.0;
+		double max_probability = 0.0;
+		double mean_abs_bias = 0.0;
+		size_t worst_input_bit = 0;
+		size_t worst_output_bit = 0;
+	};
+
+	Summary Summarize(const Variant& variant, const std::vector<uint64_t>& counts, uint64_t samples)
+	{
+		Summary summary;
+		double worst_bias = -1.0;
+		const size_t input_bits = variant.field_count * 32;
+		for (size_t in = 0; in < input_bits; ++in)
+			for (size_t out = 0; out < variant.output_bits; ++out)
+			{
+				const double p = static_cast<double>(counts[in * variant.output_bits + out]) / static_cast<double>(samples);
+				summary.min_probability = std::min(summary.min_probability, p);
+				summary.max_probability = std::max(summary.max_probability, p);
+				summary.mean_abs_bias += std::fabs(p - 0.5);
+				if (std::fabs(p - 0.5) > worst_bias)
+				{
+					worst_bias = std::fabs(p - 0.5);
+					summary.worst_input_bit = in;
+					summary.worst_output_bit = out;
+				}
+			}
+		summary.mean_abs_bias /= static_cast<double>(input_bits * variant.output_bits);
+		return summary;
+	}
+
+	void PrintUsage()
+	{
+		fprintf(stderr, "usage: noise_avalanche [variant|all] [--samples N[K|M]] [--threads N] [--matrix] [--max-bias PERCENT]\n\nvariants:");
+		for (const Variant& variant : VARIANTS)
+			fprintf(stderr, " %s", variant.name);
+		fprintf(stderr, "\n");
+	}
+
+	bool ParseCount(const char* text, uint64_t& out_value)
+	{
+		char* end = nullptr;
+		out_value = strtoull(text, &end, 0);
+		if (end == text)
+			return false;
+		if (*end == 'M' || *end == 'm')
+		{
+			out_value <<= 20;
+			++end;
+		}
+		else if (*end == 'K' || *end == 'k')
+		{
+			out_value <<= 10;
+			++end;
+		}
+		return *end == '\0';
+	}
+}
+
+int main(int argc, char** argv)
+{
+	const char* selected = "all";
+	uint64_t samples = 1u << 20;
+	uint64_t thread_count = std::thread::hardware_concurrency();
+	bool print_matrix = false;
+	double max_bias_percent = -1.0;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		if (strcmp(argv[i], "--samples") == 0 && i + 1 < argc && ParseCount(argv[i + 1], samples) && samples > 0)
+			++i;
+		else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc && ParseCount(argv[i + 1], thread_count))
+			++i;
+		else if (strcmp(argv[i], "--max-bias") == 0 && i + 1 < argc)
+			max_bias_percent = atof(argv[++i]);
+		else if (strcmp(argv[i], "--matrix") == 0)
+			print_matrix = true;
+		else if (argv[i][0] != '-')
+			selected = argv[i];
+		else
+		{
+			PrintUsage();
+			return 1;
+		}
+	}
+	thread_count = std::max<uint64_t>(1, std::min<uint64_t>(thread_count, samples));
+
+	bool any_variant = false;
+	bool within_bounds = true;
+	fprintf(stderr, "%llu samples per variant on %llu threads, sampling noise ~%.4f%%\n",
+		static_cast<unsigned long long>(samples), static_cast<unsigned long long>(thread_count), 50.0 / std::sqrt(static_cast<double>(samples)));
+
+	for (const Variant& variant : VARIANTS)
+	{
+		if (strcmp(selected, "all") != 0 && strcmp(selected, variant.name) != 0)
+			continue;
+		any_variant = true;
+
+		const size_t cells = variant.field_count * 32 * variant.output_bits;
+		std::vector<std::vector<uint64_t>> partial(thread_count, std::vector<uint64_t>(cells));
+		std::vector<std::thread> threads;
+		for (uint64_t t = 0; t < thread_count; ++t)
+		{
+			const uint64_t first = samples * t / thread_count;
+			const uint64_t last = samples * (t + 1) / thread_count;
+			threads.emplace_back(Accumulate, std::cref(variant), first, last - first, partial[t].data());
+		}
+		for (std::thread& thread : threads)
+			thread.join();
+
+		std::vector<uint64_t> counts(cells);
+		for (const auto& part : partial)
+			for (size_t c = 0; c < cells; ++c)
+				counts[c] += part[c];
+
+		const Summary summary = Summarize(variant, counts, samples);
+		printf("%-10s bit-influence min %.4f%%  max %.4f%%  mean |bias| %.4f%%  (worst: input bit %zu -> output bit %zu)\n",
+			variant.name, summary.min_probability * 100.0, summary.max_probability * 100.0, summary.mean_abs_bias * 100.0,
+			summary.worst_input_bit, summary.worst_output_bit);
+
+		if (print_matrix)
+		{
+			for (size_t in = 0; in < variant.field_count * 32; ++in)
+			{
+				for (size_t out = 0; out < variant.output_bits; ++out)
+					printf("%s%.5f", out ? "," : "", static_cast<double>(counts[in * variant.output_bits + out]) / static_cast<double>(samples));
+				printf("\n");
+			}
+		}
+
+		if (max_bias_percent >= 0.0
+			&& (50.0 - summary.min_probability * 100.0 > max_bias_percent || summary.max_probability * 100.0 - 50.0 > max_bias_percent))
+			within_bounds = false;
+	}
+
+	if (!any_variant)
+	{
+		PrintUsage();
+		return 1;
+	}
+	return within_bounds ? 0 : 3;
+}
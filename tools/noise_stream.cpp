@@ -0,0 +1,318 @@
+//
+// Noise Stream
+//
+// Streams raw SquirrelNoise5 output to stdout as fast as possible, for piping into statistical
+// test suites:
+//
+//     noise_stream 1d | RNG_test stdin32
+//     noise_stream 3d --seed 42 --bytes 64G | RNG_test stdin32 -tlmax 64GB
+//     noise_stream 1d-64 | RNG_test stdin64
+//     noise_stream 1d-fast24 | RNG_test stdin8
+//
+// Output goes through the batch / grid kernels in large chunks. The next chunk is generated on
+// a second thread while the current one is being written, so the pipe is the only bottleneck.
+// Use --verify to compare every chunk against the scalar functions (slower, but proves the SIMD
+// kernels are bit-exact on this machine while the statistics are being gathered).
+//
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <future>
+#include <string>
+#include <vector>
+#ifdef _WIN32
+	#include <fcntl.h>
+	#include <io.h>
+#else
+	#include <csignal>
+#endif
+#include "SquirrelNoise5.hpp"
+#include "SquirrelNoise5Batch.hpp"
+#include "SquirrelNoise5Parallel.hpp"
+#include "SquirrelNoise5_64.hpp"
+
+namespace
+{
+	constexpr size_t CHUNK_WORDS = size_t(1) << 20;	// 4 MiB of 32-bit output per write
+
+	struct StreamState
+	{
+		unsigned int seed = 0;
+		uint64_t chunk_index = 0;
+	};
+
+	// Each generator fills `out` with exactly CHUNK_WORDS 32-bit words (CHUNK_WORDS / 2 64-bit
+	// words for the 64-bit variants) for chunk number `chunk_index`, and returns the number of
+	// bytes to write. Consecutive chunks walk the index space without overlapping.
+	typedef size_t (*Generator)(const StreamState& state, std::vector<uint32_t>& out, bool verify);
+
+	[[noreturn]] void VerifyFailed(const char* variant, size_t index)
+	{
+		fprintf(stderr, "noise_stream: %s batch output differs from the scalar function at word %zu\n", variant, index);
+		exit(2);
+	}
+
+	//-----------------------------------------------------------------------------------------
+	size_t Generate1d(const StreamState& state, std::vector<uint32_t>& out, bool verify)
+	{
+		const int start = static_cast<int>(static_cast<uint32_t>(state.chunk_index * CHUNK_WORDS));
+		Get1dNoiseUintRange(start, CHUNK_WORDS, state.seed, out.data());
+		if (verify)
+			for (size_t i = 0; i < CHUNK_WORDS; ++i)
+				if (out[i] != Get1dNoiseUint(static_cast<int>(static_cast<uint32_t>(start) + static_cast<uint32_t>(i)), state.seed))
+					VerifyFailed("1d", i);
+		return CHUNK_WORDS * sizeof(uint32_t);
+	}
+
+	//-----------------------------------------------------------------------------------------
+	size_t Generate1dScalar(const StreamState& state, std::vector<uint32_t>& out, bool)
+	{
+		const uint32_t start = static_cast<uint32_t>(state.chunk_index * CHUNK_WORDS);
+		for (size_t i = 0; i < CHUNK_WORDS; ++i)
+			out[i] = Get1dNoiseUint(static_cast<int>(start + static_cast<uint32_t>(i)), state.seed);
+		return CHUNK_WORDS * sizeof(uint32_t);
+	}
+
+	//-----------------------------------------------------------------------------------------
+	// 4096-wide rows, one chunk = 256 rows, walking down y
+	//
+	constexpr size_t ROW_2D = 4096;
+
+	size_t Generate2d(const StreamState& state, std::vector<uint32_t>& out, bool verify)
+	{
+		const size_t rows = CHUNK_WORDS / ROW_2D;
+		const int y0 = static_cast<int>(static_cast<uint32_t>(state.chunk_index * rows));
+		Fill2dNoiseUint(0, y0, ROW_2D, rows, ROW_2D, state.seed, out.data());
+		if (verify)
+			for (size_t y = 0; y < rows; ++y)
+				for (size_t x = 0; x < ROW_2D; ++x)
+					if (out[y * ROW_2D + x] != Get2dNoiseUint(static_cast<int>(x), static_cast<int>(static_cast<uint32_t>(y0) + static_cast<uint32_t>(y)), state.seed))
+						VerifyFailed("2d", y * ROW_2D + x);
+		return CHUNK_WORDS * sizeof(uint32_t);
+	}
+
+	//-----------------------------------------------------------------------------------------
+	// 256x256 slices, one chunk = 16 slices, walking along z
+	//
+	constexpr size_t SIDE_3D = 256;
+
+	size_t Generate3d(const StreamState& state, std::vector<uint32_t>& out, bool verify)
+	{
+		const size_t slices = CHUNK_WORDS / (SIDE_3D * SIDE_3D);
+		const int z0 = static_cast<int>(static_cast<uint32_t>(state.chunk_index * slices));
+		Fill3dNoiseUint(0, 0, z0, SIDE_3D, SIDE_3D, slices, SIDE_3D, SIDE_3D * SIDE_3D, state.seed, out.data());
+		if (verify)
+			for (size_t z = 0; z < slices; ++z)
+				for (size_t y = 0; y < SIDE_3D; ++y)
+					for (size_t x = 0; x < SIDE_3D; ++x)
+						if (out[(z * SIDE_3D + y) * SIDE_3D + x] != Get3dNoiseUint(static_cast<int>(x), static_cast<int>(y), static_cast<int>(static_cast<uint32_t>(z0) + static_cast<uint32_t>(z)), state.seed))
+							VerifyFailed("3d", (z * SIDE_3D + y) * SIDE_3D + x);
+		return CHUNK_WORDS * sizeof(uint32_t);
+	}
+
+	//-----------------------------------------------------------------------------------------
+	// 64x64x16 volumes, one chunk = 16 volumes, walking along t
+	//
+	constexpr size_t SIDE_4D = 64, DEPTH_4D = 16;
+
+	size_t Generate4d(const StreamState& state, std::vector<uint32_t>& out, bool verify)
+	{
+		static noise::ParallelFill filler(1);
+		const size_t volume = SIDE_4D * SIDE_4D * DEPTH_4D;
+		const size_t duration = CHUNK_WORDS / volume;
+		const int t0 = static_cast<int>(static_cast<uint32_t>(state.chunk_index * duration));
+		filler.Fill4dNoiseUint(0, 0, 0, t0, SIDE_4D, SIDE_4D, DEPTH_4D, duration, SIDE_4D, SIDE_4D * SIDE_4D, volume, state.seed, out.data());
+		if (verify)
+			for (size_t i = 0; i < CHUNK_WORDS; ++i)
+			{
+				const int x = static_cast<int>(i % SIDE_4D);
+				const int y = static_cast<int>((i / SIDE_4D) % SIDE_4D);
+				const int z = static_cast<int>((i / (SIDE_4D * SIDE_4D)) % DEPTH_4D);
+				const int t = static_cast<int>(static_cast<uint32_t>(t0) + static_cast<uint32_t>(i / volume));
+				if (out[i] != Get4dNoiseUint(x, y, z, t, state.seed))
+					VerifyFailed("4d", i);
+			}
+		return CHUNK_WORDS * sizeof(uint32_t);
+	}
+
+	//-----------------------------------------------------------------------------------------
+	size_t Generate1d64(const StreamState& state, std::vector<uint32_t>& out, bool)
+	{
+		const size_t count = CHUNK_WORDS / 2;
+		const int64_t start = static_cast<int64_t>(state.chunk_index * count);
+		for (size_t i = 0; i < count; ++i)
+		{
+			const uint64_t value = Get1dNoiseUint64(start + static_cast<int64_t>(i), state.seed);
+			memcpy(&out[2 * i], &value, sizeof(value));
+		}
+		return CHUNK_WORDS * sizeof(uint32_t);
+	}
+
+	//-----------------------------------------------------------------------------------------
+	size_t Generate2d64(const StreamState& state, std::vector<uint32_t>& out, bool)
+	{
+		const size_t count = CHUNK_WORDS / 2;
+		const size_t rows = count / ROW_2D;
+		const int64_t y0 = static_cast<int64_t>(state.chunk_index * rows);
+		for (size_t y = 0; y < rows; ++y)
+			for (size_t x = 0; x < ROW_2D; ++x)
+			{
+				const uint64_t value = Get2dNoiseUint64(static_cast<int64_t>(x), y0 + static_cast<int64_t>(y), state.seed);
+				memcpy(&out[2 * (y * ROW_2D + x)], &value, sizeof(value));
+			}
+		return CHUNK_WORDS * sizeof(uint32_t);
+	}
+
+	//-----------------------------------------------------------------------------------------
+	// The 24 bits the float-only [0,1) mapping keeps, packed as 3 little-endian bytes per sample,
+	// so the test suite sees exactly the entropy a float consumer gets.
+	//
+	size_t Generate1dFast24(const StreamState& state, std::vector<uint32_t>& out, bool verify)
+	{
+		// 4 samples pack into 3 words, so generate 4/3 of a chunk's worth of samples
+		const size_t count = CHUNK_WORDS / 3 * 4;
+		const int start = static_cast<int>(static_cast<uint32_t>(state.chunk_index * count));
+		static std::vector<float> samples;	// Only one chunk is ever generated at a time
+		samples.resize(count);
+		Get1dNoiseZeroToOneFastRange(start, count, state.seed, samples.data());
+
+		unsigned char* bytes = reinterpret_cast<unsigned char*>(out.data());
+		for (size_t i = 0; i < count; ++i)
+		{
+			if (verify && samples[i] != Get1dNoiseZeroToOneFast(static_cast<int>(static_cast<uint32_t>(start) + static_cast<uint32_t>(i)), state.seed))
+				VerifyFailed("1d-fast24", i);
+
+			const uint32_t bits = static_cast<uint32_t>(samples[i] * 16777216.f);
+			bytes[3 * i + 0] = static_cast<unsigned char>(bits);
+			bytes[3 * i + 1] = static_cast<unsigned char>(bits >> 8);
+			bytes[3 * i + 2] = static_cast<unsigned char>(bits >> 16);
+		}
+		return count * 3;
+	}
+
+	struct Variant
+	{
+		const char* name;
+		Generator generate;
+		const char* description;
+	};
+
+	constexpr Variant VARIANTS[] =
+	{
+		{ "1d",			Generate1d,			"Get1dNoiseUint over consecutive indices (SIMD range kernel)" },
+		{ "1d-scalar",	Generate1dScalar,	"Get1dNoiseUint over consecutive indices (scalar function)" },
+		{ "2d",			Generate2d,			"Get2dNoiseUint over 4096-wide rows (Fill2dNoiseUint)" },
+		{ "3d",			Generate3d,			"Get3dNoiseUint over 256x256 slices (Fill3dNoiseUint)" },
+		{ "4d",			Generate4d,			"Get4dNoiseUint over 64x64x16 volumes (ParallelFill)" },
+		{ "1d-64",		Generate1d64,		"Get1dNoiseUint64 over consecutive indices (64-bit words)" },
+		{ "2d-64",		Generate2d64,		"Get2dNoiseUint64 over 4096-wide rows (64-bit words)" },
+		{ "1d-fast24",	Generate1dFast24,	"Bits kept by Get1dNoiseZeroToOneFast (3 bytes per sample)" },
+	};
+
+	void PrintUsage()
+	{
+		fprintf(stderr, "usage: noise_stream <variant> [--seed N] [--bytes N[K|M|G|T]] [--verify]\n\nvariants:\n");
+		for (const Variant& variant : VARIANTS)
+			fprintf(stderr, "  %-10s %s\n", variant.name, variant.description);
+		fprintf(stderr, "\n--bytes defaults to unlimited (until the reader closes the pipe).\n");
+	}
+
+	bool ParseSize(const char* text, uint64_t& out_value)
+	{
+		char* end = nullptr;
+		out_value = strtoull(text, &end, 0);
+		if (end == text)
+			return false;
+
+		switch (*end)
+		{
+			case 'T': case 't': out_value <<= 10; [[fallthrough]];
+			case 'G': case 'g': out_value <<= 10; [[fallthrough]];
+			case 'M': case 'm': out_value <<= 10; [[fallthrough]];
+			case 'K': case 'k': out_value <<= 10; ++end; break;
+			default: break;
+		}
+		return *end == '\0';
+	}
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 2)
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	const Variant* variant = nullptr;
+	for (const Variant& candidate : VARIANTS)
+		if (strcmp(argv[1], candidate.name) == 0)
+			variant = &candidate;
+
+	if (!variant)
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	StreamState state;
+	uint64_t byte_limit = 0;
+	bool verify = false;
+	for (int i = 2; i < argc; ++i)
+	{
+		uint64_t value = 0;
+		if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc && ParseSize(argv[i + 1], value))
+		{
+			state.seed = static_cast<unsigned int>(value);
+			++i;
+		}
+		else if (strcmp(argv[i], "--bytes") == 0 && i + 1 < argc && ParseSize(argv[i + 1], value))
+		{
+			byte_limit = value;
+			++i;
+		}
+		else if (strcmp(argv[i], "--verify") == 0)
+			verify = true;
+		else
+		{
+			PrintUsage();
+			return 1;
+		}
+	}
+
+#ifdef _WIN32
+	_setmode(_fileno(stdout), _O_BINARY);
+#else
+	// Test suites close the pipe once they are done; treat that as a normal exit
+	signal(SIGPIPE, SIG_IGN);
+#endif
+	setvbuf(stdout, nullptr, _IONBF, 0);
+
+	std::vector<uint32_t> buffers[2] = { std::vector<uint32_t>(CHUNK_WORDS), std::vector<uint32_t>(CHUNK_WORDS) };
+	size_t current_bytes = variant->generate(state, buffers[0], verify);
+	uint64_t written = 0;
+	for (size_t current = 0; byte_limit == 0 || written < byte_limit; current ^= 1)
+	{
+		// Generate the next chunk while this one is being written
+		StreamState next_state = state;
+		++next_state.chunk_index;
+		std::future<size_t> next = std::async(std::launch::async, variant->generate, next_state, std::ref(buffers[current ^ 1]), verify);
+
+		size_t bytes = current_bytes;
+		if (byte_limit != 0 && byte_limit - written < bytes)
+			bytes = static_cast<size_t>(byte_limit - written);
+
+		if (fwrite(buffers[current].data(), 1, bytes, stdout) != bytes)
+		{
+			next.wait();
+			return 0;
+		}
+
+		written += bytes;
+		state = next_state;
+		current_bytes = next.get();
+	}
+	return 0;
+}